@@ -0,0 +1,188 @@
+/*
+ * lwspp - C++ wrapper for the libwebsockets library
+ *
+ * Copyright (C) 2023 - 2023 Volodymyr Lotoshko <vlotoshko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "LwsAdapter/ILwsConnection.hpp"
+#include "LwsAdapter/LwsConnections.hpp"
+
+/**
+ * Lookup benchmark of the connections registry: several sender threads resolve the connection
+ * ids, as the targeted sends do. Compares LwsConnections with the mutex protected std::map,
+ * which was used by the LwsConnections before.
+ */
+
+namespace
+{
+
+using namespace lwspp::srv;
+
+const int CONNECTIONS = 10 * 1000;
+const unsigned int LOOKUPS = 4 * 1000 * 1000;
+const unsigned int MAX_SENDERS = 16;
+
+class FakeConnection : public ILwsConnection
+{
+public:
+    explicit FakeConnection(ConnectionId connectionId) : _connectionId(connectionId)
+    {}
+
+    auto getConnectionId() const -> ConnectionId override { return _connectionId; }
+    auto getLwsInstance() -> LwsInstanceRawPtr override { return nullptr; }
+    auto getServiceThreadIndex() const -> int override { return 0; }
+
+    auto wakeUpServiceThread() -> bool override { return true; }
+    void detachLwsInstance() override {}
+
+    auto addDataToSend(Message) -> EnqueueResult override
+    {
+        return EnqueueResult{SendResult::Queued, false};
+    }
+    auto frontPendingData() -> Message* override { return nullptr; }
+    auto hasPendingData() -> bool override { return false; }
+    auto popPendingData(size_t) -> bool override { return false; }
+    auto trimPendingData() -> bool override { return false; }
+    auto takeHighWatermark() -> bool override { return false; }
+    auto getReceiveBuffer() -> std::vector<char>& override { return _receiveBuffer; }
+    auto getWriteBuffer() -> std::vector<unsigned char>& override { return _writeBuffer; }
+
+    void keepWrittenMessage(Message) override {}
+    void releaseWrittenMessage() override {}
+
+    void addCompressionStats(size_t, size_t, std::chrono::nanoseconds) override {}
+    auto getCompressionStats() const -> CompressionStats override { return CompressionStats{}; }
+    void setDeflatePending(bool) override {}
+    auto isDeflatePending() const -> bool override { return false; }
+
+    auto markedToClose() -> bool override { return false; }
+    void markToClose(CloseReason) override {}
+    auto getCloseReason() const -> CloseReason override { return CloseReason::None; }
+
+    auto markPendingWrite() -> bool override { return false; }
+    auto clearPendingWrite() -> bool override { return false; }
+
+    auto pauseReceiving(ReceivingPauseReason) -> bool override { return false; }
+    auto resumeReceiving(ReceivingPauseReason) -> bool override { return false; }
+    auto isReceivingPaused() const -> bool override { return false; }
+    auto takeReceivingChange() -> bool override { return false; }
+
+private:
+    ConnectionId _connectionId;
+    std::vector<char> _receiveBuffer;
+    std::vector<unsigned char> _writeBuffer;
+};
+
+class MapConnections
+{
+public:
+    void add(ILwsConnectionPtr connection)
+    {
+        const std::lock_guard<std::mutex> guard(_mutex);
+        _connections.insert({connection->getConnectionId(), connection});
+    }
+
+    auto get(ConnectionId connectionId) -> ILwsConnectionPtr
+    {
+        const std::lock_guard<std::mutex> guard(_mutex);
+        auto it = _connections.find(connectionId);
+        return it != _connections.end() ? it->second : ILwsConnectionPtr{};
+    }
+
+private:
+    std::map<ConnectionId, ILwsConnectionPtr> _connections;
+    std::mutex _mutex;
+};
+
+template <typename Connections>
+auto runBenchmark(Connections& connections, unsigned int senders) -> double
+{
+    const unsigned int lookupsPerSender = LOOKUPS / senders;
+    const auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < senders; ++i)
+    {
+        threads.emplace_back([&connections, lookupsPerSender, i]()
+        {
+            unsigned int found = 0;
+            for (unsigned int n = 0; n < lookupsPerSender; ++n)
+            {
+                const auto connectionId = static_cast<ConnectionId>((n * 7919 + i) % CONNECTIONS);
+                found += connections.get(connectionId) != nullptr ? 1 : 0;
+            }
+            if (found != lookupsPerSender)
+            {
+                std::cerr << "Unexpected lookup result\n";
+            }
+        });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return lookupsPerSender * senders / elapsed.count() / 1e6;
+}
+
+} // namespace
+
+auto main() -> int
+{
+    MapConnections mapConnections;
+    LwsConnections lwsConnections;
+    for (ConnectionId connectionId = 0; connectionId < CONNECTIONS; ++connectionId)
+    {
+        auto connection = std::make_shared<FakeConnection>(connectionId);
+        mapConnections.add(connection);
+        lwsConnections.add(connection);
+    }
+
+    std::cout << "Connections: " << CONNECTIONS << ", lookups: " << LOOKUPS
+              << ", throughput in millions of lookups/s\n"
+              << std::setw(10) << "senders"
+              << std::setw(14) << "mutex map"
+              << std::setw(14) << "slot table" << '\n';
+
+    for (unsigned int senders = 1; senders <= MAX_SENDERS; senders *= 2)
+    {
+        const double mapLookups = runBenchmark(mapConnections, senders);
+        const double slotLookups = runBenchmark(lwsConnections, senders);
+
+        std::cout << std::fixed << std::setprecision(2)
+                  << std::setw(10) << senders
+                  << std::setw(14) << mapLookups
+                  << std::setw(14) << slotLookups << '\n';
+    }
+
+    return 0;
+}
@@ -0,0 +1,150 @@
+/*
+ * lwspp - C++ wrapper for the libwebsockets library
+ *
+ * Copyright (C) 2023 - 2023 Volodymyr Lotoshko <vlotoshko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "MpscQueue.hpp"
+
+/**
+ * Contention benchmark of the outbound connection queue: several producer threads push
+ * messages into one connection queue while the single service thread drains it.
+ * Compares the lock-free MpscQueue with the mutex protected std::queue with the swap on
+ * the consumer side, which was used by the LwsConnection before.
+ */
+
+namespace
+{
+
+const unsigned int TOTAL_MESSAGES = 4 * 1000 * 1000;
+const unsigned int MAX_PRODUCERS = 16;
+
+// Mimics the message queued by the server: the data type and the shared payload
+struct Message
+{
+    uint8_t dataType;
+    std::shared_ptr<std::string> payload;
+};
+
+class MutexQueue
+{
+public:
+    void push(Message message)
+    {
+        const std::lock_guard<std::mutex> guard(_mutex);
+        _pending.push(std::move(message));
+    }
+
+    auto front() -> Message*
+    {
+        if (_toSend.empty())
+        {
+            const std::lock_guard<std::mutex> guard(_mutex);
+            _toSend.swap(_pending);
+        }
+        return _toSend.empty() ? nullptr : &_toSend.front();
+    }
+
+    void pop()
+    {
+        _toSend.pop();
+    }
+
+private:
+    std::queue<Message> _pending;
+    std::queue<Message> _toSend;
+    std::mutex _mutex;
+};
+
+template <typename Queue>
+auto runBenchmark(unsigned int producers) -> double
+{
+    Queue queue;
+    const auto payload = std::make_shared<std::string>(64, 'x');
+    const unsigned int messagesPerProducer = TOTAL_MESSAGES / producers;
+    const unsigned int totalMessages = messagesPerProducer * producers;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < producers; ++i)
+    {
+        threads.emplace_back([&queue, &payload, messagesPerProducer]()
+        {
+            for (unsigned int n = 0; n < messagesPerProducer; ++n)
+            {
+                queue.push(Message{0, payload});
+            }
+        });
+    }
+
+    unsigned int consumed = 0;
+    while (consumed < totalMessages)
+    {
+        if (queue.front() != nullptr)
+        {
+            queue.pop();
+            ++consumed;
+        }
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return totalMessages / elapsed.count() / 1e6;
+}
+
+} // namespace
+
+auto main() -> int
+{
+    std::cout << "Messages: " << TOTAL_MESSAGES << ", throughput in millions of messages/s\n"
+              << std::setw(10) << "producers"
+              << std::setw(14) << "mutex queue"
+              << std::setw(14) << "mpsc queue" << '\n';
+
+    for (unsigned int producers = 1; producers <= MAX_PRODUCERS; producers *= 2)
+    {
+        const double mutexQueue = runBenchmark<MutexQueue>(producers);
+        const double mpscQueue = runBenchmark<lwspp::srv::MpscQueue<Message>>(producers);
+
+        std::cout << std::fixed << std::setprecision(2)
+                  << std::setw(10) << producers
+                  << std::setw(14) << mutexQueue
+                  << std::setw(14) << mpscQueue << '\n';
+    }
+
+    return 0;
+}
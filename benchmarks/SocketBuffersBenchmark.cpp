@@ -0,0 +1,220 @@
+/*
+ * lwspp - C++ wrapper for the libwebsockets library
+ *
+ * Copyright (C) 2023 - 2023 Volodymyr Lotoshko <vlotoshko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "LwsAdapter/LwsSocket.hpp"
+
+/**
+ * Loopback benchmark of the socket tuning: the throughput of the one way stream and the round
+ * trip latency of the echo for the small and the large messages across the SO_SNDBUF and
+ * SO_RCVBUF sizes. The sockets are set up by the same functions the server uses for the
+ * listening and the accepted sockets, the zero size keeps the system default.
+ */
+
+namespace
+{
+
+using lwspp::srv::SocketSettings;
+
+const size_t SMALL_MESSAGE = 64;
+const size_t LARGE_MESSAGE = 64 * 1024;
+const size_t STREAM_BYTES = 256 * 1024 * 1024;
+const unsigned int ROUND_TRIPS = 2000;
+const int BUFFER_SIZES[] = {0, 16 * 1024, 64 * 1024, 256 * 1024, 1024 * 1024};
+
+void writeAll(int socketFd, const char* data, size_t size)
+{
+    while (size > 0)
+    {
+        const auto written = write(socketFd, data, size);
+        if (written <= 0)
+        {
+            throw std::runtime_error{"write failed"};
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+}
+
+void readAll(int socketFd, char* data, size_t size)
+{
+    while (size > 0)
+    {
+        const auto received = read(socketFd, data, size);
+        if (received <= 0)
+        {
+            throw std::runtime_error{"read failed"};
+        }
+        data += received;
+        size -= static_cast<size_t>(received);
+    }
+}
+
+/**
+ * @brief The SocketPair class connects the client socket to the accepted one over the loopback
+ */
+class SocketPair
+{
+public:
+    explicit SocketPair(const SocketSettings& settings)
+    {
+        const int listener = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t addressSize = sizeof(address);
+
+        if (bind(listener, reinterpret_cast<sockaddr*>(&address), addressSize) != 0 ||
+            listen(listener, 1) != 0 ||
+            getsockname(listener, reinterpret_cast<sockaddr*>(&address), &addressSize) != 0)
+        {
+            throw std::runtime_error{"listen failed"};
+        }
+        lwspp::srv::setupListeningSocket(listener, settings);
+
+        client = socket(AF_INET, SOCK_STREAM, 0);
+        lwspp::srv::setupConnectionSocket(client, settings);
+        if (connect(client, reinterpret_cast<sockaddr*>(&address), addressSize) != 0)
+        {
+            throw std::runtime_error{"connect failed"};
+        }
+
+        server = accept(listener, nullptr, nullptr);
+        lwspp::srv::setupConnectionSocket(server, settings);
+        close(listener);
+    }
+
+    ~SocketPair()
+    {
+        close(client);
+        close(server);
+    }
+
+    SocketPair(const SocketPair&) = delete;
+    auto operator=(const SocketPair&) -> SocketPair& = delete;
+    SocketPair(SocketPair&&) = delete;
+    auto operator=(SocketPair&&) -> SocketPair& = delete;
+
+    int client = -1;
+    int server = -1;
+};
+
+// Returns the throughput in MB/s
+auto measureThroughput(const SocketSettings& settings, size_t messageSize) -> double
+{
+    SocketPair sockets{settings};
+    const size_t messages = STREAM_BYTES / messageSize;
+
+    std::thread receiver([&sockets, messageSize, messages]()
+    {
+        std::vector<char> buffer(messageSize);
+        for (size_t n = 0; n < messages; ++n)
+        {
+            readAll(sockets.client, buffer.data(), messageSize);
+        }
+    });
+
+    const auto start = std::chrono::steady_clock::now();
+    const std::vector<char> message(messageSize, 'x');
+    for (size_t n = 0; n < messages; ++n)
+    {
+        writeAll(sockets.server, message.data(), messageSize);
+    }
+    receiver.join();
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return static_cast<double>(messages * messageSize) / elapsed.count() / 1e6;
+}
+
+// Returns the average round trip time in microseconds
+auto measureLatency(const SocketSettings& settings, size_t messageSize) -> double
+{
+    SocketPair sockets{settings};
+
+    std::thread echo([&sockets, messageSize]()
+    {
+        std::vector<char> buffer(messageSize);
+        for (unsigned int n = 0; n < ROUND_TRIPS; ++n)
+        {
+            readAll(sockets.server, buffer.data(), messageSize);
+            writeAll(sockets.server, buffer.data(), messageSize);
+        }
+    });
+
+    std::vector<char> message(messageSize, 'x');
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned int n = 0; n < ROUND_TRIPS; ++n)
+    {
+        writeAll(sockets.client, message.data(), messageSize);
+        readAll(sockets.client, message.data(), messageSize);
+    }
+    echo.join();
+
+    const std::chrono::duration<double, std::micro> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count() / ROUND_TRIPS;
+}
+
+} // namespace
+
+auto main() -> int
+{
+    std::cout << "Throughput in MB/s, round trip latency in microseconds\n"
+              << std::setw(12) << "buffer size"
+              << std::setw(14) << "message size"
+              << std::setw(12) << "throughput"
+              << std::setw(10) << "latency" << '\n';
+
+    for (const int bufferSize : BUFFER_SIZES)
+    {
+        for (const size_t messageSize : {SMALL_MESSAGE, LARGE_MESSAGE})
+        {
+            auto settings = SocketSettings{};
+            settings.sendBufferSize = bufferSize;
+            settings.receiveBufferSize = bufferSize;
+
+            const double throughput = measureThroughput(settings, messageSize);
+            const double latency = measureLatency(settings, messageSize);
+
+            std::cout << std::fixed << std::setprecision(2)
+                      << std::setw(12) << (bufferSize == 0 ? "default" : std::to_string(bufferSize))
+                      << std::setw(14) << messageSize
+                      << std::setw(12) << throughput
+                      << std::setw(10) << latency << '\n';
+        }
+    }
+
+    return 0;
+}
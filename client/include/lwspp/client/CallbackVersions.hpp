@@ -41,10 +41,12 @@ namespace cli
  */
 enum class CallbackVersion : uint8_t
 {
+    // Delivers the received data as it comes, a message can be split into several packets
     v1_Amsterdam,
+    // Delivers the received message once and whole, the data packet contains the entire message
+    v2_Barcelona,
 
     // Reserved for future versions
-//    v2_Barcelona,
 //    v3_Chicago,
 //    v4_Dublin,
 //    v5_Eindhoven,
@@ -59,17 +59,78 @@ public:
     auto setAddress(Address) -> ClientBuilder&;
     auto setPort(Port) -> ClientBuilder&;
     auto setClientLogic(contract::IClientLogicPtr) -> ClientBuilder&;
+    // Replaces the client logic for the client with several connections, every callback is given
+    // the id of the connection. Either the client logic or the multi client logic must be set.
+    auto setMultiClientLogic(contract::IMultiClientLogicPtr) -> ClientBuilder&;
     auto setClientControlAcceptor(contract::IClientControlAcceptorPtr) -> ClientBuilder&;
 
     // Non mandatory options
     auto setProtocolName(std::string) -> ClientBuilder&;
     auto setPath(Path) -> ClientBuilder&;
+    // Adds one more connection of the client to the given endpoint, the same endpoint can be
+    // added several times. The connections have the ids in the order they are added, see
+    // ConnectionId, and the data is sent to them by the IClientControl overloads taking the id.
+    // The connections share one libwebsockets context and one service thread, or the runtime
+    // set by the setRuntime option. Requires the multi client logic, can not be combined with
+    // the event loop.
+    auto addConnection(Endpoint) -> ClientBuilder&;
     auto setSslSettings(SslSettingsPtr) -> ClientBuilder&;
     auto setKeepAliveTimeout(int) -> ClientBuilder&;
     auto setKeepAliveProbes(int) -> ClientBuilder&;
     auto setKeepAliveProbesInterval(int) -> ClientBuilder&;
     auto setLwsLogLevel(int) -> ClientBuilder&;
 
+    // Services the client socket by the given external event loop instead of the client thread,
+    // see contract::IEventLoop. The loop calls IClient::serviceFd and IClient::service on its
+    // thread. Requires the libwebsockets built with LWS_WITH_EXTERNAL_POLL.
+    auto setEventLoop(contract::IEventLoopPtr) -> ClientBuilder&;
+
+    // Shares the libwebsockets context and the service threads of the given runtime with the
+    // other clients instead of creating its own ones, see ClientRuntimeBuilder. The keep alive,
+    // compression, log level, rx and tx sizes, and the SSL certificates are taken from the runtime
+    // then, the SSL checks of the server certificate are still taken from the client settings.
+    // Can not be combined with the event loop.
+    auto setRuntime(IClientRuntimePtr) -> ClientBuilder&;
+
+    // Limits the data written to the connection on a single writable event. Queued messages are
+    // written one by one while the socket can take more data and none of the limits is reached.
+    // At least one message is written, even if it is larger than the bytes limit.
+    auto setMaxMessagesPerWrite(unsigned int) -> ClientBuilder&;
+    auto setMaxBytesPerWrite(size_t) -> ClientBuilder&;
+
+    // Splits the messages larger than the given size into fragments, every fragment counts as
+    // the message in the limits above. So the large message does not hold the service loop and
+    // the control frames are sent between its fragments. The zero value (the default) disables it.
+    auto setMaxFragmentSize(size_t) -> ClientBuilder&;
+
+    // Limits the data queued to the connection, the zero limit means no limit. The policy
+    // applies when the limit is reached, see SlowConsumerPolicy and IClientLogic::onWatermark.
+    auto setMaxQueuedMessages(size_t) -> ClientBuilder&;
+    auto setMaxQueuedBytes(size_t) -> ClientBuilder&;
+    auto setSlowConsumerPolicy(SlowConsumerPolicy) -> ClientBuilder&;
+
+    // The size of the chunk pulled from the stream producer, see IClientControl::sendBinaryStream
+    auto setStreamChunkSize(size_t) -> ClientBuilder&;
+
+    // Limits the size of the message reassembled for the CallbackVersion::V2, the connection is
+    // closed with the 1009 (message too big) status if the received message exceeds it.
+    // 16 MiB by default
+    auto setMaxMessageSize(size_t) -> ClientBuilder&;
+
+    // Enables the permessage-deflate extension, see CompressionSettingsBuilder
+    auto setCompression(CompressionSettingsPtr) -> ClientBuilder&;
+
+    // Socket and buffer tuning, the zero value keeps the libwebsockets or the system default.
+    // The rx buffer size is the largest data chunk passed to the receive callback, the tx packet
+    // size is the largest data chunk written to the socket at once.
+    auto setRxBufferSize(size_t) -> ClientBuilder&;
+    auto setTxPacketSize(size_t) -> ClientBuilder&;
+    // The SO_SNDBUF and SO_RCVBUF of the socket, set before the connection is made
+    auto setSocketSendBufferSize(int) -> ClientBuilder&;
+    auto setSocketReceiveBufferSize(int) -> ClientBuilder&;
+    // Disables the Nagle's algorithm, enabled by default
+    auto setTcpNoDelay(bool) -> ClientBuilder&;
+
 private:
     std::unique_ptr<ClientContext> _context;
 
@@ -48,6 +48,7 @@ public:
     void onTextDataReceive(const DataPacket&) noexcept override;
     void onError(const std::string& errorMessage) noexcept override;
     void onWarning(const std::string& warningMessage) noexcept override;
+    void onWatermark(Watermark) noexcept override;
     
     void acceptClientControl(IClientControlPtr) noexcept override;
 
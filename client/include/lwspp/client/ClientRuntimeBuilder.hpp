@@ -0,0 +1,85 @@
+/*
+ * lwspp - C++ wrapper for the libwebsockets library
+ *
+ * Copyright (C) 2023 - 2023 Volodymyr Lotoshko <vlotoshko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "lwspp/client/TypesFwd.hpp"
+
+namespace lwspp
+{
+namespace cli
+{
+
+class ClientRuntimeContext;
+
+/**
+ * @brief The ClientRuntimeBuilder class constructs the runtime shared by many clients, see
+ * IClientRuntime. The runtime options apply to all the clients sharing it, they replace the same
+ * options of the client builder.
+ */
+class ClientRuntimeBuilder
+{
+public:
+    ClientRuntimeBuilder();
+    ~ClientRuntimeBuilder();
+
+    ClientRuntimeBuilder(ClientRuntimeBuilder&&) noexcept;
+    auto operator=(ClientRuntimeBuilder&&) noexcept -> ClientRuntimeBuilder&;
+
+    ClientRuntimeBuilder(const ClientRuntimeBuilder&) = delete;
+    auto operator=(const ClientRuntimeBuilder&) -> ClientRuntimeBuilder& = delete;
+
+public:
+    auto build() const -> IClientRuntimePtr;
+
+    // Number of threads servicing the connections of the clients. Every client is serviced by
+    // one of the threads, the clients are spread across the threads evenly. The libwebsockets
+    // library should be built with LWS_MAX_SMP > 1, otherwise the only one thread is used.
+    auto setServiceThreads(unsigned int) -> ClientRuntimeBuilder&;
+
+    // The certificates and keys loaded once for all the clients. The per-connection checks of
+    // the server certificate are set by the SSL settings of every client.
+    auto setSslSettings(SslSettingsPtr) -> ClientRuntimeBuilder&;
+    // Enables the permessage-deflate extension for all the clients, see CompressionSettingsBuilder
+    auto setCompression(CompressionSettingsPtr) -> ClientRuntimeBuilder&;
+
+    auto setKeepAliveTimeout(int) -> ClientRuntimeBuilder&;
+    auto setKeepAliveProbes(int) -> ClientRuntimeBuilder&;
+    auto setKeepAliveProbesInterval(int) -> ClientRuntimeBuilder&;
+    auto setLwsLogLevel(int) -> ClientRuntimeBuilder&;
+
+    // The zero value keeps the libwebsockets default, see ClientBuilder::setRxBufferSize
+    auto setRxBufferSize(size_t) -> ClientRuntimeBuilder&;
+    auto setTxPacketSize(size_t) -> ClientRuntimeBuilder&;
+
+private:
+    std::unique_ptr<ClientRuntimeContext> _context;
+
+    friend class TestClientRuntimeBuilder;
+};
+
+} // namespace cli
+} // namespace lwspp
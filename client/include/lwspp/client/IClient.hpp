@@ -37,6 +37,8 @@ namespace cli
  * @note The client automatically connects upon construction and disconnects upon destruction.
  * @note The client operates within a separate thread to establish and maintain the connection
  * with the server.
+ * @note When the client is configured with ClientBuilder::setEventLoop, it has no thread of
+ * its own and is serviced by the external event loop through the methods below.
  */
 class IClient
 {
@@ -49,6 +51,16 @@ public:
 
     IClient(const IClient&) = delete;
     auto operator=(const IClient&) noexcept -> IClient& = delete;
+
+public:
+    // Services the poll events (POLLIN, POLLOUT, POLLHUP, ...) occurred on the socket watched by
+    // the external event loop. Must be called on the loop thread only.
+    virtual void serviceFd(int fd, short revents) = 0;
+    // Services the work of the client which is not bound to the socket: the data sent from the
+    // other threads and the timeouts. Must be called on the loop thread only, when the loop is
+    // woken up and when the returned timeout in milliseconds expires. The zero timeout means
+    // the client has buffered data to process and should be serviced again immediately.
+    virtual auto service() -> int = 0;
 };
 
 } // namespace cli
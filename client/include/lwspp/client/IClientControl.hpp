@@ -27,6 +27,10 @@
 #include <string>
 #include <vector>
 
+#include "lwspp/client/SendBuffer.hpp"
+#include "lwspp/client/Types.hpp"
+#include "lwspp/client/TypesFwd.hpp"
+
 namespace lwspp
 {
 namespace cli
@@ -49,10 +53,63 @@ public:
 
 public:
     // Sends text data to the server. The provided text data should be valid UTF-8 text.
-    virtual void sendTextData(const std::string&) = 0;
+    // Returns whether the data is queued, see SlowConsumerPolicy.
+    virtual auto sendTextData(const std::string&) -> SendResult = 0;
 
     // Sends binary data to the server
-    virtual void sendBinaryData(const std::vector<char>&) = 0;
+    virtual auto sendBinaryData(const std::vector<char>&) -> SendResult = 0;
+
+    // Overloads taking the ownership of the data. The SendBuffer reserves the headroom required
+    // by the libwebsockets in front of the data, so it is queued without any copy. The string and
+    // the vector are always copied, serialize the data into the SendBuffer to avoid the copy.
+    virtual auto sendTextData(SendBuffer&&) -> SendResult = 0;
+    virtual auto sendBinaryData(SendBuffer&&) -> SendResult = 0;
+
+    // Sends the data through the lane of the given priority, e.g. the urgent notice is not
+    // queued behind the bulk data.
+    virtual auto sendTextData(const std::string&, Priority) -> SendResult = 0;
+    virtual auto sendBinaryData(const std::vector<char>&, Priority) -> SendResult = 0;
+    virtual auto sendTextData(SendBuffer&&, Priority) -> SendResult = 0;
+    virtual auto sendBinaryData(SendBuffer&&, Priority) -> SendResult = 0;
+
+    // Streams the binary data pulled from the producer to the server in fragments,
+    // see contract::IStreamProducer and setStreamChunkSize option of the ClientBuilder.
+    virtual auto sendBinaryStream(contract::IStreamProducerPtr) -> SendResult = 0;
+    // Resumes the stream parked by the not ready chunk of its producer, see StreamChunk. Can be
+    // called from any thread. Returns false if the client is not connected.
+    virtual auto resumeStream() -> bool = 0;
+
+    // Pauses the reading from the server, so the TCP backpressure slows the server down instead
+    // of the received data piling up in the client, and resumes it. Can be called from any
+    // thread, the service thread pauses or resumes the reading shortly after.
+    // Returns false if the client is not connected.
+    virtual auto pauseReceiving() -> bool = 0;
+    virtual auto resumeReceiving() -> bool = 0;
+
+    // Returns the compression statistics of the connection, see setCompression option
+    // of the ClientBuilder. Returns empty statistics if the client is not connected.
+    virtual auto getCompressionStats() -> CompressionStats = 0;
+
+    // The overloads addressing the connection of the client by its id, see addConnection option
+    // of the ClientBuilder. The methods above address the connection with the zero id.
+    // The unknown or not connected connection is treated like the not connected client.
+    virtual auto sendTextData(ConnectionId, const std::string&) -> SendResult = 0;
+    virtual auto sendBinaryData(ConnectionId, const std::vector<char>&) -> SendResult = 0;
+    virtual auto sendTextData(ConnectionId, SendBuffer&&) -> SendResult = 0;
+    virtual auto sendBinaryData(ConnectionId, SendBuffer&&) -> SendResult = 0;
+
+    virtual auto sendTextData(ConnectionId, const std::string&, Priority) -> SendResult = 0;
+    virtual auto sendBinaryData(ConnectionId, const std::vector<char>&, Priority) -> SendResult = 0;
+    virtual auto sendTextData(ConnectionId, SendBuffer&&, Priority) -> SendResult = 0;
+    virtual auto sendBinaryData(ConnectionId, SendBuffer&&, Priority) -> SendResult = 0;
+
+    virtual auto sendBinaryStream(ConnectionId, contract::IStreamProducerPtr) -> SendResult = 0;
+    virtual auto resumeStream(ConnectionId) -> bool = 0;
+
+    virtual auto pauseReceiving(ConnectionId) -> bool = 0;
+    virtual auto resumeReceiving(ConnectionId) -> bool = 0;
+
+    virtual auto getCompressionStats(ConnectionId) -> CompressionStats = 0;
 };
 
 } // namespace cli
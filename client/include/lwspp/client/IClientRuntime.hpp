@@ -0,0 +1,56 @@
+/*
+ * lwspp - C++ wrapper for the libwebsockets library
+ *
+ * Copyright (C) 2023 - 2023 Volodymyr Lotoshko <vlotoshko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+namespace lwspp
+{
+namespace cli
+{
+
+/**
+ * @brief The IClientRuntime class defines the runtime shared by many clients: the libwebsockets
+ * context and the threads servicing the connections of the clients.
+ *
+ * Use the client runtime builder to obtain an instance of the runtime implementation, and pass
+ * it to the ClientBuilder::setRuntime of every client sharing it.
+ *
+ * @note The runtime starts its service threads upon construction and stops them upon
+ * destruction. The clients hold the runtime, so it is destroyed after the last of them.
+ */
+class IClientRuntime
+{
+public:
+    IClientRuntime() = default;
+    virtual ~IClientRuntime() = default;
+
+    IClientRuntime(IClientRuntime&&) = default;
+    auto operator=(IClientRuntime&&) noexcept -> IClientRuntime& = default;
+
+    IClientRuntime(const IClientRuntime&) = delete;
+    auto operator=(const IClientRuntime&) noexcept -> IClientRuntime& = delete;
+};
+
+} // namespace cli
+} // namespace lwspp
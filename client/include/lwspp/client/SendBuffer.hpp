@@ -0,0 +1,80 @@
+/*
+ * lwspp - C++ wrapper for the libwebsockets library
+ *
+ * Copyright (C) 2023 - 2023 Volodymyr Lotoshko <vlotoshko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <string>
+
+namespace lwspp
+{
+namespace cli
+{
+
+class SendBufferAccessor;
+
+/**
+ * @brief The SendBuffer class is a buffer for the outgoing message data. It reserves the headroom
+ * required by the libwebsockets in front of the data, so the data serialized into the buffer
+ * is queued for sending without any copy.
+ */
+class SendBuffer
+{
+public:
+    SendBuffer();
+    // Creates the buffer with the given data size, the data is zero initialized
+    explicit SendBuffer(size_t size);
+    ~SendBuffer() = default;
+
+    SendBuffer(SendBuffer&&) noexcept = default;
+    auto operator=(SendBuffer&&) noexcept -> SendBuffer& = default;
+
+    SendBuffer(const SendBuffer&) = default;
+    auto operator=(const SendBuffer&) -> SendBuffer& = default;
+
+public:
+    // Returns pointer to the beginning of the data
+    auto data() -> char*;
+    auto data() const -> const char*;
+    auto size() const -> size_t;
+    auto empty() const -> bool;
+
+    void resize(size_t size);
+    // Reserves the space for the data of the given size, the headroom is added implicitly
+    void reserve(size_t size);
+    void append(const char* data, size_t size);
+    void append(const std::string&);
+    void clear();
+
+private:
+    void ensureHeadroom_();
+
+private:
+    // Contains the headroom followed by the data
+    std::string _buffer;
+
+    friend class SendBufferAccessor;
+};
+
+} // namespace cli
+} // namespace lwspp
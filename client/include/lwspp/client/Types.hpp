@@ -24,6 +24,8 @@
 
 #pragma once
 
+#include <chrono>
+#include <cstdint>
 #include <string>
 
 namespace lwspp
@@ -36,6 +38,19 @@ using Address = std::string;
 using Port = int;
 using Path = std::string;
 
+// Identifies the connection of the client. The connection set by the address, port and path
+// options of the ClientBuilder has the zero id, the connections added by the addConnection
+// option have the next ids in the order they are added.
+using ConnectionId = uint64_t;
+
+// The server endpoint of the connection, see addConnection option of the ClientBuilder
+struct Endpoint
+{
+    Address address;
+    Port port;
+    Path path;
+};
+
 struct DataPacket
 {
     // Pointer to the beginning of the data in the packet.
@@ -48,5 +63,74 @@ struct DataPacket
     size_t remains = 0;
 };
 
+// Applies when the outbound queue of the connection reaches its limit, see setMaxQueuedMessages
+// and setMaxQueuedBytes options of the ClientBuilder
+enum class SlowConsumerPolicy : uint8_t
+{
+    // The data is not queued, the send returns SendResult::Rejected
+    Reject,
+    // The data is queued, the oldest queued messages are dropped to fit the limits
+    DropOldest,
+    // The data is dropped, the send returns SendResult::Dropped
+    DropNewest,
+    // The connection is closed with the policy violation close code
+    Disconnect
+};
+
+enum class SendResult : uint8_t
+{
+    Queued,
+    Rejected,
+    Dropped,
+    Disconnected,
+    NotConnected
+};
+
+// Selects the outbound lane of the connection. The high priority lane is written first, but it
+// gives way to the bulk lane periodically, so the bulk data is never starved. The data sent
+// without the priority goes to the bulk lane.
+enum class Priority : uint8_t
+{
+    High,
+    Bulk
+};
+
+// The outbound queue of the connection reaches its limit (High) or drains below the half
+// of the limits (Low)
+enum class Watermark : uint8_t
+{
+    High,
+    Low
+};
+
+// The chunk of the streamed data, see contract::IStreamProducer
+struct StreamChunk
+{
+    size_t size;
+    // The last chunk ends the message, it can be empty
+    bool isLast;
+    // The producer has no data yet, nothing is written and the stream is parked until
+    // IClientControl::resumeStream is called. The empty chunk which is not the last one parks
+    // the stream too.
+    bool isReady = true;
+};
+
+// The permessage-deflate statistics of the connection
+struct CompressionStats
+{
+    // Size of the sent data messages before and after compression.
+    uint64_t uncompressedBytes = 0;
+    uint64_t compressedBytes = 0;
+
+    // CPU time spent on the compression.
+    std::chrono::nanoseconds cpuTime{0};
+
+    auto ratio() const -> double
+    {
+        return compressedBytes == 0 ? 1.0 :
+                   static_cast<double>(uncompressedBytes) / static_cast<double>(compressedBytes);
+    }
+};
+
 } // namespace cli
 } // namespace lwspp
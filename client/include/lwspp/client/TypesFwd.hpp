@@ -37,12 +37,18 @@ using IClientControlPtr = std::shared_ptr<IClientControl>;
 class IClient;
 using IClientPtr = std::shared_ptr<IClient>;
 
+class IClientRuntime;
+using IClientRuntimePtr = std::shared_ptr<IClientRuntime>;
+
 class IConnectionInfo;
 using IConnectionInfoPtr = std::shared_ptr<IConnectionInfo>;
 
 class SslSettings;
 using SslSettingsPtr = std::shared_ptr<SslSettings>;
 
+class CompressionSettings;
+using CompressionSettingsPtr = std::shared_ptr<CompressionSettings>;
+
 namespace contract
 {
 
@@ -52,6 +58,15 @@ using IClientControlAcceptorPtr = std::shared_ptr<IClientControlAcceptor>;
 class IClientLogic;
 using IClientLogicPtr = std::shared_ptr<IClientLogic>;
 
+class IMultiClientLogic;
+using IMultiClientLogicPtr = std::shared_ptr<IMultiClientLogic>;
+
+class IEventLoop;
+using IEventLoopPtr = std::shared_ptr<IEventLoop>;
+
+class IStreamProducer;
+using IStreamProducerPtr = std::shared_ptr<IStreamProducer>;
+
 } // namespace contract
 } // namespace cli
 } // namespace lwspp
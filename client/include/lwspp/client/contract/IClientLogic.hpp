@@ -39,6 +39,10 @@ namespace contract
 /**
  * @brief The IClientLogic class defines an interface for implementing client behavior.
  * Users of the library must implement this interface themselves.
+ *
+ * @note The callbacks are invoked by the service thread one at a time, except onWatermark with
+ * Watermark::High. It is invoked by the thread sending the data, so it may run concurrently with
+ * the other callbacks.
  */
 class IClientLogic
 {
@@ -64,6 +68,11 @@ public:
     virtual void onDisconnect() noexcept = 0;
     virtual void onError(const std::string& errorMessage) noexcept = 0;
     virtual void onWarning(const std::string& errorMessage) noexcept = 0;
+
+    // Invoked when the outbound queue crosses its watermark. Both watermarks are reported by
+    // the service thread, so the high one always comes before the low one. Does nothing by
+    // default, the queue limits are optional.
+    virtual void onWatermark(Watermark) noexcept {}
 };
 
 } // namespace contract
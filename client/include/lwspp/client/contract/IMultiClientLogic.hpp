@@ -0,0 +1,82 @@
+/*
+ * lwspp - C++ wrapper for the libwebsockets library
+ *
+ * Copyright (C) 2023 - 2023 Volodymyr Lotoshko <vlotoshko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "lwspp/client/Types.hpp"
+#include "lwspp/client/TypesFwd.hpp"
+
+namespace lwspp
+{
+namespace cli
+{
+namespace contract
+{
+
+/**
+ * @brief The IMultiClientLogic class defines an interface for implementing the behavior of the
+ * client with several connections, see ClientBuilder::addConnection. Every callback is given
+ * the id of the connection it occurred on, like the server logic. Users of the library must
+ * implement this interface themselves.
+ *
+ * @note The callbacks of different connections may be invoked by different service threads
+ * of the runtime, see ClientRuntimeBuilder::setServiceThreads. The onWatermark with
+ * Watermark::High is invoked by the thread sending the data, see IClientLogic.
+ */
+class IMultiClientLogic
+{
+public:
+    IMultiClientLogic() = default;
+    virtual ~IMultiClientLogic() = default;
+
+    IMultiClientLogic(IMultiClientLogic&&) = default;
+    auto operator=(IMultiClientLogic&&) noexcept -> IMultiClientLogic& = default;
+
+    IMultiClientLogic(const IMultiClientLogic&) = delete;
+    auto operator=(const IMultiClientLogic&) noexcept -> IMultiClientLogic& = delete;
+
+public:
+    // Invoked when the connection receives first data packet of the message.
+    virtual void onFirstDataPacket(ConnectionId, size_t messageLength) noexcept = 0;
+    // Invoked when the connection receives binary data from the server.
+    virtual void onBinaryDataReceive(ConnectionId, const DataPacket&) noexcept = 0;
+    // Invoked when the connection receives text data from the server. This method expects valid
+    // UTF-8 text.
+    virtual void onTextDataReceive(ConnectionId, const DataPacket&) noexcept = 0;
+
+    virtual void onConnect(ConnectionId, IConnectionInfoPtr) noexcept = 0;
+    virtual void onDisconnect(ConnectionId) noexcept = 0;
+    virtual void onError(ConnectionId, const std::string& errorMessage) noexcept = 0;
+    virtual void onWarning(ConnectionId, const std::string& errorMessage) noexcept = 0;
+
+    // Invoked when the outbound queue of the connection crosses its watermark, see
+    // IClientLogic::onWatermark. Does nothing by default.
+    virtual void onWatermark(ConnectionId, Watermark) noexcept {}
+};
+
+} // namespace contract
+} // namespace cli
+} // namespace lwspp
@@ -23,6 +23,7 @@
  */
 
 #include "Client.hpp"
+#include "ClientContext.hpp"
 #include "LwsAdapter/LwsClient.hpp"
 
 namespace lwspp
@@ -33,6 +34,14 @@ namespace cli
 Client::Client(const ClientContext& context)
     : _lwsClient(std::make_shared<LwsClient>(context))
 {
+    // The external event loop or the runtime services the client on its thread, there is nothing
+    // to wait for. The client with several connections is serviced by its private runtime.
+    if (context.eventLoop != nullptr || context.runtime != nullptr || !context.connections.empty())
+    {
+        _lwsClient->connect();
+        return;
+    }
+
     const std::weak_ptr<LwsClient> weakLwsClient = _lwsClient;
 
     auto asyncConnect = [weakLwsClient]
@@ -49,7 +58,20 @@ Client::Client(const ClientContext& context)
 Client::~Client()
 {
     _lwsClient->disconnect();
-    _clientStop.wait();
+    if (_clientStop.valid())
+    {
+        _clientStop.wait();
+    }
+}
+
+void Client::serviceFd(int fd, short revents)
+{
+    _lwsClient->serviceFd(fd, revents);
+}
+
+auto Client::service() -> int
+{
+    return _lwsClient->service();
 }
 
 } // namespace cli
@@ -38,7 +38,8 @@ namespace cli
  * @brief The Client class wraps the internal LwsClient implementation.
  *
  * The client automatically connects upon construction and disconnects upon destruction.
- * It operates within a separate thread to establish and maintain the connection with the server.
+ * It operates within a separate thread to establish and maintain the connection with the server,
+ * unless it is serviced by the external event loop.
  */
 class Client : public IClient
 {
@@ -52,6 +53,9 @@ public:
     Client(const Client&) = delete;
     auto operator=(const Client&) -> Client& = delete;
 
+    void serviceFd(int fd, short revents) override;
+    auto service() -> int override;
+
 private:
     LwsClientPtr _lwsClient;
     std::future<void> _clientStop;
@@ -26,6 +26,8 @@
 
 #include "Client.hpp"
 #include "ClientContext.hpp"
+#include "ClientRuntime.hpp"
+#include "CompressionSettings.hpp"
 #include "SslSettings.hpp" // IWYU pragma: keep
 #include "lwspp/client/ClientBuilder.hpp"
 
@@ -45,6 +47,14 @@ public:
     {}
 };
 
+class InvalidParameterException : public std::runtime_error
+{
+public:
+    explicit InvalidParameterException(const std::string& parameter)
+        : std::runtime_error("Invalid parameter value: " + parameter)
+    {}
+};
+
 void checkContext(const ClientContext& context)
 {
     if (context.callbackVersion == UNDEFINED_CALLBACK_VERSION)
@@ -62,11 +72,16 @@ void checkContext(const ClientContext& context)
         throw UndefinedRequiredParameterException{"port"};
     }
 
-    if (context.clientLogic == nullptr)
+    if (context.clientLogic == nullptr && context.multiClientLogic == nullptr)
     {
         throw UndefinedRequiredParameterException{"event handler"};
     }
 
+    if (context.clientLogic != nullptr && context.multiClientLogic != nullptr)
+    {
+        throw InvalidParameterException{"multi client logic"};
+    }
+
     if (context.clientControlAcceptor == nullptr)
     {
         throw UndefinedRequiredParameterException{"client control acceptor"};
@@ -91,6 +106,94 @@ void checkContext(const ClientContext& context)
             throw UndefinedRequiredParameterException{"keep alive probes interval"};
         }
     }
+
+    // The runtime is serviced by its own threads
+    if (context.runtime != nullptr && context.eventLoop != nullptr)
+    {
+        throw InvalidParameterException{"event loop"};
+    }
+
+    if (!context.connections.empty())
+    {
+        // The client logic can not tell the connections apart
+        if (context.clientLogic != nullptr)
+        {
+            throw InvalidParameterException{"client logic"};
+        }
+
+        // The connections are serviced by the threads of the runtime
+        if (context.eventLoop != nullptr)
+        {
+            throw InvalidParameterException{"event loop"};
+        }
+
+        for (const auto& connection : context.connections)
+        {
+            if (connection.address.empty() || connection.address == UNDEFINED_ADDRESS ||
+                connection.port == UNDEFINED_PORT)
+            {
+                throw InvalidParameterException{"connection endpoint"};
+            }
+        }
+    }
+
+    // Only the runtime built by the ClientRuntimeBuilder can be shared
+    if (context.runtime != nullptr &&
+        std::dynamic_pointer_cast<ClientRuntime>(context.runtime) == nullptr)
+    {
+        throw InvalidParameterException{"runtime"};
+    }
+
+    if (context.maxMessagesPerWrite == 0)
+    {
+        throw InvalidParameterException{"max messages per write"};
+    }
+
+    if (context.maxBytesPerWrite == 0)
+    {
+        throw InvalidParameterException{"max bytes per write"};
+    }
+
+    if (context.streamChunkSize == 0)
+    {
+        throw InvalidParameterException{"stream chunk size"};
+    }
+
+    if (context.maxMessageSize == 0)
+    {
+        throw InvalidParameterException{"max message size"};
+    }
+
+    if (context.compression != nullptr)
+    {
+        if (context.compression->compressionLevel < MIN_COMPRESSION_LEVEL ||
+            context.compression->compressionLevel > MAX_COMPRESSION_LEVEL)
+        {
+            throw InvalidParameterException{"compression level"};
+        }
+
+        if (context.compression->windowBits < MIN_COMPRESSION_WINDOW_BITS ||
+            context.compression->windowBits > MAX_COMPRESSION_WINDOW_BITS)
+        {
+            throw InvalidParameterException{"compression window bits"};
+        }
+
+        if (context.compression->memoryLevel < MIN_COMPRESSION_MEMORY_LEVEL ||
+            context.compression->memoryLevel > MAX_COMPRESSION_MEMORY_LEVEL)
+        {
+            throw InvalidParameterException{"compression memory level"};
+        }
+    }
+
+    if (context.socketSendBufferSize < 0)
+    {
+        throw InvalidParameterException{"socket send buffer size"};
+    }
+
+    if (context.socketReceiveBufferSize < 0)
+    {
+        throw InvalidParameterException{"socket receive buffer size"};
+    }
 }
 
 } // namespace
@@ -127,6 +230,12 @@ auto ClientBuilder::setClientLogic(contract::IClientLogicPtr e) -> ClientBuilder
     return *this;
 }
 
+auto ClientBuilder::setMultiClientLogic(contract::IMultiClientLogicPtr l) -> ClientBuilder&
+{
+    _context->multiClientLogic = std::move(l);
+    return *this;
+}
+
 auto ClientBuilder::setClientControlAcceptor(contract::IClientControlAcceptorPtr c) -> ClientBuilder&
 {
     _context->clientControlAcceptor = std::move(c);
@@ -145,6 +254,12 @@ auto ClientBuilder::setPath(Path path) -> ClientBuilder&
     return *this;
 }
 
+auto ClientBuilder::addConnection(Endpoint endpoint) -> ClientBuilder&
+{
+    _context->connections.push_back(std::move(endpoint));
+    return *this;
+}
+
 auto ClientBuilder::setPort(Port port) -> ClientBuilder&
 {
     _context->port = port;
@@ -193,5 +308,101 @@ auto ClientBuilder::setLwsLogLevel(int logLevel) -> ClientBuilder&
     return *this;
 }
 
+auto ClientBuilder::setEventLoop(contract::IEventLoopPtr eventLoop) -> ClientBuilder&
+{
+    _context->eventLoop = std::move(eventLoop);
+    return *this;
+}
+
+auto ClientBuilder::setRuntime(IClientRuntimePtr runtime) -> ClientBuilder&
+{
+    _context->runtime = std::move(runtime);
+    return *this;
+}
+
+auto ClientBuilder::setMaxMessagesPerWrite(unsigned int maxMessages) -> ClientBuilder&
+{
+    _context->maxMessagesPerWrite = maxMessages;
+    return *this;
+}
+
+auto ClientBuilder::setMaxBytesPerWrite(size_t maxBytes) -> ClientBuilder&
+{
+    _context->maxBytesPerWrite = maxBytes;
+    return *this;
+}
+
+auto ClientBuilder::setMaxFragmentSize(size_t maxFragmentSize) -> ClientBuilder&
+{
+    _context->maxFragmentSize = maxFragmentSize;
+    return *this;
+}
+
+auto ClientBuilder::setMaxQueuedMessages(size_t maxMessages) -> ClientBuilder&
+{
+    _context->maxQueuedMessages = maxMessages;
+    return *this;
+}
+
+auto ClientBuilder::setMaxQueuedBytes(size_t maxBytes) -> ClientBuilder&
+{
+    _context->maxQueuedBytes = maxBytes;
+    return *this;
+}
+
+auto ClientBuilder::setSlowConsumerPolicy(SlowConsumerPolicy policy) -> ClientBuilder&
+{
+    _context->slowConsumerPolicy = policy;
+    return *this;
+}
+
+auto ClientBuilder::setStreamChunkSize(size_t chunkSize) -> ClientBuilder&
+{
+    _context->streamChunkSize = chunkSize;
+    return *this;
+}
+
+auto ClientBuilder::setMaxMessageSize(size_t maxSize) -> ClientBuilder&
+{
+    _context->maxMessageSize = maxSize;
+    return *this;
+}
+
+auto ClientBuilder::setCompression(CompressionSettingsPtr compression) -> ClientBuilder&
+{
+    _context->compression = std::move(compression);
+    return *this;
+}
+
+auto ClientBuilder::setRxBufferSize(size_t size) -> ClientBuilder&
+{
+    _context->rxBufferSize = size;
+    return *this;
+}
+
+auto ClientBuilder::setTxPacketSize(size_t size) -> ClientBuilder&
+{
+    _context->txPacketSize = size;
+    return *this;
+}
+
+auto ClientBuilder::setSocketSendBufferSize(int size) -> ClientBuilder&
+{
+    _context->socketSendBufferSize = size;
+    return *this;
+}
+
+auto ClientBuilder::setSocketReceiveBufferSize(int size) -> ClientBuilder&
+{
+    _context->socketReceiveBufferSize = size;
+    return *this;
+}
+
+auto ClientBuilder::setTcpNoDelay(bool noDelay) -> ClientBuilder&
+{
+    _context->tcpNoDelay = noDelay;
+    return *this;
+}
+
 } // namespace cli
 } // namespace lwspp
@@ -25,6 +25,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "Consts.hpp"
 #include "lwspp/client/TypesFwd.hpp"
@@ -43,18 +44,37 @@ class ClientContext
 public:
     CallbackVersion callbackVersion = UNDEFINED_CALLBACK_VERSION;
     contract::IClientLogicPtr clientLogic;
+    contract::IMultiClientLogicPtr multiClientLogic;
     contract::IClientControlAcceptorPtr clientControlAcceptor;
 
     Address address = UNDEFINED_ADDRESS;
     Port port = UNDEFINED_PORT;
 
     Path path = DEFAULT_URI_PATH;
+    // The connections in addition to the one set by the address, port and path
+    std::vector<Endpoint> connections;
     std::string protocolName = DEFAULT_PROTOCOL_NAME;
     int keepAliveTimeout = UNDEFINED_UNSET;
     int keepAliveProbes = UNDEFINED_UNSET;
     int keepAliveProbesInterval = UNDEFINED_UNSET;
     int lwsLogLevel = DEFAULT_LWS_LOG_LEVEL;
+    contract::IEventLoopPtr eventLoop;
+    IClientRuntimePtr runtime;
+    unsigned int maxMessagesPerWrite = DEFAULT_MAX_MESSAGES_PER_WRITE;
+    size_t maxBytesPerWrite = DEFAULT_MAX_BYTES_PER_WRITE;
+    size_t maxFragmentSize = DEFAULT_MAX_FRAGMENT_SIZE;
+    size_t maxQueuedMessages = UNDEFINED_UNSET;
+    size_t maxQueuedBytes = UNDEFINED_UNSET;
+    SlowConsumerPolicy slowConsumerPolicy = DEFAULT_SLOW_CONSUMER_POLICY;
+    size_t streamChunkSize = DEFAULT_STREAM_CHUNK_SIZE;
+    size_t maxMessageSize = DEFAULT_MAX_MESSAGE_SIZE;
+    size_t rxBufferSize = UNDEFINED_UNSET;
+    size_t txPacketSize = UNDEFINED_UNSET;
+    int socketSendBufferSize = UNDEFINED_UNSET;
+    int socketReceiveBufferSize = UNDEFINED_UNSET;
+    bool tcpNoDelay = DEFAULT_TCP_NO_DELAY;
     SslSettingsPtr ssl;
+    CompressionSettingsPtr compression;
 };
 
 } // namespace cli
@@ -50,6 +50,9 @@ void ClientLogicBase::onError(const std::string& /*errorMessage*/) noexcept
 void ClientLogicBase::onWarning(const std::string& /*warningMessage*/) noexcept
 {}
 
+void ClientLogicBase::onWatermark(Watermark) noexcept
+{}
+
 void ClientLogicBase::acceptClientControl(IClientControlPtr clientControl) noexcept
 {
     _clientControl = std::move(clientControl);
@@ -0,0 +1,61 @@
+/*
+ * lwspp - C++ wrapper for the libwebsockets library
+ *
+ * Copyright (C) 2023 - 2023 Volodymyr Lotoshko <vlotoshko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "ClientRuntime.hpp"
+#include "LwsAdapter/LwsClientRuntime.hpp"
+
+namespace lwspp
+{
+namespace cli
+{
+
+ClientRuntime::ClientRuntime(const ClientRuntimeContext& context)
+    : _lwsRuntime(std::make_shared<LwsClientRuntime>(context))
+{
+    const std::weak_ptr<LwsClientRuntime> weakLwsRuntime = _lwsRuntime;
+
+    auto asyncStartService = [weakLwsRuntime]
+    {
+        if (auto lwsRuntime = weakLwsRuntime.lock())
+        {
+            lwsRuntime->startService();
+        }
+    };
+
+    _runtimeStop = std::async(std::launch::async, asyncStartService);
+}
+
+ClientRuntime::~ClientRuntime()
+{
+    _lwsRuntime->stopService();
+    _runtimeStop.wait();
+}
+
+auto ClientRuntime::getLwsRuntime() const -> const LwsClientRuntimePtr&
+{
+    return _lwsRuntime;
+}
+
+} // namespace cli
+} // namespace lwspp
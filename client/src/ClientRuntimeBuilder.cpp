@@ -0,0 +1,191 @@
+/*
+ * lwspp - C++ wrapper for the libwebsockets library
+ *
+ * Copyright (C) 2023 - 2023 Volodymyr Lotoshko <vlotoshko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <stdexcept>
+
+#include "ClientRuntime.hpp"
+#include "ClientRuntimeContext.hpp"
+#include "CompressionSettings.hpp"
+#include "SslSettings.hpp" // IWYU pragma: keep
+#include "lwspp/client/ClientRuntimeBuilder.hpp"
+
+namespace lwspp
+{
+namespace cli
+{
+
+namespace
+{
+
+class UndefinedRequiredParameterException : public std::runtime_error
+{
+public:
+    explicit UndefinedRequiredParameterException(const std::string& parameter)
+        : std::runtime_error("Required parameter is undefined: " + parameter)
+    {}
+};
+
+class InvalidParameterException : public std::runtime_error
+{
+public:
+    explicit InvalidParameterException(const std::string& parameter)
+        : std::runtime_error("Invalid parameter value: " + parameter)
+    {}
+};
+
+void checkContext(const ClientRuntimeContext& context)
+{
+    if (context.serviceThreads == 0)
+    {
+        throw InvalidParameterException{"service threads"};
+    }
+
+    if (context.ssl != nullptr &&
+        context.ssl->privateKeyPath != UNDEFINED_FILE_PATH &&
+        context.ssl->certPath == UNDEFINED_FILE_PATH)
+    {
+        throw UndefinedRequiredParameterException{"ssl certificate path"};
+    }
+
+    if (context.keepAliveTimeout != UNDEFINED_UNSET)
+    {
+        if (context.keepAliveProbes == UNDEFINED_UNSET)
+        {
+            throw UndefinedRequiredParameterException{"keep alive probes"};
+        }
+
+        if (context.keepAliveProbesInterval == UNDEFINED_UNSET)
+        {
+            throw UndefinedRequiredParameterException{"keep alive probes interval"};
+        }
+    }
+
+    if (context.compression != nullptr)
+    {
+        if (context.compression->compressionLevel < MIN_COMPRESSION_LEVEL ||
+            context.compression->compressionLevel > MAX_COMPRESSION_LEVEL)
+        {
+            throw InvalidParameterException{"compression level"};
+        }
+
+        if (context.compression->windowBits < MIN_COMPRESSION_WINDOW_BITS ||
+            context.compression->windowBits > MAX_COMPRESSION_WINDOW_BITS)
+        {
+            throw InvalidParameterException{"compression window bits"};
+        }
+
+        if (context.compression->memoryLevel < MIN_COMPRESSION_MEMORY_LEVEL ||
+            context.compression->memoryLevel > MAX_COMPRESSION_MEMORY_LEVEL)
+        {
+            throw InvalidParameterException{"compression memory level"};
+        }
+    }
+}
+
+} // namespace
+
+
+ClientRuntimeBuilder::ClientRuntimeBuilder() : _context(new ClientRuntimeContext{})
+{}
+
+ClientRuntimeBuilder::~ClientRuntimeBuilder() = default;
+
+ClientRuntimeBuilder::ClientRuntimeBuilder(ClientRuntimeBuilder&& that) noexcept
+    : _context(std::move(that._context))
+{}
+
+auto ClientRuntimeBuilder::operator=(ClientRuntimeBuilder&& that) noexcept
+    -> ClientRuntimeBuilder&
+{
+    if (this != &that)
+    {
+        _context = std::move(that._context);
+    }
+    return *this;
+}
+
+auto ClientRuntimeBuilder::build() const -> IClientRuntimePtr
+{
+    const auto& context = *_context;
+    checkContext(context);
+    return std::make_shared<ClientRuntime>(context);
+}
+
+auto ClientRuntimeBuilder::setServiceThreads(unsigned int threads) -> ClientRuntimeBuilder&
+{
+    _context->serviceThreads = threads;
+    return *this;
+}
+
+auto ClientRuntimeBuilder::setSslSettings(SslSettingsPtr ssl) -> ClientRuntimeBuilder&
+{
+    _context->ssl = std::move(ssl);
+    return *this;
+}
+
+auto ClientRuntimeBuilder::setCompression(CompressionSettingsPtr compression)
+    -> ClientRuntimeBuilder&
+{
+    _context->compression = std::move(compression);
+    return *this;
+}
+
+auto ClientRuntimeBuilder::setKeepAliveTimeout(int timeout) -> ClientRuntimeBuilder&
+{
+    _context->keepAliveTimeout = timeout;
+    return *this;
+}
+
+auto ClientRuntimeBuilder::setKeepAliveProbes(int probes) -> ClientRuntimeBuilder&
+{
+    _context->keepAliveProbes = probes;
+    return *this;
+}
+
+auto ClientRuntimeBuilder::setKeepAliveProbesInterval(int interval) -> ClientRuntimeBuilder&
+{
+    _context->keepAliveProbesInterval = interval;
+    return *this;
+}
+
+auto ClientRuntimeBuilder::setLwsLogLevel(int logLevel) -> ClientRuntimeBuilder&
+{
+    _context->lwsLogLevel = logLevel;
+    return *this;
+}
+
+auto ClientRuntimeBuilder::setRxBufferSize(size_t size) -> ClientRuntimeBuilder&
+{
+    _context->rxBufferSize = size;
+    return *this;
+}
+
+auto ClientRuntimeBuilder::setTxPacketSize(size_t size) -> ClientRuntimeBuilder&
+{
+    _context->txPacketSize = size;
+    return *this;
+}
+
+} // namespace cli
+} // namespace lwspp
@@ -0,0 +1,83 @@
+/*
+ * lwspp - C++ wrapper for the libwebsockets library
+ *
+ * Copyright (C) 2023 - 2023 Volodymyr Lotoshko <vlotoshko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "lwspp/client/CompressionSettingsBuilder.hpp"
+
+#include "CompressionSettings.hpp"
+
+namespace lwspp
+{
+namespace cli
+{
+
+CompressionSettingsBuilder::CompressionSettingsBuilder() : _settings(new CompressionSettings{})
+{}
+
+CompressionSettingsBuilder::~CompressionSettingsBuilder() = default;
+
+CompressionSettingsBuilder::CompressionSettingsBuilder(CompressionSettingsBuilder&& that) noexcept
+    : _settings(std::move(that._settings))
+{}
+
+auto CompressionSettingsBuilder::operator=(CompressionSettingsBuilder&& that) noexcept
+    -> CompressionSettingsBuilder&
+{
+    if (this != &that)
+    {
+        _settings = std::move(that._settings);
+    }
+    return *this;
+}
+
+auto CompressionSettingsBuilder::build() const -> CompressionSettingsPtr
+{
+    return std::make_shared<CompressionSettings>(*_settings);
+}
+
+auto CompressionSettingsBuilder::setCompressionLevel(int level) -> CompressionSettingsBuilder&
+{
+    _settings->compressionLevel = level;
+    return *this;
+}
+
+auto CompressionSettingsBuilder::setWindowBits(int windowBits) -> CompressionSettingsBuilder&
+{
+    _settings->windowBits = windowBits;
+    return *this;
+}
+
+auto CompressionSettingsBuilder::setMemoryLevel(int level) -> CompressionSettingsBuilder&
+{
+    _settings->memoryLevel = level;
+    return *this;
+}
+
+auto CompressionSettingsBuilder::disableContextTakeover() -> CompressionSettingsBuilder&
+{
+    _settings->noContextTakeover = true;
+    return *this;
+}
+
+} // namespace cli
+} // namespace lwspp
@@ -0,0 +1,79 @@
+/*
+ * lwspp - C++ wrapper for the libwebsockets library
+ *
+ * Copyright (C) 2023 - 2023 Volodymyr Lotoshko <vlotoshko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "ConnectionLogic.hpp"
+#include "lwspp/client/contract/IMultiClientLogic.hpp"
+
+namespace lwspp
+{
+namespace cli
+{
+
+ConnectionLogic::ConnectionLogic(contract::IMultiClientLogicPtr l, ConnectionId id)
+    : _multiClientLogic(std::move(l))
+    , _connectionId(id)
+{}
+
+void ConnectionLogic::onFirstDataPacket(size_t messageLength) noexcept
+{
+    _multiClientLogic->onFirstDataPacket(_connectionId, messageLength);
+}
+
+void ConnectionLogic::onBinaryDataReceive(const DataPacket& dataPacket) noexcept
+{
+    _multiClientLogic->onBinaryDataReceive(_connectionId, dataPacket);
+}
+
+void ConnectionLogic::onTextDataReceive(const DataPacket& dataPacket) noexcept
+{
+    _multiClientLogic->onTextDataReceive(_connectionId, dataPacket);
+}
+
+void ConnectionLogic::onConnect(IConnectionInfoPtr connectionInfo) noexcept
+{
+    _multiClientLogic->onConnect(_connectionId, std::move(connectionInfo));
+}
+
+void ConnectionLogic::onDisconnect() noexcept
+{
+    _multiClientLogic->onDisconnect(_connectionId);
+}
+
+void ConnectionLogic::onError(const std::string& errorMessage) noexcept
+{
+    _multiClientLogic->onError(_connectionId, errorMessage);
+}
+
+void ConnectionLogic::onWarning(const std::string& warningMessage) noexcept
+{
+    _multiClientLogic->onWarning(_connectionId, warningMessage);
+}
+
+void ConnectionLogic::onWatermark(Watermark watermark) noexcept
+{
+    _multiClientLogic->onWatermark(_connectionId, watermark);
+}
+
+} // namespace cli
+} // namespace lwspp
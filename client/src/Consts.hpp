@@ -40,8 +40,36 @@ const int UNDEFINED_UNSET = 0;
 
 const Path DEFAULT_URI_PATH = static_cast<Path>("");
 const std::string DEFAULT_PROTOCOL_NAME;
+// The id of the connection set by the address, port and path options
+const ConnectionId FIRST_CONNECTION_ID = 0;
 // 7 = LLL_ERR | LLL_WARN | LLL_NOTICE - default value for the libwebsockets 4.3.2
 const int DEFAULT_LWS_LOG_LEVEL = 7;
+const unsigned int DEFAULT_MAX_MESSAGES_PER_WRITE = 32;
+const size_t DEFAULT_MAX_BYTES_PER_WRITE = 64 * 1024;
+const size_t DEFAULT_MAX_FRAGMENT_SIZE = 0;
+const size_t DEFAULT_STREAM_CHUNK_SIZE = 64 * 1024;
+const size_t DEFAULT_MAX_MESSAGE_SIZE = 16 * 1024 * 1024;
+const SlowConsumerPolicy DEFAULT_SLOW_CONSUMER_POLICY = SlowConsumerPolicy::Reject;
+// The receive buffer of greater capacity is released after the message is delivered. The frame
+// length declared by the peer is also reserved in advance up to this size only
+const size_t MAX_RETAINED_RECEIVE_BUFFER = 1024 * 1024;
+
+// The permessage-deflate defaults of the libwebsockets
+const int DEFAULT_COMPRESSION_LEVEL = 1;
+const int DEFAULT_COMPRESSION_WINDOW_BITS = 15;
+const int DEFAULT_COMPRESSION_MEMORY_LEVEL = 8;
+const int MIN_COMPRESSION_LEVEL = 0;
+const int MAX_COMPRESSION_LEVEL = 9;
+// The 8 window bits are not supported by the deflate compressor
+const int MIN_COMPRESSION_WINDOW_BITS = 9;
+const int MAX_COMPRESSION_WINDOW_BITS = 15;
+const int MIN_COMPRESSION_MEMORY_LEVEL = 1;
+const int MAX_COMPRESSION_MEMORY_LEVEL = 9;
+const unsigned int DEFAULT_SERVICE_THREADS = 1;
+// The libwebsockets disables the Nagle's algorithm on its sockets
+const bool DEFAULT_TCP_NO_DELAY = true;
+// The longest wait of the external event loop, the lws timeouts are checked once a second
+const int MAX_EVENT_LOOP_TIMEOUT_MS = 1000;
 
 } // namespace cli
 } // namespace lwspp
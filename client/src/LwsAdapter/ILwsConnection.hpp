@@ -24,9 +24,11 @@
 
 #pragma once
 
-#include <queue>
+#include <chrono>
 #include <string>
+#include <vector>
 
+#include "lwspp/client/Types.hpp"
 #include "LwsAdapter/LwsTypes.hpp"
 #include "LwsAdapter/LwsTypesFwd.hpp"
 
@@ -52,10 +54,68 @@ public:
 
 public:
     virtual auto getLwsInstance() -> LwsInstanceRawPtr = 0;
+    virtual auto getLwsContext() -> LwsContextRawPtr = 0;
+    // Index of the service thread the connection belongs to
+    virtual auto getServiceThreadIndex() const -> int = 0;
 
-    virtual void addBinaryDataToSend(const std::vector<char>&) = 0;
-    virtual void addTextDataToSend(const std::string&) = 0;
-    virtual auto getPendingData() -> std::queue<Message>& = 0;
+    // Can be called from any thread. Wakes up the service thread of the connection only.
+    // Returns false if the connection is already closed
+    virtual auto wakeUpServiceThread() -> bool = 0;
+    // Service thread only. The connection is closed and its lws instance is about to be
+    // destroyed, so the other threads do not touch the instance anymore
+    virtual void detachLwsInstance() = 0;
+    virtual auto isLwsInstanceAttached() const -> bool = 0;
+
+    // Queues the message according to the queue limits, can be called from any thread
+    virtual auto addDataToSend(Message) -> EnqueueResult = 0;
+    // Service thread only. Returns the front message of the pending data or nullptr, the high
+    // priority lane is served first, see Priority
+    virtual auto frontPendingData() -> Message* = 0;
+    virtual auto hasPendingData() -> bool = 0;
+    // Service thread only. Pops the front message of the given size from the pending data.
+    // Returns true if the queue has drained below the low watermark after the high watermark
+    // has been reported, see takeHighWatermark.
+    virtual auto popPendingData(size_t messageSize) -> bool = 0;
+    // Service thread only. Drops the oldest messages exceeding the queue limits, see
+    // SlowConsumerPolicy::DropOldest. Returns true if the queue has drained below the low
+    // watermark after the high watermark has been reported.
+    virtual auto trimPendingData() -> bool = 0;
+    // Service thread only. Returns true once the queue has reached its limits, the crossing is
+    // recorded by addDataToSend. The low watermark is reported only after the high one.
+    virtual auto takeHighWatermark() -> bool = 0;
+    // The buffer for reassembling the received message, reused between messages
+    virtual auto getReceiveBuffer() -> std::vector<char>& = 0;
+
+    // Keeps the written message until the compressed output is drained, the libwebsockets may
+    // still take the output from the message data
+    virtual void keepWrittenMessage(Message) = 0;
+    virtual void releaseWrittenMessage() = 0;
+
+    virtual void addCompressionStats(size_t uncompressedBytes, size_t compressedBytes,
+                                     std::chrono::nanoseconds cpuTime) = 0;
+    virtual auto getCompressionStats() const -> CompressionStats = 0;
+
+    // Service thread only. The permessage-deflate extension has the compressed output of
+    // the written message not taken by the socket yet
+    virtual void setDeflatePending(bool) = 0;
+    virtual auto isDeflatePending() const -> bool = 0;
+
+    virtual void markToClose(CloseReason) = 0;
+    virtual auto getCloseReason() const -> CloseReason = 0;
+
+    // Marks that the connection waits for the writable callback request.
+    // Returns false if the connection was already marked
+    virtual auto markPendingWrite() -> bool = 0;
+    // Returns false if the connection was not marked
+    virtual auto clearPendingWrite() -> bool = 0;
+
+    // Can be called from any thread, the service thread pauses or resumes the reading itself.
+    // Return true if the reading should be paused or resumed, false if it is already done.
+    virtual auto pauseReceiving() -> bool = 0;
+    virtual auto resumeReceiving() -> bool = 0;
+    virtual auto isReceivingPaused() const -> bool = 0;
+    // Service thread only. Returns true if the reading was paused or resumed since the last call
+    virtual auto takeReceivingChange() -> bool = 0;
 };
 
 } // namespace cli
@@ -22,12 +22,25 @@
  * IN THE SOFTWARE.
  */
 
-#include "lwspp/client/contract/IClientLogic.hpp" // IWYU pragma: keep
+#include <algorithm>
+#include <array>
+#include <exception>
+#include <vector>
 
+#include "lwspp/client/contract/IClientLogic.hpp"    // IWYU pragma: keep
+#include "lwspp/client/contract/IEventLoop.hpp"      // IWYU pragma: keep
+#include "lwspp/client/contract/IStreamProducer.hpp" // IWYU pragma: keep
+
+#include "CompressionSettings.hpp"
 #include "ConnectionInfo.hpp"
+#include "Consts.hpp"
 #include "LwsAdapter/ILwsCallbackContext.hpp"
+#include "LwsAdapter/ILwsConnection.hpp"
 #include "LwsAdapter/LwsCallback.hpp"
+#include "LwsAdapter/LwsClientRuntime.hpp"
+#include "LwsAdapter/LwsCompression.hpp"
 #include "LwsAdapter/LwsConnection.hpp"
+#include "LwsAdapter/LwsSocket.hpp"
 
 namespace lwspp
 {
@@ -40,24 +53,332 @@ const int CLOSE_SESSION = -1;
 
 auto getCallbackContext(lws* wsInstance) -> ILwsCallbackContext&
 {
-    void* contextData = lws_context_user(lws_get_context(wsInstance));
+    // The clients sharing the runtime pass their callback context with the connection
+    void* contextData = lws_get_opaque_user_data(wsInstance);
+    if (contextData == nullptr)
+    {
+        contextData = lws_context_user(lws_get_context(wsInstance));
+    }
     return *(reinterpret_cast<ILwsCallbackContext *>(contextData));
 }
 
-auto sendMessage(lws* wsInstance, const Message& message) -> bool
+auto getClientRuntime(lws* wsInstance) -> LwsClientRuntime&
+{
+    void* contextData = lws_context_user(lws_get_context(wsInstance));
+    return *(reinterpret_cast<LwsClientRuntime *>(contextData));
+}
+
+auto runRuntimeClientCallback(
+        LwsCallback* callback,
+        lws* wsInstance,
+        lws_callback_reasons reason,
+        void* userData,
+        void* in,
+        size_t len)
+-> int
 {
-    // C-style cast to convert from const char* to unsigned char*
-    auto* messageBegin = (unsigned char*)(message.second.data() + LWS_PRE);
-    const int expectedSize = static_cast<int>(message.second.size() - LWS_PRE);
+    // The callbacks of the context have no client, they are run by the lwsRuntimeCallback
+    if (lws_get_opaque_user_data(wsInstance) == nullptr)
+    {
+        return 0;
+    }
 
-    auto writeProtocol = message.first == DataType::Text ? LWS_WRITE_TEXT : LWS_WRITE_BINARY;
+    const int result = callback(wsInstance, reason, userData, in, len);
+    if (reason == LWS_CALLBACK_WSI_DESTROY)
+    {
+        getClientRuntime(wsInstance).onInstanceDestroyed(wsInstance);
+    }
+    return result;
+}
+
+auto sendMessage(lws* wsInstance, Message& message) -> bool
+{
+    auto* messageBegin = message.payload.data();
+    const int expectedSize = static_cast<int>(message.payload.size());
+
+    auto writeProtocol = message.dataType == DataType::Text ? LWS_WRITE_TEXT : LWS_WRITE_BINARY;
     const int actualSize = lws_write(wsInstance, messageBegin, expectedSize, writeProtocol);
     return expectedSize == actualSize;
 }
 
+// Drains the compressed output left by the permessage-deflate extension. The libwebsockets takes
+// the output of the extension by the empty write, the opcode of the drained message is reused.
+auto flushDeflate(lws* wsInstance) -> bool
+{
+    std::array<unsigned char, LWS_PRE> buffer{};
+    return lws_write(wsInstance, buffer.data() + LWS_PRE, 0, LWS_WRITE_CONTINUATION) >= 0;
+}
+
+// Writes the next fragment of the message in place, lws_write writes the frame header over
+// the already written data in front of the fragment
+auto sendFragment(lws* wsInstance, Message& message, size_t fragmentSize) -> bool
+{
+    const size_t offset = message.writtenSize;
+    const bool isLast = offset + fragmentSize == message.payload.size();
+    message.writtenSize += fragmentSize;
+
+    int writeProtocol = message.dataType == DataType::Text ? LWS_WRITE_TEXT : LWS_WRITE_BINARY;
+    writeProtocol = offset == 0 ? writeProtocol : LWS_WRITE_CONTINUATION;
+    writeProtocol = isLast ? writeProtocol : writeProtocol | LWS_WRITE_NO_FIN;
+
+    const int expectedSize = static_cast<int>(fragmentSize);
+    const int actualSize = lws_write(wsInstance, message.payload.data() + offset, fragmentSize,
+                                     static_cast<lws_write_protocol>(writeProtocol));
+    return expectedSize == actualSize;
+}
+
+// Pulls the next chunk of the streamed message into the chunk buffer of the message
+auto produceStreamChunk(Message& message, size_t chunkSize) -> StreamChunk
+{
+    if (message.payload.size() != chunkSize)
+    {
+        message.payload = Payload(std::string(LWS_PRE + chunkSize, '\0'));
+    }
+
+    auto& payload = message.payload;
+    auto chunk = message.producer->produceChunk(reinterpret_cast<char*>(payload.data()),
+                                                payload.size());
+    chunk.size = std::min(chunk.size, payload.size());
+    return chunk;
+}
+
+// Writes the chunk as the fragment of the streamed message, the message is ended by the last one
+auto sendStreamChunk(lws* wsInstance, Message& message, const StreamChunk& chunk) -> bool
+{
+    const int opcode = message.isStreamStarted ? LWS_WRITE_CONTINUATION : LWS_WRITE_BINARY;
+    const int writeProtocol = chunk.isLast ? opcode : opcode | LWS_WRITE_NO_FIN;
+    message.isStreamStarted = true;
+
+    const int expectedSize = static_cast<int>(chunk.size);
+    const int actualSize = lws_write(wsInstance, message.payload.data(), chunk.size,
+                                     static_cast<lws_write_protocol>(writeProtocol));
+    return expectedSize == actualSize;
+}
+
+// Writes the pending messages while the socket can take more data and the write budget
+// is not exhausted. Returns false on the write error.
+auto sendPendingData(lws* wsInstance, ILwsConnection& connection,
+                     ILwsCallbackContext& callbackContext) -> bool
+{
+    if (connection.takeHighWatermark())
+    {
+        callbackContext.getClientLogic()->onWatermark(Watermark::High);
+    }
+
+    // The compressed output of the previous message is drained first, the message data is kept
+    // until then
+    if (connection.isDeflatePending())
+    {
+        if (!flushDeflate(wsInstance))
+        {
+            return false;
+        }
+        if (connection.isDeflatePending())
+        {
+            lws_callback_on_writable(wsInstance);
+            return true;
+        }
+    }
+    connection.releaseWrittenMessage();
+
+    const auto budget = callbackContext.getWriteBudget();
+    unsigned int messagesWritten = 0;
+    size_t bytesWritten = 0;
+
+    if (connection.trimPendingData())
+    {
+        callbackContext.getClientLogic()->onWatermark(Watermark::Low);
+    }
+    while (!callbackContext.isStopping())
+    {
+        auto* message = connection.frontPendingData();
+        if (message == nullptr)
+        {
+            return true;
+        }
+
+        if (message->producer != nullptr)
+        {
+            const auto chunk = produceStreamChunk(*message, callbackContext.getStreamChunkSize());
+            // The parked stream is not polled, the producer resumes it when the data arrives.
+            // NOTE: The writable request is made by the resume, so nothing else is requested here
+            if (!chunk.isReady || (chunk.size == 0 && !chunk.isLast))
+            {
+                return true;
+            }
+
+            if (!sendStreamChunk(wsInstance, *message, chunk))
+            {
+                return false;
+            }
+            bytesWritten += chunk.size;
+
+            // NOTE: The chunk buffer is reused by the next chunk, so the compressed output of
+            // the chunk should be drained on the next writable events first
+            if (chunk.isLast)
+            {
+                if (connection.isDeflatePending())
+                {
+                    connection.keepWrittenMessage(std::move(*message));
+                }
+                if (connection.popPendingData(0))
+                {
+                    callbackContext.getClientLogic()->onWatermark(Watermark::Low);
+                }
+            }
+
+            if (connection.isDeflatePending() ||
+                ++messagesWritten >= budget.maxMessages || bytesWritten >= budget.maxBytes ||
+                lws_send_pipe_choked(wsInstance) != 0)
+            {
+                break;
+            }
+            continue;
+        }
+
+        const size_t messageSize = message->payload.size();
+        const bool isFragmented = budget.maxFragmentSize != 0 &&
+                                  messageSize > budget.maxFragmentSize;
+        const size_t writeSize = isFragmented ?
+                                 std::min(budget.maxFragmentSize, messageSize - message->writtenSize) :
+                                 messageSize;
+        if (isFragmented)
+        {
+            if (!sendFragment(wsInstance, *message, writeSize))
+            {
+                return false;
+            }
+        }
+        else if (!sendMessage(wsInstance, *message))
+        {
+            return false;
+        }
+        bytesWritten += writeSize;
+
+        // NOTE: The compressed output not taken by the socket is drained on the next writable
+        // events, so the message data is kept until then and no other message is written
+        // in the meantime. The fragmented message stays in the queue until its last fragment
+        // is written.
+        const bool isDeflatePending = connection.isDeflatePending();
+        if (!isFragmented || message->writtenSize == messageSize)
+        {
+            if (isDeflatePending)
+            {
+                connection.keepWrittenMessage(std::move(*message));
+            }
+            if (connection.popPendingData(messageSize))
+            {
+                callbackContext.getClientLogic()->onWatermark(Watermark::Low);
+            }
+        }
+
+        if (isDeflatePending || ++messagesWritten >= budget.maxMessages ||
+            bytesWritten >= budget.maxBytes || lws_send_pipe_choked(wsInstance) != 0)
+        {
+            break;
+        }
+    }
+
+    if (!callbackContext.isStopping() &&
+        (connection.hasPendingData() || connection.isDeflatePending()))
+    {
+        lws_callback_on_writable(wsInstance);
+    }
+    return true;
+}
+
+// Checks the received fragment along with the remains of its frame against the message size
+// limit before anything is buffered
+auto isMessageTooLarge(lws* wsInstance, const std::vector<char>& buffer, size_t len,
+                       size_t maxMessageSize) -> bool
+{
+    const size_t received = lws_is_first_fragment(wsInstance) != 0 ? 0 : buffer.size();
+    const size_t remains = lws_remaining_packet_payload(wsInstance);
+    return len > maxMessageSize || remains > maxMessageSize - len ||
+           received > maxMessageSize - len - remains;
+}
+
+// Appends the received fragment to the receive buffer. Returns true if the message is complete.
+auto appendFragment(lws* wsInstance, std::vector<char>& buffer, const char* data, size_t len) -> bool
+{
+    if (lws_is_first_fragment(wsInstance) != 0)
+    {
+        buffer.clear();
+    }
+
+    // The frame length is known on its first fragment, so the single frame message
+    // is placed without reallocations. The length is declared by the peer, so it is trusted
+    // up to the retained buffer size only
+    const size_t remains = std::min(lws_remaining_packet_payload(wsInstance),
+                                    MAX_RETAINED_RECEIVE_BUFFER);
+    const size_t required = buffer.size() + len + remains;
+    if (buffer.capacity() < required)
+    {
+        buffer.reserve(buffer.empty() ? required : std::max(required, buffer.capacity() * 2));
+    }
+    buffer.insert(buffer.end(), data, data + len);
+
+    return lws_is_final_fragment(wsInstance) != 0;
+}
+
+void resetReceiveBuffer(std::vector<char>& buffer)
+{
+    if (buffer.capacity() > MAX_RETAINED_RECEIVE_BUFFER)
+    {
+        std::vector<char>{}.swap(buffer);
+    }
+    else
+    {
+        buffer.clear();
+    }
+}
+
 } // namespace
 
-auto lwsCallback_v1(
+void servicePendingRequests(ILwsCallbackContext& callbackContext)
+{
+    auto connection = callbackContext.getConnection();
+    if (connection == nullptr)
+    {
+        return;
+    }
+
+    auto* connectionInstance = connection->getLwsInstance();
+    if (connection->takeReceivingChange())
+    {
+        lws_rx_flow_control(connectionInstance, connection->isReceivingPaused() ? 0 : 1);
+    }
+
+    if (!connection->clearPendingWrite())
+    {
+        return;
+    }
+
+    // NOTE: The stalled server never makes the connection writable, so the slow consumer
+    // is closed, the watermarks are reported and the oldest messages are dropped right here
+    if (connection->getCloseReason() == CloseReason::SlowConsumer)
+    {
+        lws_close_reason(connectionInstance, LWS_CLOSE_STATUS_POLICY_VIOLATION, nullptr, 0);
+        lws_set_timeout(connectionInstance, PENDING_TIMEOUT_CLOSE_SEND, LWS_TO_KILL_ASYNC);
+    }
+    else
+    {
+        if (connection->takeHighWatermark())
+        {
+            callbackContext.getClientLogic()->onWatermark(Watermark::High);
+        }
+        if (connection->trimPendingData())
+        {
+            callbackContext.getClientLogic()->onWatermark(Watermark::Low);
+        }
+        lws_callback_on_writable(connectionInstance);
+    }
+}
+
+namespace
+{
+
+auto handleCallback_v1(
         lws* wsInstance,
         lws_callback_reasons reason,
         void* /*userData*/,
@@ -80,9 +401,24 @@ auto lwsCallback_v1(
         clientLogic->onError(errorMessage);
         break;
     }
+    case LWS_CALLBACK_CONNECTING:
+    {
+        // The socket is created but not connected yet, the descriptor is passed in the 'in'
+        const auto socketFd = static_cast<int>(reinterpret_cast<lws_intptr_t>(in));
+        if (!setupConnectionSocket(socketFd, callbackContext.getSocketSettings()))
+        {
+            clientLogic->onWarning("Failed to apply the socket settings");
+        }
+        break;
+    }
     case LWS_CALLBACK_CLIENT_ESTABLISHED:
     {
-        callbackContext.setConnection(std::make_shared<LwsConnection>(wsInstance));
+        const auto queueLimits = callbackContext.getQueueLimits();
+        callbackContext.setConnection(std::make_shared<LwsConnection>(wsInstance, queueLimits));
+        if (const auto& compression = callbackContext.getCompressionSettings())
+        {
+            setupCompression(wsInstance, *compression);
+        }
         clientLogic->onConnect(std::make_shared<ConnectionInfo>());
         break;
     }
@@ -90,22 +426,14 @@ auto lwsCallback_v1(
     {
         if (auto connection = callbackContext.getConnection())
         {
-            auto& messages = connection->getPendingData();
-            if (!messages.empty() && !callbackContext.isStopping())
+            if (connection->getCloseReason() == CloseReason::SlowConsumer)
             {
-                auto& message = messages.front();
-                if (sendMessage(wsInstance, message))
-                {
-                    messages.pop();
-                    if (!messages.empty())
-                    {
-                        lws_callback_on_writable(wsInstance);
-                    }
-                }
-                else
-                {
-                    clientLogic->onError("Error writing data to socket");
-                }
+                lws_close_reason(wsInstance, LWS_CLOSE_STATUS_POLICY_VIOLATION, nullptr, 0);
+                return CLOSE_SESSION;
+            }
+            if (!sendPendingData(wsInstance, *connection, callbackContext))
+            {
+                clientLogic->onError("Error writing data to socket");
             }
         }
         else
@@ -137,8 +465,37 @@ auto lwsCallback_v1(
         }
         break;
     }
+    case LWS_CALLBACK_EVENT_WAIT_CANCELLED:
+    {
+        // The service thread is woken up by the lws_cancel_service, see LwsClientControl
+        servicePendingRequests(callbackContext);
+        break;
+    }
+    case LWS_CALLBACK_ADD_POLL_FD:
+    case LWS_CALLBACK_CHANGE_MODE_POLL_FD:
+    {
+        if (const auto& eventLoop = callbackContext.getEventLoop())
+        {
+            const auto* pollArgs = reinterpret_cast<const lws_pollargs*>(in);
+            eventLoop->watchFd(pollArgs->fd, static_cast<short>(pollArgs->events));
+        }
+        break;
+    }
+    case LWS_CALLBACK_DEL_POLL_FD:
+    {
+        if (const auto& eventLoop = callbackContext.getEventLoop())
+        {
+            const auto* pollArgs = reinterpret_cast<const lws_pollargs*>(in);
+            eventLoop->unwatchFd(pollArgs->fd);
+        }
+        break;
+    }
     case LWS_CALLBACK_CLIENT_CLOSED:
     {
+        if (auto connection = callbackContext.getConnection())
+        {
+            connection->detachLwsInstance();
+        }
         callbackContext.resetConnection();
         clientLogic->onDisconnect();
         break;
@@ -150,5 +507,173 @@ auto lwsCallback_v1(
     return 0;
 }
 
+auto handleCallback_v2(
+        lws* wsInstance,
+        lws_callback_reasons reason,
+        void* userData,
+        void* in/*pointer*/,
+        size_t len/*length*/)
+-> int
+{
+    if (reason != LWS_CALLBACK_CLIENT_RECEIVE)
+    {
+        return handleCallback_v1(wsInstance, reason, userData, in, len);
+    }
+
+    auto& callbackContext = getCallbackContext(wsInstance);
+    auto connection = callbackContext.getConnection();
+    if (connection == nullptr)
+    {
+        return handleCallback_v1(wsInstance, reason, userData, in, len);
+    }
+
+    auto clientLogic = callbackContext.getClientLogic();
+    if (lws_is_first_fragment(wsInstance) != 0)
+    {
+        clientLogic->onFirstDataPacket(len + lws_remaining_packet_payload(wsInstance));
+    }
+
+    auto& buffer = connection->getReceiveBuffer();
+    if (isMessageTooLarge(wsInstance, buffer, len, callbackContext.getMaxMessageSize()))
+    {
+        std::vector<char>{}.swap(buffer);
+        clientLogic->onError("The received message exceeds the max message size");
+        lws_close_reason(wsInstance, LWS_CLOSE_STATUS_MESSAGE_TOO_LARGE, nullptr, 0);
+        return CLOSE_SESSION;
+    }
+
+    if (!appendFragment(wsInstance, buffer, reinterpret_cast<const char *>(in), len))
+    {
+        return 0;
+    }
+
+    const DataPacket dataPacket{buffer.data(), buffer.size(), 0};
+    if (lws_frame_is_binary(wsInstance) == 1)
+    {
+        clientLogic->onBinaryDataReceive(dataPacket);
+    }
+    else
+    {
+        clientLogic->onTextDataReceive(dataPacket);
+    }
+
+    resetReceiveBuffer(buffer);
+    return 0;
+}
+
+auto handleRuntimeCallback(
+        lws* wsInstance,
+        lws_callback_reasons reason,
+        void* /*userData*/,
+        void* /*in*/,
+        size_t /*len*/)
+-> int
+{
+    switch(reason)
+    {
+    case LWS_CALLBACK_EVENT_WAIT_CANCELLED:
+    {
+        // The service thread is woken up by the lws_cancel_service(_pt), see LwsClientRuntime
+        getClientRuntime(wsInstance).serviceClients(lws_get_tsi(wsInstance));
+        break;
+    }
+    case LWS_CALLBACK_WSI_DESTROY:
+    {
+        // The connection failed before it was bound to the client protocol
+        if (lws_get_opaque_user_data(wsInstance) != nullptr)
+        {
+            getClientRuntime(wsInstance).onInstanceDestroyed(wsInstance);
+        }
+        break;
+    }
+    default:
+        break;
+    }
+    return 0;
+}
+
+// The exceptions must not pass through the C code of the libwebsockets, so the connection
+// whose callback failed is closed instead
+auto runCallback(
+        LwsCallback* callback,
+        lws* wsInstance,
+        lws_callback_reasons reason,
+        void* userData,
+        void* in,
+        size_t len)
+-> int
+{
+    try
+    {
+        return callback(wsInstance, reason, userData, in, len);
+    }
+    catch (const std::exception& e)
+    {
+        lwsl_err("lwspp: the callback reason %d failed: %s\n", static_cast<int>(reason), e.what());
+    }
+    catch (...)
+    {
+        lwsl_err("lwspp: the callback reason %d failed\n", static_cast<int>(reason));
+    }
+    return CLOSE_SESSION;
+}
+
+} // namespace
+
+auto lwsCallback_v1(
+        lws* wsInstance,
+        lws_callback_reasons reason,
+        void* userData,
+        void* in/*pointer*/,
+        size_t len/*length*/)
+-> int
+{
+    return runCallback(handleCallback_v1, wsInstance, reason, userData, in, len);
+}
+
+auto lwsCallback_v2(
+        lws* wsInstance,
+        lws_callback_reasons reason,
+        void* userData,
+        void* in/*pointer*/,
+        size_t len/*length*/)
+-> int
+{
+    return runCallback(handleCallback_v2, wsInstance, reason, userData, in, len);
+}
+
+auto lwsRuntimeCallback(
+        lws* wsInstance,
+        lws_callback_reasons reason,
+        void* userData,
+        void* in/*pointer*/,
+        size_t len/*length*/)
+-> int
+{
+    return runCallback(handleRuntimeCallback, wsInstance, reason, userData, in, len);
+}
+
+auto lwsRuntimeCallback_v1(
+        lws* wsInstance,
+        lws_callback_reasons reason,
+        void* userData,
+        void* in/*pointer*/,
+        size_t len/*length*/)
+-> int
+{
+    return runRuntimeClientCallback(lwsCallback_v1, wsInstance, reason, userData, in, len);
+}
+
+auto lwsRuntimeCallback_v2(
+        lws* wsInstance,
+        lws_callback_reasons reason,
+        void* userData,
+        void* in/*pointer*/,
+        size_t len/*length*/)
+-> int
+{
+    return runRuntimeClientCallback(lwsCallback_v2, wsInstance, reason, userData, in, len);
+}
+
 } // namespace cli
 } // namespace lwspp
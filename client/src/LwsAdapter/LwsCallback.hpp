@@ -26,6 +26,8 @@
 
 #include <libwebsockets.h>
 
+#include "LwsAdapter/LwsTypesFwd.hpp"
+
 namespace lwspp
 {
 namespace cli
@@ -50,5 +52,57 @@ auto lwsCallback_v1(
         size_t len)
 -> int;
 
+/**
+ * @brief lwsCallback_v2 is the LwsCallback function that reassembles the received fragments
+ * into the reusable per-connection buffer and delivers each message once and whole. The other
+ * reasons are handled by the lwsCallback_v1.
+ */
+auto lwsCallback_v2(
+        lws *wsi,
+        lws_callback_reasons reason,
+        void* userData,
+        void* in,
+        size_t len)
+-> int;
+
+/**
+ * @brief lwsRuntimeCallback is the LwsCallback function of the context shared by the clients, see
+ * LwsClientRuntime. It services the requests of the clients made from the other threads.
+ */
+auto lwsRuntimeCallback(
+        lws *wsi,
+        lws_callback_reasons reason,
+        void* userData,
+        void* in,
+        size_t len)
+-> int;
+
+/**
+ * @brief lwsRuntimeCallback_v1 and lwsRuntimeCallback_v2 run the lwsCallback_v1 and lwsCallback_v2
+ * for the connections of the clients sharing the context, see LwsClientRuntime.
+ */
+auto lwsRuntimeCallback_v1(
+        lws *wsi,
+        lws_callback_reasons reason,
+        void* userData,
+        void* in,
+        size_t len)
+-> int;
+
+auto lwsRuntimeCallback_v2(
+        lws *wsi,
+        lws_callback_reasons reason,
+        void* userData,
+        void* in,
+        size_t len)
+-> int;
+
+/**
+ * @brief servicePendingRequests applies the requests made by the client control from the other
+ * threads: requests the writable callback for the queued data, closes the slow consumer and
+ * pauses or resumes the receiving. Must be called on the service thread only.
+ */
+void servicePendingRequests(ILwsCallbackContext&);
+
 } // namespace cli
 } // namespace lwspp
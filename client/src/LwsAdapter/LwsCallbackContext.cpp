@@ -32,9 +32,20 @@ namespace lwspp
 namespace cli
 {
 
-LwsCallbackContext::LwsCallbackContext(contract::IClientLogicPtr e, LwsClientControlPtr a)
-    : _clientLogic(std::move(e))
+LwsCallbackContext::LwsCallbackContext(ConnectionId i, contract::IClientLogicPtr e,
+                                       LwsClientControlPtr a, WriteBudget b, QueueLimits q,
+                                       size_t z, size_t m, CompressionSettingsPtr c,
+                                       SocketSettings o, contract::IEventLoopPtr l)
+    : _connectionId(i)
+    , _clientLogic(std::move(e))
     , _clientControl(std::move(a))
+    , _writeBudget(b)
+    , _queueLimits(q)
+    , _streamChunkSize(z)
+    , _maxMessageSize(m)
+    , _compression(std::move(c))
+    , _socketSettings(o)
+    , _eventLoop(std::move(l))
 {}
 
 void LwsCallbackContext::setStopping()
@@ -47,6 +58,41 @@ auto LwsCallbackContext::isStopping() const -> bool
     return _isStopping;
 }
 
+auto LwsCallbackContext::getWriteBudget() const -> WriteBudget
+{
+    return _writeBudget;
+}
+
+auto LwsCallbackContext::getQueueLimits() const -> QueueLimits
+{
+    return _queueLimits;
+}
+
+auto LwsCallbackContext::getStreamChunkSize() const -> size_t
+{
+    return _streamChunkSize;
+}
+
+auto LwsCallbackContext::getMaxMessageSize() const -> size_t
+{
+    return _maxMessageSize;
+}
+
+auto LwsCallbackContext::getCompressionSettings() const -> const CompressionSettingsPtr&
+{
+    return _compression;
+}
+
+auto LwsCallbackContext::getSocketSettings() const -> const SocketSettings&
+{
+    return _socketSettings;
+}
+
+auto LwsCallbackContext::getEventLoop() const -> const contract::IEventLoopPtr&
+{
+    return _eventLoop;
+}
+
 auto LwsCallbackContext::getClientLogic() -> contract::IClientLogicPtr
 {
     return _clientLogic;
@@ -64,7 +110,7 @@ void LwsCallbackContext::setConnection(ILwsConnectionPtr s)
         throw std::runtime_error{"unaintialized lws connection found"};
     }
     _connection = std::move(s);
-    _clientControl->setConnection(_connection);
+    _clientControl->setConnection(_connectionId, _connection);
 }
 
 void LwsCallbackContext::resetConnection()
@@ -34,10 +34,19 @@ namespace cli
 class LwsCallbackContext : public ILwsCallbackContext
 {
 public:
-    LwsCallbackContext(contract::IClientLogicPtr, LwsClientControlPtr);
+    LwsCallbackContext(ConnectionId, contract::IClientLogicPtr, LwsClientControlPtr, WriteBudget,
+                       QueueLimits, size_t streamChunkSize, size_t maxMessageSize,
+                       CompressionSettingsPtr, SocketSettings, contract::IEventLoopPtr);
 
     void setStopping() override;
     auto isStopping() const -> bool override;
+    auto getWriteBudget() const -> WriteBudget override;
+    auto getQueueLimits() const -> QueueLimits override;
+    auto getStreamChunkSize() const -> size_t override;
+    auto getMaxMessageSize() const -> size_t override;
+    auto getCompressionSettings() const -> const CompressionSettingsPtr& override;
+    auto getSocketSettings() const -> const SocketSettings& override;
+    auto getEventLoop() const -> const contract::IEventLoopPtr& override;
     
     auto getConnection() -> ILwsConnectionPtr override;
     void setConnection(ILwsConnectionPtr) override;
@@ -46,9 +55,17 @@ public:
     auto getClientLogic() -> contract::IClientLogicPtr override;
 
 private:
+    ConnectionId _connectionId;
     contract::IClientLogicPtr _clientLogic;
     ILwsConnectionPtr _connection;
     LwsClientControlPtr _clientControl;
+    WriteBudget _writeBudget;
+    QueueLimits _queueLimits;
+    size_t _streamChunkSize;
+    size_t _maxMessageSize;
+    CompressionSettingsPtr _compression;
+    SocketSettings _socketSettings;
+    contract::IEventLoopPtr _eventLoop;
 
     bool _isStopping = false;
 };
@@ -26,13 +26,21 @@
 #include <stdexcept>
 
 #include "lwspp/client/contract/IClientControlAcceptor.hpp" // IWYU pragma: keep
+#include "lwspp/client/contract/IEventLoop.hpp"              // IWYU pragma: keep
 
 #include "ClientContext.hpp"
+#include "ClientRuntime.hpp"
+#include "ClientRuntimeContext.hpp"
+#include "ConnectionLogic.hpp"
+#include "LwsAdapter/LwsCallback.hpp"
 #include "LwsAdapter/LwsCallbackContext.hpp"
 #include "LwsAdapter/LwsClient.hpp"
 #include "LwsAdapter/LwsClientControl.hpp"
+#include "LwsAdapter/LwsClientRuntime.hpp"
 #include "LwsAdapter/LwsContextDeleter.hpp"
+#include "LwsAdapter/LwsContextSetup.hpp"
 #include "LwsAdapter/LwsDataHolder.hpp"
+#include "LwsAdapter/LwsProtocolsFactory.hpp"
 #include "SslSettings.hpp" // IWYU pragma: keep
 
 namespace lwspp
@@ -42,46 +50,6 @@ namespace cli
 namespace
 {
 
-void setupSslSettings(lws_context_creation_info& lwsContextInfo, const SslSettingsPtr& ssl)
-{
-    if (ssl != nullptr)
-    {
-        const auto options = static_cast<uint64_t>(LWS_SERVER_OPTION_DO_SSL_GLOBAL_INIT);
-
-        if (ssl->privateKeyPath != UNDEFINED_FILE_PATH)
-        {
-            lwsContextInfo.client_ssl_private_key_filepath = ssl->privateKeyPath.c_str();
-        }
-
-        if (ssl->certPath != UNDEFINED_FILE_PATH)
-        {
-            lwsContextInfo.client_ssl_cert_filepath = ssl->certPath.c_str();
-        }
-
-        if (ssl->caCertPath != UNDEFINED_FILE_PATH)
-        {
-            lwsContextInfo.client_ssl_ca_filepath = ssl->caCertPath.c_str();
-        }
-
-        if (!ssl->privateKeyPassword.empty())
-        {
-            lwsContextInfo.client_ssl_private_key_password= ssl->privateKeyPassword.c_str();
-        }
-
-        if (!ssl->ciphersList.empty())
-        {
-            lwsContextInfo.ssl_cipher_list = ssl->ciphersList.c_str();
-        }
-
-        if (!ssl->ciphersListTls13.empty())
-        {
-            lwsContextInfo.tls1_3_plus_cipher_list = ssl->ciphersListTls13.c_str();
-        }
-
-        lwsContextInfo.options = lwsContextInfo.options | options;
-    }
-}
-
 auto setupSslConnectionFlags(const SslSettingsPtr& ssl) -> int
 {
     int sslConnectionFlags = 0;
@@ -113,18 +81,106 @@ auto setupSslConnectionFlags(const SslSettingsPtr& ssl) -> int
     return sslConnectionFlags;
 }
 
+// The poll callbacks passing the socket to the external event loop are emitted only by
+// the libwebsockets built with the LWS_WITH_EXTERNAL_POLL option
+void checkEventLoopSupport(const contract::IEventLoopPtr& eventLoop)
+{
+#if !defined(LWS_WITH_EXTERNAL_POLL)
+    if (eventLoop != nullptr)
+    {
+        throw std::runtime_error{
+            "the external event loop requires the libwebsockets built with LWS_WITH_EXTERNAL_POLL"};
+    }
+#else
+    static_cast<void>(eventLoop);
+#endif
+}
+
+// The connections of the client share the context of the runtime. The client with several
+// connections creates the private runtime serviced by a single thread, unless it is given
+// the runtime to share.
+auto setupRuntime(const ClientContext& context) -> ClientRuntimePtr
+{
+    if (context.runtime != nullptr)
+    {
+        return std::static_pointer_cast<ClientRuntime>(context.runtime);
+    }
+
+    if (context.connections.empty())
+    {
+        return nullptr;
+    }
+
+    auto runtimeContext = ClientRuntimeContext{};
+    runtimeContext.keepAliveTimeout = context.keepAliveTimeout;
+    runtimeContext.keepAliveProbes = context.keepAliveProbes;
+    runtimeContext.keepAliveProbesInterval = context.keepAliveProbesInterval;
+    runtimeContext.lwsLogLevel = context.lwsLogLevel;
+    runtimeContext.rxBufferSize = context.rxBufferSize;
+    runtimeContext.txPacketSize = context.txPacketSize;
+    runtimeContext.ssl = context.ssl;
+    runtimeContext.compression = context.compression;
+    return std::make_shared<ClientRuntime>(runtimeContext);
+}
+
+// Returns the client logic of every connection by the connection id
+auto createClientLogics(const ClientContext& context) -> std::vector<contract::IClientLogicPtr>
+{
+    if (context.multiClientLogic == nullptr)
+    {
+        return {context.clientLogic};
+    }
+
+    std::vector<contract::IClientLogicPtr> clientLogics;
+    for (ConnectionId connectionId = 0; connectionId <= context.connections.size(); ++connectionId)
+    {
+        clientLogics.push_back(
+            std::make_shared<ConnectionLogic>(context.multiClientLogic, connectionId));
+    }
+    return clientLogics;
+}
+
 } // namespace
 
 LwsClient::LwsClient(const ClientContext& context)
-    : _lwsConnectionInfo()
+    : _dataHolder(std::make_shared<LwsDataHolder>(context))
+    , _eventLoop(context.eventLoop)
+    , _runtime(setupRuntime(context))
 {
-    auto clientControl = std::make_shared<LwsClientControl>();
+    checkEventLoopSupport(context.eventLoop);
+
+    const auto lwsRuntime = _runtime != nullptr ? _runtime->getLwsRuntime() : LwsClientRuntimePtr{};
+    const auto clientLogics = createClientLogics(context);
+    auto clientControl = std::make_shared<LwsClientControl>(clientLogics.size(), _eventLoop,
+                                                            lwsRuntime);
     context.clientControlAcceptor->acceptClientControl(clientControl);
 
-    _callbackContext = std::make_shared<LwsCallbackContext>(context.clientLogic, clientControl);
-    _dataHolder = std::make_shared<LwsDataHolder>(context);
+    const auto writeBudget = WriteBudget{context.maxMessagesPerWrite, context.maxBytesPerWrite,
+                                         context.maxFragmentSize};
+    const auto socketSettings = SocketSettings{context.socketSendBufferSize,
+                                               context.socketReceiveBufferSize,
+                                               context.tcpNoDelay};
+    const auto queueLimits = QueueLimits{context.maxQueuedMessages, context.maxQueuedBytes,
+                                         context.slowConsumerPolicy};
+    // The extensions are negotiated by the shared context, so the runtime compression applies
+    const auto& compression = lwsRuntime != nullptr ? lwsRuntime->getCompressionSettings()
+                                                    : context.compression;
+
+    // NOTE: The connect info refers to the instance pointer of its connection, so the connections
+    // are not reallocated after this point
+    _connections.resize(clientLogics.size());
+    for (ConnectionId connectionId = 0; connectionId < _connections.size(); ++connectionId)
+    {
+        _connections[connectionId].callbackContext = std::make_shared<LwsCallbackContext>(
+            connectionId, clientLogics[connectionId], clientControl, writeBudget, queueLimits,
+            context.streamChunkSize, context.maxMessageSize, compression, socketSettings,
+            _eventLoop);
+    }
 
-    setupLowLevelContext_();
+    if (_runtime == nullptr)
+    {
+        setupLowLevelContext_();
+    }
     setupConnectionInfo_();
 }
 
@@ -140,7 +196,20 @@ void LwsClient::connect()
         const std::lock_guard<std::mutex> guard(_mutex);
         if (_state == State::Initial)
         {
-            _wsInstance = lws_client_connect_via_info(&_lwsConnectionInfo);
+            if (_runtime != nullptr)
+            {
+                // The connections are made by the service threads of the runtime
+                for (auto& connection : _connections)
+                {
+                    _runtime->getLwsRuntime()->addClient(connection.callbackContext.get(),
+                                                         &connection.connectInfo);
+                }
+            }
+            else
+            {
+                auto& connection = _connections.front();
+                connection.wsInstance = lws_client_connect_via_info(&connection.connectInfo);
+            }
            _state = State::Started;
         }
         else
@@ -149,6 +218,12 @@ void LwsClient::connect()
         }
     }
 
+    // The external event loop or the runtime services the connection on its own thread
+    if (_eventLoop != nullptr || _runtime != nullptr)
+    {
+        return;
+    }
+
     int res = 0;
     while (res >= 0 && _state != State::Stopping)
     {
@@ -167,29 +242,97 @@ void LwsClient::connect()
 
 void LwsClient::disconnect()
 {
-    const std::lock_guard<std::mutex> guard(_mutex);
+    std::unique_lock<std::mutex> guard(_mutex);
     if (_state == State::Initial)
     {
         _state = State::Stopped;
     }
     else if (_state == State::Started)
     {
-        _state = State::Stopping;
-        _callbackContext->setStopping();
-        lws_cancel_service(_lowLevelContext.get());
+        std::vector<ILwsCallbackContext*> callbackContexts;
+        for (auto& connection : _connections)
+        {
+            connection.callbackContext->setStopping();
+            callbackContexts.push_back(connection.callbackContext.get());
+        }
+
+        if (_runtime != nullptr)
+        {
+            // Waits until the connections are closed by the service threads of the runtime, the
+            // lock is released since the callbacks of the client may be running meanwhile
+            _state = State::Stopping;
+            guard.unlock();
+            _runtime->getLwsRuntime()->removeClients(callbackContexts);
+            guard.lock();
+            _state = State::Stopped;
+            _isStoppedCV.notify_one();
+        }
+        else if (_eventLoop != nullptr)
+        {
+            // There is no service loop to wait for
+            _state = State::Stopped;
+        }
+        else
+        {
+            _state = State::Stopping;
+            lws_cancel_service(_lowLevelContext.get());
+        }
     }
 }
 
+void LwsClient::serviceFd(int fd, short revents)
+{
+    // The runtime services the client on its own threads
+    if (_runtime != nullptr)
+    {
+        return;
+    }
+
+    auto pollFd = lws_pollfd{};
+    pollFd.fd = fd;
+    pollFd.events = revents;
+    pollFd.revents = revents;
+
+    const int res = lws_service_fd(_lowLevelContext.get(), &pollFd);
+    if (res < 0)
+    {
+        throw std::runtime_error{
+            std::string{"lws_service_fd failed with the error code: "}.append(std::to_string(res))};
+    }
+}
+
+auto LwsClient::service() -> int
+{
+    if (_runtime != nullptr)
+    {
+        return MAX_EVENT_LOOP_TIMEOUT_MS;
+    }
+
+    // Does the work of the LWS_CALLBACK_EVENT_WAIT_CANCELLED, since the external event loop is
+    // woken up instead of the libwebsockets one
+    servicePendingRequests(*_connections.front().callbackContext);
+
+    // The null descriptor services the timeouts and the buffered data only
+    lws_service_fd(_lowLevelContext.get(), nullptr);
+    return lws_service_adjust_timeout(_lowLevelContext.get(), MAX_EVENT_LOOP_TIMEOUT_MS, 0);
+}
+
 void LwsClient::setupLowLevelContext_()
 {
     auto lwsContextInfo = lws_context_creation_info{};
     lwsContextInfo.protocols = _dataHolder->protocols.data();
-    lwsContextInfo.user = _callbackContext.get();
+    // The only connection of the client owning the context
+    lwsContextInfo.user = _connections.front().callbackContext.get();
     lwsContextInfo.port = CONTEXT_PORT_NO_LISTEN;
     lwsContextInfo.ka_time = _dataHolder->keepAliveTimeout;
     lwsContextInfo.ka_interval = _dataHolder->keepAliveProbesInterval;
     lwsContextInfo.ka_probes = _dataHolder->keepAliveProbes;
 
+    if (!_dataHolder->extensions.empty())
+    {
+        lwsContextInfo.extensions = _dataHolder->extensions.data();
+    }
+
     if (_dataHolder->lwsLogLevel != DEFAULT_LWS_LOG_LEVEL)
     {
         lws_set_log_level(_dataHolder->lwsLogLevel, nullptr);
@@ -206,19 +349,40 @@ void LwsClient::setupLowLevelContext_()
 
 void LwsClient::setupConnectionInfo_()
 {
-    _lwsConnectionInfo.context = _lowLevelContext.get();
-    _lwsConnectionInfo.pwsi = &_wsInstance;
-
-    _lwsConnectionInfo.address = _dataHolder->address.c_str();
-    _lwsConnectionInfo.port = _dataHolder->port;
-    _lwsConnectionInfo.path = _dataHolder->path.c_str();
-    _lwsConnectionInfo.host = _lwsConnectionInfo.address;
-    _lwsConnectionInfo.origin = _lwsConnectionInfo.address;
-    _lwsConnectionInfo.ssl_connection = setupSslConnectionFlags(_dataHolder->ssl);
+    // The client without own SSL settings connects by the SSL settings of the runtime
+    const auto& ssl = _dataHolder->ssl == nullptr && _runtime != nullptr
+                          ? _runtime->getLwsRuntime()->getSslSettings()
+                          : _dataHolder->ssl;
 
-    if (_dataHolder->protocolName != DEFAULT_PROTOCOL_NAME)
+    for (ConnectionId connectionId = 0; connectionId < _connections.size(); ++connectionId)
     {
-        _lwsConnectionInfo.protocol = _dataHolder->protocolName.c_str();
+        auto& connection = _connections[connectionId];
+        auto& connectInfo = connection.connectInfo;
+        if (_runtime != nullptr)
+        {
+            // The shared context dispatches the callbacks to the connection by the opaque user data
+            connectInfo.context = _runtime->getLwsRuntime()->getLwsContext();
+            connectInfo.opaque_user_data = connection.callbackContext.get();
+            connectInfo.local_protocol_name = getRuntimeProtocolName(_dataHolder->callbackVersion);
+        }
+        else
+        {
+            connectInfo.context = _lowLevelContext.get();
+            connectInfo.pwsi = &connection.wsInstance;
+        }
+
+        const auto& endpoint = _dataHolder->endpoints.at(connectionId);
+        connectInfo.address = endpoint.address.c_str();
+        connectInfo.port = endpoint.port;
+        connectInfo.path = endpoint.path.c_str();
+        connectInfo.host = connectInfo.address;
+        connectInfo.origin = connectInfo.address;
+        connectInfo.ssl_connection = setupSslConnectionFlags(ssl);
+
+        if (_dataHolder->protocolName != DEFAULT_PROTOCOL_NAME)
+        {
+            connectInfo.protocol = _dataHolder->protocolName.c_str();
+        }
     }
 }
 
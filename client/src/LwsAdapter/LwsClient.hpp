@@ -27,9 +27,11 @@
 #include <condition_variable>
 #include <cstdint>
 #include <mutex>
+#include <vector>
 
 #include "LwsAdapter/LwsTypesFwd.hpp"
 #include "TypesFwd.hpp"
+#include "lwspp/client/TypesFwd.hpp"
 
 namespace lwspp
 {
@@ -48,10 +50,15 @@ public:
     LwsClient(const LwsClient&) = delete;
     auto operator=(const LwsClient&) noexcept -> LwsClient& = delete;
 
-    // NOTE: the 'connect' method blocks the thread
+    // NOTE: the 'connect' method blocks the thread, unless the client is serviced by the external
+    // event loop or by the runtime, the client with several connections is serviced by the runtime
     void connect();
     void disconnect();
 
+    // The external event loop interface, see IClient
+    void serviceFd(int fd, short revents);
+    auto service() -> int;
+
 private:
     void setupLowLevelContext_();
     void setupConnectionInfo_();
@@ -66,12 +73,20 @@ private:
         Stopped,
     };
 
-    ILwsCallbackContextPtr _callbackContext;
+    // The connection of the client, the connection id is its index
+    struct Connection
+    {
+        ILwsCallbackContextPtr callbackContext;
+        LwsConnectInfo connectInfo{};
+        LwsInstanceRawPtr wsInstance = nullptr;
+    };
+
     LwsDataHolderPtr _dataHolder;
+    std::vector<Connection> _connections;
 
     LowLevelContextPtr _lowLevelContext;
-    LwsInstanceRawPtr _wsInstance = nullptr;
-    LwsConnectInfo _lwsConnectionInfo;
+    contract::IEventLoopPtr _eventLoop;
+    ClientRuntimePtr _runtime;
 
     std::condition_variable _isStoppedCV;
     State _state = State::Initial;
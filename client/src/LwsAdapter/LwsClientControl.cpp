@@ -22,35 +22,268 @@
  * IN THE SOFTWARE.
  */
 
+#include "lwspp/client/contract/IEventLoop.hpp"
+
+#include "Consts.hpp"
 #include "LwsAdapter/ILwsConnection.hpp" // IWYU pragma: keep
 #include "LwsAdapter/LwsClientControl.hpp"
+#include "LwsAdapter/LwsClientRuntime.hpp"
+#include "LwsAdapter/LwsMessage.hpp"
 
 namespace lwspp
 {
 namespace cli
 {
 
-void LwsClientControl::sendTextData(const std::string& message)
+LwsClientControl::LwsClientControl(size_t connectionsCount, contract::IEventLoopPtr eventLoop,
+                                   LwsClientRuntimePtr runtime)
+    : _connections(connectionsCount)
+    , _eventLoop(std::move(eventLoop))
+    , _runtime(std::move(runtime))
+{}
+
+auto LwsClientControl::sendTextData(const std::string& message) -> SendResult
+{
+    return sendMessage_(FIRST_CONNECTION_ID, makeMessage(DataType::Text, message));
+}
+
+auto LwsClientControl::sendBinaryData(const std::vector<char>& data) -> SendResult
+{
+    return sendMessage_(FIRST_CONNECTION_ID, makeMessage(DataType::Binary, data));
+}
+
+auto LwsClientControl::sendTextData(SendBuffer&& message) -> SendResult
+{
+    return sendMessage_(FIRST_CONNECTION_ID, makeMessage(DataType::Text, std::move(message)));
+}
+
+auto LwsClientControl::sendBinaryData(SendBuffer&& data) -> SendResult
+{
+    return sendMessage_(FIRST_CONNECTION_ID, makeMessage(DataType::Binary, std::move(data)));
+}
+
+auto LwsClientControl::sendTextData(const std::string& message, Priority priority)
+-> SendResult
+{
+    return sendMessage_(FIRST_CONNECTION_ID,
+                        makePrioritizedMessage(DataType::Text, priority, message));
+}
+
+auto LwsClientControl::sendBinaryData(const std::vector<char>& data, Priority priority)
+-> SendResult
+{
+    return sendMessage_(FIRST_CONNECTION_ID,
+                        makePrioritizedMessage(DataType::Binary, priority, data));
+}
+
+auto LwsClientControl::sendTextData(SendBuffer&& message, Priority priority)
+-> SendResult
+{
+    return sendMessage_(FIRST_CONNECTION_ID,
+                        makePrioritizedMessage(DataType::Text, priority, std::move(message)));
+}
+
+auto LwsClientControl::sendBinaryData(SendBuffer&& data, Priority priority)
+-> SendResult
+{
+    return sendMessage_(FIRST_CONNECTION_ID,
+                        makePrioritizedMessage(DataType::Binary, priority, std::move(data)));
+}
+
+auto LwsClientControl::sendBinaryStream(contract::IStreamProducerPtr producer) -> SendResult
+{
+    return sendMessage_(FIRST_CONNECTION_ID, makeStreamMessage(std::move(producer)));
+}
+
+auto LwsClientControl::resumeStream() -> bool
+{
+    return resumeStream(FIRST_CONNECTION_ID);
+}
+
+auto LwsClientControl::pauseReceiving() -> bool
+{
+    return pauseReceiving(FIRST_CONNECTION_ID);
+}
+
+auto LwsClientControl::resumeReceiving() -> bool
+{
+    return resumeReceiving(FIRST_CONNECTION_ID);
+}
+
+auto LwsClientControl::getCompressionStats() -> CompressionStats
+{
+    return getCompressionStats(FIRST_CONNECTION_ID);
+}
+
+auto LwsClientControl::sendTextData(ConnectionId connectionId, const std::string& message)
+-> SendResult
+{
+    return sendMessage_(connectionId, makeMessage(DataType::Text, message));
+}
+
+auto LwsClientControl::sendBinaryData(ConnectionId connectionId, const std::vector<char>& data)
+-> SendResult
+{
+    return sendMessage_(connectionId, makeMessage(DataType::Binary, data));
+}
+
+auto LwsClientControl::sendTextData(ConnectionId connectionId, SendBuffer&& message) -> SendResult
+{
+    return sendMessage_(connectionId, makeMessage(DataType::Text, std::move(message)));
+}
+
+auto LwsClientControl::sendBinaryData(ConnectionId connectionId, SendBuffer&& data) -> SendResult
+{
+    return sendMessage_(connectionId, makeMessage(DataType::Binary, std::move(data)));
+}
+
+auto LwsClientControl::sendTextData(ConnectionId connectionId,
+                                    const std::string& message, Priority priority)
+-> SendResult
+{
+    return sendMessage_(connectionId, makePrioritizedMessage(DataType::Text, priority, message));
+}
+
+auto LwsClientControl::sendBinaryData(ConnectionId connectionId,
+                                      const std::vector<char>& data, Priority priority)
+-> SendResult
+{
+    return sendMessage_(connectionId, makePrioritizedMessage(DataType::Binary, priority, data));
+}
+
+auto LwsClientControl::sendTextData(ConnectionId connectionId,
+                                    SendBuffer&& message, Priority priority)
+-> SendResult
+{
+    return sendMessage_(connectionId,
+                        makePrioritizedMessage(DataType::Text, priority, std::move(message)));
+}
+
+auto LwsClientControl::sendBinaryData(ConnectionId connectionId,
+                                      SendBuffer&& data, Priority priority)
+-> SendResult
+{
+    return sendMessage_(connectionId,
+                        makePrioritizedMessage(DataType::Binary, priority, std::move(data)));
+}
+
+auto LwsClientControl::sendBinaryStream(ConnectionId connectionId,
+                                        contract::IStreamProducerPtr producer) -> SendResult
+{
+    return sendMessage_(connectionId, makeStreamMessage(std::move(producer)));
+}
+
+auto LwsClientControl::resumeStream(ConnectionId connectionId) -> bool
+{
+    auto connection = getConnection_(connectionId);
+    if (connection == nullptr)
+    {
+        return false;
+    }
+
+    if (connection->markPendingWrite())
+    {
+        wakeUpService_(connection);
+    }
+    return true;
+}
+
+// NOTE: The lws_rx_flow_control can not be called outside of the service thread, the service
+// thread is woken up instead and pauses or resumes the reading itself
+auto LwsClientControl::pauseReceiving(ConnectionId connectionId) -> bool
 {
-    if (auto connection = _connection.lock())
+    auto connection = getConnection_(connectionId);
+    if (connection == nullptr)
     {
-        connection->addTextDataToSend(message);
-        lws_callback_on_writable(connection->getLwsInstance());
+        return false;
     }
+
+    if (connection->pauseReceiving())
+    {
+        wakeUpService_(connection);
+    }
+    return true;
 }
 
-void LwsClientControl::sendBinaryData(const std::vector<char>& data)
+auto LwsClientControl::resumeReceiving(ConnectionId connectionId) -> bool
 {
-    if (auto connection = _connection.lock())
+    auto connection = getConnection_(connectionId);
+    if (connection == nullptr)
     {
-        connection->addBinaryDataToSend(data);
-        lws_callback_on_writable(connection->getLwsInstance());
+        return false;
     }
+
+    if (connection->resumeReceiving())
+    {
+        wakeUpService_(connection);
+    }
+    return true;
 }
 
-void lwspp::cli::LwsClientControl::setConnection(const ILwsConnectionPtr& c)
+auto LwsClientControl::getCompressionStats(ConnectionId connectionId) -> CompressionStats
 {
-    _connection = c;
+    if (auto connection = getConnection_(connectionId))
+    {
+        return connection->getCompressionStats();
+    }
+    return CompressionStats{};
+}
+
+void LwsClientControl::setConnection(ConnectionId connectionId, const ILwsConnectionPtr& c)
+{
+    _connections.at(connectionId) = c;
+}
+
+auto LwsClientControl::sendMessage_(ConnectionId connectionId, Message message) -> SendResult
+{
+    auto connection = getConnection_(connectionId);
+    if (connection == nullptr)
+    {
+        return SendResult::NotConnected;
+    }
+
+    const auto result = connection->addDataToSend(std::move(message));
+
+    // NOTE: The lws_callback_on_writable can not be called outside of the service thread,
+    // the service thread is woken up instead and requests the writable callback itself.
+    // All the messages added before the service thread wakes up cost the one wake up.
+    // The slow consumer is closed and the high watermark is reported by the service thread
+    // as well.
+    if ((result.sendResult == SendResult::Queued ||
+         result.sendResult == SendResult::Disconnected || result.highWatermarkReached) &&
+        connection->markPendingWrite())
+    {
+        wakeUpService_(connection);
+    }
+    return result.sendResult;
+}
+
+auto LwsClientControl::getConnection_(ConnectionId connectionId) -> ILwsConnectionPtr
+{
+    // The unknown connection id is not connected
+    if (connectionId >= _connections.size())
+    {
+        return nullptr;
+    }
+    return _connections[connectionId].lock();
+}
+
+void LwsClientControl::wakeUpService_(const ILwsConnectionPtr& connection)
+{
+    // The cancel pipe of the libwebsockets is not watched by the external event loop
+    if (_eventLoop != nullptr)
+    {
+        _eventLoop->wakeUp();
+    }
+    // The shared context has many connections, only the service thread of this one is woken up
+    else if (_runtime != nullptr)
+    {
+        _runtime->wakeUp(connection);
+    }
+    else
+    {
+        lws_cancel_service(connection->getLwsContext());
+    }
 }
 
 } // namespace cli
@@ -24,25 +24,76 @@
 
 #pragma once
 
+#include <vector>
+
 #include "lwspp/client/IClientControl.hpp"
 
+#include "LwsAdapter/LwsTypes.hpp"
 #include "LwsAdapter/LwsTypesFwd.hpp"
+#include "TypesFwd.hpp"
 
 namespace lwspp
 {
 namespace cli
 {
 
+/**
+ * @brief The LwsClientControl class sends the data to the connections of the client, the
+ * connection id is the index of the connection.
+ */
 class LwsClientControl : public IClientControl
 {
 public:
-    void sendTextData(const std::string&) override;
-    void sendBinaryData(const std::vector<char>&) override;
+    LwsClientControl(size_t connectionsCount, contract::IEventLoopPtr, LwsClientRuntimePtr);
+
+    auto sendTextData(const std::string&) -> SendResult override;
+    auto sendBinaryData(const std::vector<char>&) -> SendResult override;
+
+    auto sendTextData(SendBuffer&&) -> SendResult override;
+    auto sendBinaryData(SendBuffer&&) -> SendResult override;
+
+    auto sendTextData(const std::string&, Priority) -> SendResult override;
+    auto sendBinaryData(const std::vector<char>&, Priority) -> SendResult override;
+    auto sendTextData(SendBuffer&&, Priority) -> SendResult override;
+    auto sendBinaryData(SendBuffer&&, Priority) -> SendResult override;
+
+    auto sendBinaryStream(contract::IStreamProducerPtr) -> SendResult override;
+    auto resumeStream() -> bool override;
+
+    auto pauseReceiving() -> bool override;
+    auto resumeReceiving() -> bool override;
+
+    auto getCompressionStats() -> CompressionStats override;
 
-    void setConnection(const ILwsConnectionPtr&);
+    auto sendTextData(ConnectionId, const std::string&) -> SendResult override;
+    auto sendBinaryData(ConnectionId, const std::vector<char>&) -> SendResult override;
+    auto sendTextData(ConnectionId, SendBuffer&&) -> SendResult override;
+    auto sendBinaryData(ConnectionId, SendBuffer&&) -> SendResult override;
+
+    auto sendTextData(ConnectionId, const std::string&, Priority) -> SendResult override;
+    auto sendBinaryData(ConnectionId, const std::vector<char>&, Priority) -> SendResult override;
+    auto sendTextData(ConnectionId, SendBuffer&&, Priority) -> SendResult override;
+    auto sendBinaryData(ConnectionId, SendBuffer&&, Priority) -> SendResult override;
+
+    auto sendBinaryStream(ConnectionId, contract::IStreamProducerPtr) -> SendResult override;
+    auto resumeStream(ConnectionId) -> bool override;
+
+    auto pauseReceiving(ConnectionId) -> bool override;
+    auto resumeReceiving(ConnectionId) -> bool override;
+
+    auto getCompressionStats(ConnectionId) -> CompressionStats override;
+
+    void setConnection(ConnectionId, const ILwsConnectionPtr&);
+
+private:
+    auto sendMessage_(ConnectionId, Message) -> SendResult;
+    auto getConnection_(ConnectionId) -> ILwsConnectionPtr;
+    void wakeUpService_(const ILwsConnectionPtr&);
 
 private:
-    ILwsConnectionWeak _connection;
+    std::vector<ILwsConnectionWeak> _connections;
+    contract::IEventLoopPtr _eventLoop;
+    LwsClientRuntimePtr _runtime;
 };
 
 } // namespace cli
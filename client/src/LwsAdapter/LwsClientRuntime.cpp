@@ -0,0 +1,411 @@
+/*
+ * lwspp - C++ wrapper for the libwebsockets library
+ *
+ * Copyright (C) 2023 - 2023 Volodymyr Lotoshko <vlotoshko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <future>
+#include <libwebsockets.h>
+#include <stdexcept>
+
+#include "ClientRuntimeContext.hpp"
+#include "LwsAdapter/ILwsCallbackContext.hpp" // IWYU pragma: keep
+#include "LwsAdapter/ILwsConnection.hpp"      // IWYU pragma: keep
+#include "LwsAdapter/LwsCallback.hpp"
+#include "LwsAdapter/LwsClientRuntime.hpp"
+#include "LwsAdapter/LwsCompression.hpp"
+#include "LwsAdapter/LwsContextDeleter.hpp"
+#include "LwsAdapter/LwsContextSetup.hpp"
+#include "LwsAdapter/LwsProtocolsFactory.hpp"
+
+namespace lwspp
+{
+namespace cli
+{
+
+LwsClientRuntime::LwsClientRuntime(const ClientRuntimeContext& context)
+    : _protocols(createLwsRuntimeProtocols(context.rxBufferSize, context.txPacketSize))
+    , _ssl(context.ssl)
+    , _compression(context.compression)
+    , _compressionOffer(createCompressionOffer(_compression))
+    , _extensions(createLwsExtensions(_compression, _compressionOffer))
+{
+    setupLowLevelContext_(context);
+
+    // The libwebsockets may create less threads than requested, see LWS_MAX_SMP
+    _threadsCount = lws_get_count_threads(_lowLevelContext.get());
+    for (int tsi = 0; tsi < _threadsCount; ++tsi)
+    {
+        _serviceThreads.push_back(std::unique_ptr<ServiceThreadRequests>(new ServiceThreadRequests{}));
+    }
+}
+
+LwsClientRuntime::~LwsClientRuntime()
+{
+    stopService();
+    waitForServiceStopped_();
+}
+
+void LwsClientRuntime::startService()
+{
+    {
+        const std::lock_guard<std::mutex> guard(_mutex);
+        if (_state == State::Initial)
+        {
+            _state = State::Started;
+        }
+        else
+        {
+            return;
+        }
+    }
+
+    // The clients added before the start are waiting for the service threads
+    lws_cancel_service(_lowLevelContext.get());
+
+    std::vector<std::future<int>> serviceLoops;
+    for (int tsi = 1; tsi < _threadsCount; ++tsi)
+    {
+        serviceLoops.push_back(std::async(std::launch::async, [this, tsi]{ return runServiceLoop_(tsi); }));
+    }
+
+    int res = runServiceLoop_(0);
+    for (auto& serviceLoop : serviceLoops)
+    {
+        const int loopRes = serviceLoop.get();
+        if (res >= 0)
+        {
+            res = loopRes;
+        }
+    }
+
+    {
+        const std::lock_guard<std::mutex> guard(_mutex);
+        _state = State::Stopped;
+    }
+    _isStoppedCV.notify_one();
+    _isClientClosedCV.notify_all();
+
+    if (res < 0)
+    {
+        throw std::runtime_error{
+            std::string{"lws_service stopped with the error code: "}.append(std::to_string(res))};
+    }
+}
+
+void LwsClientRuntime::stopService()
+{
+    const std::lock_guard<std::mutex> guard(_mutex);
+    if (_state == State::Initial)
+    {
+        _state = State::Stopped;
+    }
+    else if (_state == State::Started)
+    {
+        _state = State::Stopping;
+        lws_cancel_service(_lowLevelContext.get());
+    }
+}
+
+auto LwsClientRuntime::getLwsContext() const -> LwsContextRawPtr
+{
+    return _lowLevelContext.get();
+}
+
+auto LwsClientRuntime::getCompressionSettings() const -> const CompressionSettingsPtr&
+{
+    return _compression;
+}
+
+auto LwsClientRuntime::getSslSettings() const -> const SslSettingsPtr&
+{
+    return _ssl;
+}
+
+void LwsClientRuntime::addClient(ILwsCallbackContext* callbackContext,
+                                 const LwsConnectInfo* connectInfo)
+{
+    {
+        const std::lock_guard<std::mutex> guard(_mutex);
+        auto& client = _clients[callbackContext];
+        client.connectInfo = connectInfo;
+        // The clients are spread across the service threads evenly
+        client.tsi = static_cast<int>(_addedClients++ % _serviceThreads.size());
+        addPendingClient_(callbackContext, client);
+    }
+    lws_cancel_service(_lowLevelContext.get());
+}
+
+void LwsClientRuntime::removeClients(const std::vector<ILwsCallbackContext*>& callbackContexts)
+{
+    std::unique_lock<std::mutex> guard(_mutex);
+    std::vector<std::pair<ILwsCallbackContext*, Client*>> removedClients;
+    for (auto* callbackContext : callbackContexts)
+    {
+        auto found = _clients.find(callbackContext);
+        if (found != _clients.end())
+        {
+            found->second.isRemoved = true;
+            addPendingClient_(callbackContext, found->second);
+            removedClients.emplace_back(callbackContext, &found->second);
+        }
+    }
+    lws_cancel_service(_lowLevelContext.get());
+
+    // The connections are not closed if the service threads are not running
+    _isClientClosedCV.wait(guard, [this, &removedClients]
+    {
+        if (_state == State::Initial || _state == State::Stopped)
+        {
+            return true;
+        }
+        for (const auto& removedClient : removedClients)
+        {
+            if (removedClient.second->state != ClientState::Closed)
+            {
+                return false;
+            }
+        }
+        return true;
+    });
+
+    for (const auto& removedClient : removedClients)
+    {
+        auto* wsInstance = removedClient.second->wsInstance;
+        if (wsInstance != nullptr)
+        {
+            // The connection is destroyed along with the context, without the client
+            lws_set_opaque_user_data(wsInstance, nullptr);
+            _instances.erase(wsInstance);
+        }
+        _clients.erase(removedClient.first);
+    }
+}
+
+// NOTE: The connection is queued once until its requests are serviced, see markPendingWrite,
+// and all the connections queued before the service thread wakes up cost the one wake up
+void LwsClientRuntime::wakeUp(const ILwsConnectionPtr& connection)
+{
+    // The thread service index of the connection is given by the libwebsockets, so it is valid
+    auto& requests = *_serviceThreads[static_cast<size_t>(connection->getServiceThreadIndex())];
+    requests.connections.push(connection);
+    if (!requests.wakeupRequested.exchange(true) && !connection->wakeUpServiceThread())
+    {
+        // The connection is closed meanwhile, the wake up is still required by the others
+        lws_cancel_service(_lowLevelContext.get());
+    }
+}
+
+void LwsClientRuntime::serviceClients(int tsi)
+{
+    auto& requests = *_serviceThreads.at(static_cast<size_t>(tsi));
+    // NOTE: The flag is cleared before the connections are taken, so the requests added after
+    // this point request the new wake up
+    requests.wakeupRequested = false;
+    while (auto* front = requests.connections.front())
+    {
+        auto connection = std::move(*front);
+        requests.connections.pop();
+
+        // The connection could be already closed, its instance is destroyed then
+        if (connection->isLwsInstanceAttached())
+        {
+            auto* callbackContext = reinterpret_cast<ILwsCallbackContext*>(
+                lws_get_opaque_user_data(connection->getLwsInstance()));
+            if (callbackContext != nullptr)
+            {
+                servicePendingRequests(*callbackContext);
+            }
+        }
+    }
+
+    // The clients are connected and closed rarely, the lock is taken only then
+    if (requests.hasPendingClients.exchange(false))
+    {
+        servicePendingClients_(requests);
+    }
+}
+
+void LwsClientRuntime::servicePendingClients_(ServiceThreadRequests& requests)
+{
+    std::vector<ILwsCallbackContext*> pendingClients;
+    std::vector<std::pair<ILwsCallbackContext*, const LwsConnectInfo*>> clientsToConnect;
+    std::vector<LwsInstanceRawPtr> instancesToClose;
+    bool isClientClosed = false;
+    {
+        const std::lock_guard<std::mutex> guard(_mutex);
+        pendingClients.swap(requests.clients);
+        for (auto* callbackContext : pendingClients)
+        {
+            auto found = _clients.find(callbackContext);
+            if (found == _clients.end())
+            {
+                continue;
+            }
+
+            auto& client = found->second;
+            client.isPending = false;
+            if (client.state == ClientState::Initial)
+            {
+                if (client.isRemoved)
+                {
+                    client.state = ClientState::Closed;
+                    isClientClosed = true;
+                }
+                else
+                {
+                    client.state = ClientState::Connecting;
+                    clientsToConnect.emplace_back(callbackContext, client.connectInfo);
+                }
+            }
+            else if (client.state == ClientState::Connected && client.isRemoved &&
+                     !client.isClosing)
+            {
+                client.isClosing = true;
+                instancesToClose.push_back(client.wsInstance);
+            }
+        }
+    }
+
+    if (isClientClosed)
+    {
+        _isClientClosedCV.notify_all();
+    }
+
+    // NOTE: The libwebsockets binds the client connection to the service thread making it,
+    // so all the callbacks of the client are run by its service thread
+    for (const auto& clientToConnect : clientsToConnect)
+    {
+        auto* wsInstance = lws_client_connect_via_info(clientToConnect.second);
+
+        const std::lock_guard<std::mutex> guard(_mutex);
+        auto& client = _clients.at(clientToConnect.first);
+        if (wsInstance == nullptr)
+        {
+            client.state = ClientState::Closed;
+            _isClientClosedCV.notify_all();
+            continue;
+        }
+
+        client.state = ClientState::Connected;
+        client.wsInstance = wsInstance;
+        _instances[wsInstance] = clientToConnect.first;
+        if (client.isRemoved)
+        {
+            // The client was removed while connecting, it is closed on the next wake up
+            addPendingClient_(clientToConnect.first, client);
+            lws_cancel_service(_lowLevelContext.get());
+        }
+    }
+
+    for (auto* wsInstance : instancesToClose)
+    {
+        lws_close_reason(wsInstance, LWS_CLOSE_STATUS_GOINGAWAY, nullptr, 0);
+        lws_set_timeout(wsInstance, PENDING_TIMEOUT_CLOSE_SEND, LWS_TO_KILL_ASYNC);
+    }
+}
+
+void LwsClientRuntime::onInstanceDestroyed(LwsInstanceRawPtr wsInstance)
+{
+    {
+        const std::lock_guard<std::mutex> guard(_mutex);
+        auto found = _instances.find(wsInstance);
+        if (found == _instances.end())
+        {
+            return;
+        }
+
+        auto client = _clients.find(found->second);
+        if (client != _clients.end())
+        {
+            client->second.state = ClientState::Closed;
+            client->second.wsInstance = nullptr;
+        }
+        _instances.erase(found);
+    }
+    _isClientClosedCV.notify_all();
+}
+
+void LwsClientRuntime::setupLowLevelContext_(const ClientRuntimeContext& context)
+{
+    auto lwsContextInfo = lws_context_creation_info{};
+    lwsContextInfo.protocols = _protocols.data();
+    lwsContextInfo.user = this;
+    lwsContextInfo.port = CONTEXT_PORT_NO_LISTEN;
+    lwsContextInfo.count_threads = context.serviceThreads;
+    lwsContextInfo.ka_time = context.keepAliveTimeout;
+    lwsContextInfo.ka_interval = context.keepAliveProbesInterval;
+    lwsContextInfo.ka_probes = context.keepAliveProbes;
+
+    if (!_extensions.empty())
+    {
+        lwsContextInfo.extensions = _extensions.data();
+    }
+
+    if (context.lwsLogLevel != DEFAULT_LWS_LOG_LEVEL)
+    {
+        lws_set_log_level(context.lwsLogLevel, nullptr);
+    }
+
+    setupSslSettings(lwsContextInfo, _ssl);
+
+    _lowLevelContext = LowLevelContextPtr{lws_create_context(&lwsContextInfo), LwsContextDeleter{}};
+    if (_lowLevelContext == nullptr)
+    {
+        throw std::runtime_error{"lws_context initialization failed"};
+    }
+}
+
+auto LwsClientRuntime::runServiceLoop_(int tsi) -> int
+{
+    int res = 0;
+    while (res >= 0 && _state != State::Stopping)
+    {
+        res = lws_service_tsi(_lowLevelContext.get(), 0, tsi);
+    }
+
+    if (res < 0)
+    {
+        // Stops the service loops running in the other threads
+        stopService();
+    }
+    return res;
+}
+
+void LwsClientRuntime::addPendingClient_(ILwsCallbackContext* callbackContext, Client& client)
+{
+    if (!client.isPending)
+    {
+        client.isPending = true;
+        auto& requests = *_serviceThreads.at(static_cast<size_t>(client.tsi));
+        requests.clients.push_back(callbackContext);
+        requests.hasPendingClients = true;
+    }
+}
+
+void LwsClientRuntime::waitForServiceStopped_()
+{
+    std::unique_lock<std::mutex> guard(_mutex);
+    _isStoppedCV.wait(guard, [this]{ return _state == State::Stopped || _state == State::Initial; });
+}
+
+} // namespace cli
+} // namespace lwspp
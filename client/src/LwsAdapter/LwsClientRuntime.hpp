@@ -0,0 +1,154 @@
+/*
+ * lwspp - C++ wrapper for the libwebsockets library
+ *
+ * Copyright (C) 2023 - 2023 Volodymyr Lotoshko <vlotoshko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "LwsAdapter/LwsTypesFwd.hpp"
+#include "MpscQueue.hpp"
+#include "TypesFwd.hpp"
+
+namespace lwspp
+{
+namespace cli
+{
+
+/**
+ * @brief The LwsClientRuntime class owns the lws_context and the service loops shared by many
+ * clients. Every client is bound to one of the service threads, its connection is made, serviced
+ * and closed by that thread only.
+ */
+class LwsClientRuntime
+{
+public:
+    explicit LwsClientRuntime(const ClientRuntimeContext&);
+    ~LwsClientRuntime();
+
+    LwsClientRuntime(LwsClientRuntime&&) = delete;
+    auto operator=(LwsClientRuntime&&) noexcept -> LwsClientRuntime& = delete;
+
+    LwsClientRuntime(const LwsClientRuntime&) = delete;
+    auto operator=(const LwsClientRuntime&) noexcept -> LwsClientRuntime& = delete;
+
+    // NOTE: the 'startService' method blocks the thread. The additional service threads are
+    // started and joined by this method
+    void startService();
+    void stopService();
+
+    auto getLwsContext() const -> LwsContextRawPtr;
+    auto getCompressionSettings() const -> const CompressionSettingsPtr&;
+    auto getSslSettings() const -> const SslSettingsPtr&;
+
+    // Connects the client on its service thread. The callback context and the connect info
+    // must be valid until the client is removed
+    void addClient(ILwsCallbackContext*, const LwsConnectInfo*);
+    // Closes the connections of the clients on their service threads and waits until they are
+    // destroyed. Must not be called on the service threads
+    void removeClients(const std::vector<ILwsCallbackContext*>&);
+    // Can be called from any thread. Wakes up the service thread of the connection to service
+    // its pending requests, see servicePendingRequests. The other service threads are not
+    // woken up, and the clients are not locked
+    void wakeUp(const ILwsConnectionPtr&);
+
+    // Invoked on the service threads by the runtime protocols
+    void serviceClients(int tsi);
+    void onInstanceDestroyed(LwsInstanceRawPtr);
+
+private:
+    enum class State : uint8_t
+    {
+        Initial,
+        Started,
+        Stopping,
+        Stopped,
+    };
+
+    enum class ClientState : uint8_t
+    {
+        Initial,
+        Connecting,
+        Connected,
+        Closed,
+    };
+
+    struct Client
+    {
+        const LwsConnectInfo* connectInfo = nullptr;
+        LwsInstanceRawPtr wsInstance = nullptr;
+        int tsi = 0;
+        ClientState state = ClientState::Initial;
+        bool isPending = false;
+        bool isRemoved = false;
+        bool isClosing = false;
+    };
+
+    // The requests waiting for the one service thread
+    struct ServiceThreadRequests
+    {
+        // The connections with the pending requests, queued without the lock
+        MpscQueue<ILwsConnectionPtr> connections;
+        std::atomic<bool> wakeupRequested{false};
+        // The clients to connect or to close, guarded by the mutex
+        std::vector<ILwsCallbackContext*> clients;
+        std::atomic<bool> hasPendingClients{false};
+    };
+
+private:
+    void setupLowLevelContext_(const ClientRuntimeContext&);
+    auto runServiceLoop_(int tsi) -> int;
+    void servicePendingClients_(ServiceThreadRequests&);
+    void addPendingClient_(ILwsCallbackContext*, Client&);
+    void waitForServiceStopped_();
+
+private:
+    LwsProtocols _protocols;
+    SslSettingsPtr _ssl;
+    CompressionSettingsPtr _compression;
+    std::string _compressionOffer;
+    LwsExtensions _extensions;
+    LowLevelContextPtr _lowLevelContext;
+    int _threadsCount = 1;
+
+    std::unordered_map<ILwsCallbackContext*, Client> _clients;
+    std::unordered_map<LwsInstanceRawPtr, ILwsCallbackContext*> _instances;
+    // The requests waiting for the service thread, by the thread service index
+    std::vector<std::unique_ptr<ServiceThreadRequests>> _serviceThreads;
+    size_t _addedClients = 0;
+    std::condition_variable _isClientClosedCV;
+
+    std::condition_variable _isStoppedCV;
+    std::atomic<State> _state{State::Initial};
+    std::mutex _mutex;
+};
+
+} // namespace cli
+} // namespace lwspp
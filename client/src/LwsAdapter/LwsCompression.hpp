@@ -0,0 +1,51 @@
+/*
+ * lwspp - C++ wrapper for the libwebsockets library
+ *
+ * Copyright (C) 2023 - 2023 Volodymyr Lotoshko <vlotoshko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <libwebsockets.h>
+#include <string>
+
+#include "LwsAdapter/LwsTypesFwd.hpp"
+#include "TypesFwd.hpp"
+
+namespace lwspp
+{
+namespace cli
+{
+
+// Creates the permessage-deflate parameters offered to the server
+auto createCompressionOffer(const CompressionSettingsPtr&) -> std::string;
+
+// Creates the permessage-deflate extension list, the list is empty if the compression is disabled.
+// The offer should outlive the extension list.
+auto createLwsExtensions(const CompressionSettingsPtr&, const std::string& offer) -> LwsExtensions;
+
+// Applies the compression settings to the established connection. The LZ77 window is limited
+// by the client_max_window_bits responded by the server. Does nothing if the permessage-deflate
+// is not accepted by the server.
+void setupCompression(lws*, const CompressionSettings&);
+
+} // namespace cli
+} // namespace lwspp
@@ -23,6 +23,7 @@
  */
 
 #include "LwsAdapter/LwsConnection.hpp"
+#include "LwsAdapter/LwsMessage.hpp"
 
 namespace lwspp
 {
@@ -31,22 +32,18 @@ namespace cli
 namespace
 {
 
-// NOTE: Additional space with the size of LWS_PRE should be added in the front of the data
-// For more information please read lws_write description
-template <typename Container>
-auto addPrefixToMessage(const Container& message) -> std::string
-{
-    std::string result;
-    // NOTE: resize can throw bad alloc if message is too large
-    result.resize(LWS_PRE + message.size());
-    std::copy(message.cbegin(), message.cend(), &result[0] + LWS_PRE);
-    return result;
-}
+// The low watermark is the half of the queue limits
+const size_t LOW_WATERMARK_DIVISOR = 2;
+// The high priority messages written in a row at most while the bulk lane has pending data
+const unsigned int HIGH_PRIORITY_WEIGHT = 4;
 
 } // namespace
 
-LwsConnection::LwsConnection(LwsInstanceRawPtr instance)
+LwsConnection::LwsConnection(LwsInstanceRawPtr instance, QueueLimits queueLimits)
     : _wsInstance(instance)
+    , _lwsContext(lws_get_context(instance))
+    , _serviceThreadIndex(lws_get_tsi(instance))
+    , _queueLimits(queueLimits)
 {}
 
 auto LwsConnection::getLwsInstance() -> LwsInstanceRawPtr
@@ -54,30 +51,294 @@ auto LwsConnection::getLwsInstance() -> LwsInstanceRawPtr
     return _wsInstance;
 }
 
-void LwsConnection::addBinaryDataToSend(const std::vector<char>& binaryData)
+auto LwsConnection::getLwsContext() -> LwsContextRawPtr
+{
+    return _lwsContext;
+}
+
+auto LwsConnection::getServiceThreadIndex() const -> int
+{
+    return _serviceThreadIndex;
+}
+
+auto LwsConnection::wakeUpServiceThread() -> bool
+{
+    const std::lock_guard<std::mutex> guard(_instanceMutex);
+    if (!_isInstanceAttached)
+    {
+        return false;
+    }
+    lws_cancel_service_pt(_wsInstance);
+    return true;
+}
+
+void LwsConnection::detachLwsInstance()
+{
+    const std::lock_guard<std::mutex> guard(_instanceMutex);
+    _isInstanceAttached = false;
+}
+
+// NOTE: The flag is changed by the service thread only, so it is read there without the lock
+auto LwsConnection::isLwsInstanceAttached() const -> bool
+{
+    return _isInstanceAttached;
+}
+
+// NOTE: The limits are checked without the lock, the concurrent producers may exceed them
+// by the messages they send at the same time
+auto LwsConnection::addDataToSend(Message message) -> EnqueueResult
+{
+    if (_closeReason == CloseReason::SlowConsumer)
+    {
+        return EnqueueResult{SendResult::Disconnected, false};
+    }
+
+    const size_t messageSize = getQueuedSize(message);
+    bool highWatermarkReached = false;
+    if (isLimitReached_(messageSize))
+    {
+        highWatermarkReached = !_aboveHighWatermark.exchange(true);
+        switch (_queueLimits.policy)
+        {
+        case SlowConsumerPolicy::Reject:
+            return EnqueueResult{SendResult::Rejected, highWatermarkReached};
+        case SlowConsumerPolicy::DropNewest:
+            return EnqueueResult{SendResult::Dropped, highWatermarkReached};
+        case SlowConsumerPolicy::Disconnect:
+            markToClose(CloseReason::SlowConsumer);
+            return EnqueueResult{SendResult::Disconnected, highWatermarkReached};
+        case SlowConsumerPolicy::DropOldest:
+            // The service thread drops the oldest messages, see trimPendingData
+            break;
+        }
+    }
+
+    ++_queuedMessages;
+    _queuedBytes += messageSize;
+    auto& lane = getLane_(message.priority);
+    lane.push(std::move(message));
+    return EnqueueResult{SendResult::Queued, highWatermarkReached};
+}
+
+auto LwsConnection::frontPendingData() -> Message*
+{
+    auto* lane = selectFrontLane_();
+    return lane != nullptr ? lane->front() : nullptr;
+}
+
+auto LwsConnection::hasPendingData() -> bool
+{
+    return !getLane_(Priority::High).empty() || !getLane_(Priority::Bulk).empty();
+}
+
+auto LwsConnection::popPendingData(size_t messageSize) -> bool
+{
+    auto* lane = selectFrontLane_();
+    if (lane == nullptr)
+    {
+        return false;
+    }
+
+    _highPriorityInRow = _frontLane == Priority::High ? _highPriorityInRow + 1 : 0;
+    _isFrontLaneSelected = false;
+    return popMessage_(*lane, messageSize);
+}
+
+auto LwsConnection::trimPendingData() -> bool
+{
+    if (_queueLimits.policy != SlowConsumerPolicy::DropOldest)
+    {
+        return false;
+    }
+
+    // NOTE: The other messages can not be sent between the fragments of the started message,
+    // so the queue is not trimmed until the message is written
+    auto* lane = _isFrontLaneSelected ? &getLane_(_frontLane) : nullptr;
+    if (lane != nullptr && lane->front() != nullptr && isWriteStarted(*lane->front()))
+    {
+        return false;
+    }
+
+    // The bulk data is dropped first. The last message is kept even if it exceeds the limits
+    // on its own.
+    _isFrontLaneSelected = false;
+    bool isBelowLowWatermark = false;
+    while (_queuedMessages > 1 && exceedsLimits_(_queuedMessages, _queuedBytes))
+    {
+        auto& bulkLane = getLane_(Priority::Bulk);
+        auto& dropLane = bulkLane.empty() ? getLane_(Priority::High) : bulkLane;
+        isBelowLowWatermark |= popMessage_(dropLane, getQueuedSize(*dropLane.front()));
+    }
+    return isBelowLowWatermark;
+}
+
+auto LwsConnection::takeHighWatermark() -> bool
 {
-    std::string payload = addPrefixToMessage(binaryData);
+    if (_isHighWatermarkReported || !_aboveHighWatermark)
+    {
+        return false;
+    }
+    _isHighWatermarkReported = true;
+    return true;
+}
 
-    const std::lock_guard<std::mutex> guard(_mutex);
-    _messages.emplace(DataType::Binary, std::move(payload));
+auto LwsConnection::getReceiveBuffer() -> std::vector<char>&
+{
+    return _receiveBuffer;
 }
 
-void LwsConnection::addTextDataToSend(const std::string& textData)
+void LwsConnection::keepWrittenMessage(Message message)
 {
-    std::string payload = addPrefixToMessage(textData);
+    _writtenMessage.reset(new Message(std::move(message)));
+}
 
-    const std::lock_guard<std::mutex> guard(_mutex);
-    _messages.emplace(DataType::Text, std::move(payload));
+void LwsConnection::releaseWrittenMessage()
+{
+    _writtenMessage.reset();
+}
+
+void LwsConnection::addCompressionStats(size_t uncompressedBytes, size_t compressedBytes,
+                                        std::chrono::nanoseconds cpuTime)
+{
+    _uncompressedBytes += uncompressedBytes;
+    _compressedBytes += compressedBytes;
+    _compressionCpuTime += cpuTime.count();
 }
 
-auto LwsConnection::getPendingData() -> std::queue<Message>&
+auto LwsConnection::getCompressionStats() const -> CompressionStats
 {
-    if (_messagesToSend.empty())
+    auto stats = CompressionStats{};
+    stats.uncompressedBytes = _uncompressedBytes;
+    stats.compressedBytes = _compressedBytes;
+    stats.cpuTime = std::chrono::nanoseconds{_compressionCpuTime};
+    return stats;
+}
+
+void LwsConnection::setDeflatePending(bool isPending)
+{
+    _isDeflatePending = isPending;
+}
+
+auto LwsConnection::isDeflatePending() const -> bool
+{
+    return _isDeflatePending;
+}
+
+void LwsConnection::markToClose(CloseReason reason)
+{
+    _closeReason = reason;
+}
+
+auto LwsConnection::getCloseReason() const -> CloseReason
+{
+    return _closeReason;
+}
+
+auto LwsConnection::markPendingWrite() -> bool
+{
+    return !_pendingWrite.exchange(true);
+}
+
+auto LwsConnection::clearPendingWrite() -> bool
+{
+    return _pendingWrite.exchange(false);
+}
+
+auto LwsConnection::pauseReceiving() -> bool
+{
+    const bool isChanged = !_isReceivingPaused.exchange(true);
+    if (isChanged)
+    {
+        _receivingChanged = true;
+    }
+    return isChanged;
+}
+
+auto LwsConnection::resumeReceiving() -> bool
+{
+    const bool isChanged = _isReceivingPaused.exchange(false);
+    if (isChanged)
+    {
+        _receivingChanged = true;
+    }
+    return isChanged;
+}
+
+auto LwsConnection::isReceivingPaused() const -> bool
+{
+    return _isReceivingPaused;
+}
+
+auto LwsConnection::takeReceivingChange() -> bool
+{
+    return _receivingChanged.exchange(false);
+}
+
+// The empty queue takes the message of any size
+auto LwsConnection::isLimitReached_(size_t messageSize) const -> bool
+{
+    const size_t queuedMessages = _queuedMessages;
+    if (queuedMessages == 0)
+    {
+        return false;
+    }
+
+    return exceedsLimits_(queuedMessages + 1, _queuedBytes + messageSize);
+}
+
+auto LwsConnection::exceedsLimits_(size_t messages, size_t bytes) const -> bool
+{
+    return (_queueLimits.maxMessages != 0 && messages > _queueLimits.maxMessages) ||
+           (_queueLimits.maxBytes != 0 && bytes > _queueLimits.maxBytes);
+}
+
+auto LwsConnection::isBelowLowWatermark_() const -> bool
+{
+    return !exceedsLimits_(_queuedMessages * LOW_WATERMARK_DIVISOR,
+                           _queuedBytes * LOW_WATERMARK_DIVISOR);
+}
+
+auto LwsConnection::getLane_(Priority priority) -> MpscQueue<Message>&
+{
+    return _lanes[static_cast<size_t>(priority)];
+}
+
+// The lane is selected until its front message is popped, so the front message stays the same.
+// The high priority lane gives way to the bulk lane after HIGH_PRIORITY_WEIGHT messages in a row.
+auto LwsConnection::selectFrontLane_() -> MpscQueue<Message>*
+{
+    if (!_isFrontLaneSelected)
+    {
+        const bool hasHighPriority = !getLane_(Priority::High).empty();
+        const bool hasBulk = !getLane_(Priority::Bulk).empty();
+        if (!hasHighPriority && !hasBulk)
+        {
+            return nullptr;
+        }
+
+        const bool isBulkTurn = hasBulk &&
+                                (!hasHighPriority || _highPriorityInRow >= HIGH_PRIORITY_WEIGHT);
+        _frontLane = isBulkTurn ? Priority::Bulk : Priority::High;
+        _isFrontLaneSelected = true;
+    }
+    return &getLane_(_frontLane);
+}
+
+// Returns true if the queue has drained below the low watermark. The crossing not reported
+// as the high watermark yet is not reported as the low one either.
+auto LwsConnection::popMessage_(MpscQueue<Message>& lane, size_t messageSize) -> bool
+{
+    lane.pop();
+    --_queuedMessages;
+    _queuedBytes -= messageSize;
+
+    if (_aboveHighWatermark && isBelowLowWatermark_() && _aboveHighWatermark.exchange(false))
     {
-        const std::lock_guard<std::mutex> guard(_mutex);
-        _messagesToSend.swap(_messages);
+        const bool isLowWatermarkReached = _isHighWatermarkReported;
+        _isHighWatermarkReported = false;
+        return isLowWatermarkReached;
     }
-    return _messagesToSend;
+    return false;
 }
 
 } // namespace cli
@@ -24,10 +24,13 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <memory>
 #include <mutex>
-#include <queue>
 
 #include "LwsAdapter/ILwsConnection.hpp"
+#include "MpscQueue.hpp"
 
 namespace lwspp
 {
@@ -37,19 +40,82 @@ namespace cli
 class LwsConnection : public ILwsConnection
 {
 public:
-    explicit LwsConnection(LwsInstanceRawPtr);
+    LwsConnection(LwsInstanceRawPtr, QueueLimits);
 
     auto getLwsInstance() -> LwsInstanceRawPtr override;
+    auto getLwsContext() -> LwsContextRawPtr override;
+    auto getServiceThreadIndex() const -> int override;
 
-    void addBinaryDataToSend(const std::vector<char>&) override;
-    void addTextDataToSend(const std::string&) override;
-    auto getPendingData() -> std::queue<Message>& override;
+    auto wakeUpServiceThread() -> bool override;
+    void detachLwsInstance() override;
+    auto isLwsInstanceAttached() const -> bool override;
+
+    auto addDataToSend(Message) -> EnqueueResult override;
+    auto frontPendingData() -> Message* override;
+    auto hasPendingData() -> bool override;
+    auto popPendingData(size_t messageSize) -> bool override;
+    auto trimPendingData() -> bool override;
+    auto takeHighWatermark() -> bool override;
+    auto getReceiveBuffer() -> std::vector<char>& override;
+
+    void keepWrittenMessage(Message) override;
+    void releaseWrittenMessage() override;
+
+    void addCompressionStats(size_t uncompressedBytes, size_t compressedBytes,
+                             std::chrono::nanoseconds cpuTime) override;
+    auto getCompressionStats() const -> CompressionStats override;
+    void setDeflatePending(bool) override;
+    auto isDeflatePending() const -> bool override;
+
+    void markToClose(CloseReason) override;
+    auto getCloseReason() const -> CloseReason override;
+
+    auto markPendingWrite() -> bool override;
+    auto clearPendingWrite() -> bool override;
+
+    auto pauseReceiving() -> bool override;
+    auto resumeReceiving() -> bool override;
+    auto isReceivingPaused() const -> bool override;
+    auto takeReceivingChange() -> bool override;
+
+private:
+    auto isLimitReached_(size_t messageSize) const -> bool;
+    auto exceedsLimits_(size_t messages, size_t bytes) const -> bool;
+    auto isBelowLowWatermark_() const -> bool;
+    auto getLane_(Priority) -> MpscQueue<Message>&;
+    auto selectFrontLane_() -> MpscQueue<Message>*;
+    auto popMessage_(MpscQueue<Message>&, size_t messageSize) -> bool;
 
 private:
     LwsInstanceRawPtr _wsInstance;
-    std::queue<Message> _messages;
-    std::queue<Message> _messagesToSend;
-    std::mutex _mutex;
+    LwsContextRawPtr _lwsContext;
+    int _serviceThreadIndex;
+    // Keeps the lws instance from being destroyed while the other threads wake up its service
+    // thread, the instance is detached under the lock
+    std::mutex _instanceMutex;
+    bool _isInstanceAttached = true;
+    // The pending data lanes indexed by the priority
+    std::array<MpscQueue<Message>, 2> _lanes;
+    // The service thread only state of the lanes scheduling
+    Priority _frontLane = Priority::High;
+    bool _isFrontLaneSelected = false;
+    unsigned int _highPriorityInRow = 0;
+    QueueLimits _queueLimits;
+    std::atomic<size_t> _queuedMessages{0};
+    std::atomic<size_t> _queuedBytes{0};
+    std::atomic<bool> _aboveHighWatermark{false};
+    // The service thread only state, the high watermark is reported and the low one is not yet
+    bool _isHighWatermarkReported = false;
+    std::vector<char> _receiveBuffer;
+    std::unique_ptr<Message> _writtenMessage;
+    std::atomic<uint64_t> _uncompressedBytes{0};
+    std::atomic<uint64_t> _compressedBytes{0};
+    std::atomic<int64_t> _compressionCpuTime{0};
+    bool _isDeflatePending{false};
+    std::atomic<CloseReason> _closeReason{CloseReason::None};
+    std::atomic<bool> _pendingWrite{false};
+    std::atomic<bool> _isReceivingPaused{false};
+    std::atomic<bool> _receivingChanged{false};
 };
 
 } // namespace cli
@@ -0,0 +1,74 @@
+/*
+ * lwspp - C++ wrapper for the libwebsockets library
+ *
+ * Copyright (C) 2023 - 2023 Volodymyr Lotoshko <vlotoshko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "LwsAdapter/LwsContextSetup.hpp"
+#include "SslSettings.hpp" // IWYU pragma: keep
+
+namespace lwspp
+{
+namespace cli
+{
+
+void setupSslSettings(lws_context_creation_info& lwsContextInfo, const SslSettingsPtr& ssl)
+{
+    if (ssl != nullptr)
+    {
+        const auto options = static_cast<uint64_t>(LWS_SERVER_OPTION_DO_SSL_GLOBAL_INIT);
+
+        if (ssl->privateKeyPath != UNDEFINED_FILE_PATH)
+        {
+            lwsContextInfo.client_ssl_private_key_filepath = ssl->privateKeyPath.c_str();
+        }
+
+        if (ssl->certPath != UNDEFINED_FILE_PATH)
+        {
+            lwsContextInfo.client_ssl_cert_filepath = ssl->certPath.c_str();
+        }
+
+        if (ssl->caCertPath != UNDEFINED_FILE_PATH)
+        {
+            lwsContextInfo.client_ssl_ca_filepath = ssl->caCertPath.c_str();
+        }
+
+        if (!ssl->privateKeyPassword.empty())
+        {
+            lwsContextInfo.client_ssl_private_key_password= ssl->privateKeyPassword.c_str();
+        }
+
+        if (!ssl->ciphersList.empty())
+        {
+            lwsContextInfo.ssl_cipher_list = ssl->ciphersList.c_str();
+        }
+
+        if (!ssl->ciphersListTls13.empty())
+        {
+            lwsContextInfo.tls1_3_plus_cipher_list = ssl->ciphersListTls13.c_str();
+        }
+
+        lwsContextInfo.options = lwsContextInfo.options | options;
+    }
+}
+
+} // namespace cli
+} // namespace lwspp
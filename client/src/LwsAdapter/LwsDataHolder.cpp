@@ -23,6 +23,7 @@
  */
 
 #include "ClientContext.hpp"
+#include "LwsAdapter/LwsCompression.hpp"
 #include "LwsAdapter/LwsDataHolder.hpp"
 #include "LwsAdapter/LwsProtocolsFactory.hpp"
 
@@ -32,17 +33,22 @@ namespace cli
 {
 
 LwsDataHolder::LwsDataHolder(const ClientContext& context)
-    : address(context.address)
-    , port(context.port)
-    , path(context.path)
+    : callbackVersion(context.callbackVersion)
+    , endpoints({Endpoint{context.address, context.port, context.path}})
     , protocolName(context.protocolName)
-    , protocols(createLwsProtocols(context.callbackVersion))
+    , protocols(createLwsProtocols(context.callbackVersion, context.rxBufferSize,
+                                   context.txPacketSize))
     , ssl(context.ssl)
+    , compression(context.compression)
+    , compressionOffer(createCompressionOffer(compression))
+    , extensions(createLwsExtensions(compression, compressionOffer))
     , lwsLogLevel(context.lwsLogLevel)
     , keepAliveTimeout(context.keepAliveTimeout)
     , keepAliveProbesInterval(context.keepAliveProbesInterval)
     , keepAliveProbes(context.keepAliveProbes)
-{}
+{
+    endpoints.insert(endpoints.end(), context.connections.begin(), context.connections.end());
+}
 
 } // namespace cli
 } // namespace lwspp
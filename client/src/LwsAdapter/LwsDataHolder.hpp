@@ -24,6 +24,9 @@
 
 #pragma once
 
+#include <vector>
+
+#include "lwspp/client/CallbackVersions.hpp"
 #include "lwspp/client/Types.hpp"
 #include "LwsAdapter/LwsTypesFwd.hpp"
 #include "TypesFwd.hpp"
@@ -40,12 +43,16 @@ struct LwsDataHolder
 {
     explicit LwsDataHolder(const ClientContext&);
 
-    Address address;
-    Port port;
-    Path path;
+    CallbackVersion callbackVersion;
+    // The endpoints of the connections by the connection id
+    std::vector<Endpoint> endpoints;
     std::string protocolName;
     LwsProtocols protocols;
     SslSettingsPtr ssl;
+    CompressionSettingsPtr compression;
+    // The permessage-deflate parameters offered to the server
+    std::string compressionOffer;
+    LwsExtensions extensions;
     int lwsLogLevel = 0;
 
     int keepAliveTimeout = 0;
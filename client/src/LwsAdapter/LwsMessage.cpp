@@ -0,0 +1,118 @@
+/*
+ * lwspp - C++ wrapper for the libwebsockets library
+ *
+ * Copyright (C) 2023 - 2023 Volodymyr Lotoshko <vlotoshko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+
+#include "LwsAdapter/LwsMessage.hpp"
+#include "LwsAdapter/LwsTypesFwd.hpp" // IWYU pragma: keep
+
+namespace lwspp
+{
+namespace cli
+{
+
+/**
+ * @brief The SendBufferAccessor class takes the buffer out of the SendBuffer
+ */
+class SendBufferAccessor
+{
+public:
+    static auto release(SendBuffer& sendBuffer) -> std::string
+    {
+        std::string buffer = std::move(sendBuffer._buffer);
+        sendBuffer._buffer.clear();
+        if (buffer.empty())
+        {
+            buffer.resize(LWS_PRE);
+        }
+        return buffer;
+    }
+};
+
+namespace
+{
+
+// NOTE: Additional space with the size of LWS_PRE should be added in the front of the data
+// For more information please read lws_write description
+template <typename Container>
+auto makeMessageImpl(DataType dataType, const Container& data) -> Message
+{
+    std::string buffer;
+    // NOTE: resize can throw bad alloc if message is too large
+    buffer.resize(LWS_PRE + data.size());
+    std::copy(data.cbegin(), data.cend(), &buffer[0] + LWS_PRE);
+    return Message{dataType, Payload(std::move(buffer))};
+}
+
+} // namespace
+
+Payload::Payload(std::string buffer)
+    : _buffer(std::move(buffer))
+{}
+
+auto Payload::data() -> unsigned char*
+{
+    // C-style cast to convert from char* to unsigned char*
+    return (unsigned char*)(&_buffer[0] + LWS_PRE);
+}
+
+auto Payload::size() const -> size_t
+{
+    return _buffer.size() - LWS_PRE;
+}
+
+auto makeMessage(DataType dataType, const std::string& data) -> Message
+{
+    return makeMessageImpl(dataType, data);
+}
+
+auto makeMessage(DataType dataType, const std::vector<char>& data) -> Message
+{
+    return makeMessageImpl(dataType, data);
+}
+
+auto makeMessage(DataType dataType, SendBuffer&& data) -> Message
+{
+    return Message{dataType, Payload(SendBufferAccessor::release(data))};
+}
+
+auto makeStreamMessage(contract::IStreamProducerPtr producer) -> Message
+{
+    auto message = Message{DataType::Binary, Payload(std::string(LWS_PRE, '\0'))};
+    message.producer = std::move(producer);
+    return message;
+}
+
+auto getQueuedSize(const Message& message) -> size_t
+{
+    return message.producer == nullptr ? message.payload.size() : 0;
+}
+
+auto isWriteStarted(const Message& message) -> bool
+{
+    return message.isStreamStarted || message.writtenSize != 0;
+}
+
+} // namespace cli
+} // namespace lwspp
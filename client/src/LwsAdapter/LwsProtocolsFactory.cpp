@@ -22,6 +22,8 @@
  * IN THE SOFTWARE.
  */
 
+#include <stdexcept>
+
 #include "LwsAdapter/LwsCallback.hpp"
 #include "LwsAdapter/LwsProtocolsFactory.hpp"
 
@@ -34,9 +36,14 @@ namespace
 
 const lws_protocols LWS_PROTOCOL_TERM_LIST { nullptr, nullptr, 0, 0, 0, nullptr, 0 };
 
+const char* const RUNTIME_PROTOCOL_NAME = "lwspp-runtime";
+const char* const RUNTIME_PROTOCOL_NAME_V1 = "lwspp-runtime-v1";
+const char* const RUNTIME_PROTOCOL_NAME_V2 = "lwspp-runtime-v2";
+
 } // namespace
 
-auto createLwsProtocols(CallbackVersion version) -> LwsProtocols
+auto createLwsProtocols(CallbackVersion version, size_t rxBufferSize, size_t txPacketSize)
+-> LwsProtocols
 {
     LwsCallback* callback = nullptr;
 
@@ -45,6 +52,9 @@ auto createLwsProtocols(CallbackVersion version) -> LwsProtocols
     case CallbackVersion::v1_Amsterdam:
         callback = lwsCallback_v1;
         break;
+    case CallbackVersion::v2_Barcelona:
+        callback = lwsCallback_v2;
+        break;
     default:
         // TODO: throw exception unsupported version
         break;
@@ -55,14 +65,61 @@ auto createLwsProtocols(CallbackVersion version) -> LwsProtocols
             "/",
             callback,
             0, // per connection data size, not used
-            0, // rx buffer size
+            rxBufferSize, // rx buffer size
             static_cast<unsigned int>(version), // id
             nullptr, // pointer on user data
-            0 // tx packet size
+            txPacketSize // tx packet size
         },
         LWS_PROTOCOL_TERM_LIST
     };
 }
 
+auto createLwsRuntimeProtocols(size_t rxBufferSize, size_t txPacketSize) -> LwsProtocols
+{
+    return LwsProtocols {
+        {
+            RUNTIME_PROTOCOL_NAME,
+            lwsRuntimeCallback,
+            0, // per connection data size, not used
+            0, // rx buffer size, not used
+            0, // id
+            nullptr, // pointer on user data
+            0 // tx packet size, not used
+        },
+        {
+            RUNTIME_PROTOCOL_NAME_V1,
+            lwsRuntimeCallback_v1,
+            0, // per connection data size, not used
+            rxBufferSize, // rx buffer size
+            static_cast<unsigned int>(CallbackVersion::v1_Amsterdam), // id
+            nullptr, // pointer on user data
+            txPacketSize // tx packet size
+        },
+        {
+            RUNTIME_PROTOCOL_NAME_V2,
+            lwsRuntimeCallback_v2,
+            0, // per connection data size, not used
+            rxBufferSize, // rx buffer size
+            static_cast<unsigned int>(CallbackVersion::v2_Barcelona), // id
+            nullptr, // pointer on user data
+            txPacketSize // tx packet size
+        },
+        LWS_PROTOCOL_TERM_LIST
+    };
+}
+
+auto getRuntimeProtocolName(CallbackVersion version) -> const char*
+{
+    switch (version)
+    {
+    case CallbackVersion::v1_Amsterdam:
+        return RUNTIME_PROTOCOL_NAME_V1;
+    case CallbackVersion::v2_Barcelona:
+        return RUNTIME_PROTOCOL_NAME_V2;
+    default:
+        throw std::runtime_error{"unsupported callback version"};
+    }
+}
+
 } // namespace cli
 } // namespace lwspp
@@ -32,7 +32,14 @@ namespace lwspp
 namespace cli
 {
 
-auto createLwsProtocols(CallbackVersion) -> LwsProtocols;
+// The zero buffer sizes keep the libwebsockets defaults
+auto createLwsProtocols(CallbackVersion, size_t rxBufferSize, size_t txPacketSize) -> LwsProtocols;
+
+// The protocols of the context shared by the clients, see LwsClientRuntime. The first protocol
+// runs the callbacks of the context, the others run the callbacks of the client connections.
+auto createLwsRuntimeProtocols(size_t rxBufferSize, size_t txPacketSize) -> LwsProtocols;
+// The name of the runtime protocol running the client callbacks of the given version
+auto getRuntimeProtocolName(CallbackVersion) -> const char*;
 
 } // namespace cli
 } // namespace lwspp
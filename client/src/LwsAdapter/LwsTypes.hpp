@@ -27,18 +27,88 @@
 #include <cstdint>
 #include <string>
 
+#include "lwspp/client/Types.hpp"
+#include "lwspp/client/TypesFwd.hpp"
+
 namespace lwspp
 {
 namespace cli
 {
 
+// Limits the data written to the connection on a single writable event
+struct WriteBudget
+{
+    unsigned int maxMessages = 0;
+    size_t maxBytes = 0;
+    // The larger messages are written as fragments of this size, every fragment counts as
+    // the message. The zero value disables the fragmentation.
+    size_t maxFragmentSize = 0;
+};
+
+// Limits the data queued to the connection, the zero limit means no limit
+struct QueueLimits
+{
+    size_t maxMessages = 0;
+    size_t maxBytes = 0;
+    SlowConsumerPolicy policy = SlowConsumerPolicy::Reject;
+};
+
+struct EnqueueResult
+{
+    SendResult sendResult;
+    // The queue has reached its limits for the first time since it was drained
+    bool highWatermarkReached;
+};
+
+enum class CloseReason : uint8_t
+{
+    None,
+    SlowConsumer
+};
+
+// The options of the socket, the zero value keeps the system default
+struct SocketSettings
+{
+    int sendBufferSize = 0;
+    int receiveBufferSize = 0;
+    bool tcpNoDelay = true;
+};
+
 enum class DataType : uint8_t
 {
     Text,
     Binary
 };
 
-using Message = std::pair<DataType, std::string>;
+/**
+ * @brief The Payload class owns the message data with LWS_PRE bytes of the headroom in front
+ * of it, see lws_write description.
+ */
+class Payload
+{
+public:
+    // Takes the buffer which already has the headroom in front of the data
+    explicit Payload(std::string);
+
+    auto data() -> unsigned char*;
+    auto size() const -> size_t;
+
+private:
+    std::string _buffer;
+};
+
+struct Message
+{
+    DataType dataType;
+    Payload payload;
+    Priority priority{Priority::Bulk};
+    // The streamed message pulls the data from the producer, the payload is the chunk buffer
+    // reused for every chunk
+    contract::IStreamProducerPtr producer{};
+    bool isStreamStarted{false};
+    // The size of the data of the fragmented message written so far
+    size_t writtenSize{0};
+};
 
 } // namespace cli
 } // namespace lwspp
@@ -47,9 +47,11 @@ struct LwsDataHolder;
 using LwsDataHolderPtr = std::shared_ptr<LwsDataHolder>;
 
 using LwsInstanceRawPtr = lws*;
+using LwsContextRawPtr = lws_context*;
 using LowLevelContextPtr = std::shared_ptr<lws_context>;
 
 using LwsProtocols = std::vector<lws_protocols>;
+using LwsExtensions = std::vector<lws_extension>;
 using LwsCallback = lws_callback_function;
 using LwsConnectInfo = lws_client_connect_info;
 
@@ -0,0 +1,99 @@
+/*
+ * lwspp - C++ wrapper for the libwebsockets library
+ *
+ * Copyright (C) 2023 - 2023 Volodymyr Lotoshko <vlotoshko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <libwebsockets.h>
+
+#include "lwspp/client/SendBuffer.hpp"
+
+namespace lwspp
+{
+namespace cli
+{
+
+SendBuffer::SendBuffer() : _buffer(LWS_PRE, '\0')
+{}
+
+SendBuffer::SendBuffer(size_t size) : _buffer(LWS_PRE + size, '\0')
+{}
+
+auto SendBuffer::data() -> char*
+{
+    ensureHeadroom_();
+    return &_buffer[0] + LWS_PRE;
+}
+
+auto SendBuffer::data() const -> const char*
+{
+    return _buffer.empty() ? _buffer.data() : _buffer.data() + LWS_PRE;
+}
+
+auto SendBuffer::size() const -> size_t
+{
+    return _buffer.empty() ? 0 : _buffer.size() - LWS_PRE;
+}
+
+auto SendBuffer::empty() const -> bool
+{
+    return size() == 0;
+}
+
+void SendBuffer::resize(size_t size)
+{
+    ensureHeadroom_();
+    _buffer.resize(LWS_PRE + size);
+}
+
+void SendBuffer::reserve(size_t size)
+{
+    _buffer.reserve(LWS_PRE + size);
+}
+
+void SendBuffer::append(const char* data, size_t size)
+{
+    ensureHeadroom_();
+    _buffer.append(data, size);
+}
+
+void SendBuffer::append(const std::string& data)
+{
+    ensureHeadroom_();
+    _buffer.append(data);
+}
+
+void SendBuffer::clear()
+{
+    _buffer.resize(LWS_PRE);
+}
+
+void SendBuffer::ensureHeadroom_()
+{
+    // The buffer is left empty after it was moved from
+    if (_buffer.empty())
+    {
+        _buffer.resize(LWS_PRE);
+    }
+}
+
+} // namespace cli
+} // namespace lwspp
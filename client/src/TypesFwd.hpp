@@ -33,11 +33,30 @@ namespace cli
 
 class ClientContext;
 
+class ClientRuntimeContext;
+
+class ClientRuntime;
+using ClientRuntimePtr = std::shared_ptr<ClientRuntime>;
+
 class LwsClient;
 using LwsClientPtr = std::shared_ptr<LwsClient>;
 
+class LwsClientRuntime;
+using LwsClientRuntimePtr = std::shared_ptr<LwsClientRuntime>;
+
 class SslSettings;
 using SslSettingsPtr = std::shared_ptr<SslSettings>;
 
+class CompressionSettings;
+using CompressionSettingsPtr = std::shared_ptr<CompressionSettings>;
+
+namespace contract
+{
+
+class IClientLogic;
+using IClientLogicWeak = std::weak_ptr<IClientLogic>;
+
+} // namespace contract
+
 } // namespace cli
 } // namespace lwspp
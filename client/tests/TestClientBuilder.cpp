@@ -26,10 +26,17 @@
 #include <catch2/matchers/catch_matchers_all.hpp>
 
 #include "ClientContext.hpp"
+#include "ClientRuntimeContext.hpp"
+#include "CompressionSettings.hpp"
 #include "SslSettings.hpp"
+#include "lwspp/client/CompressionSettingsBuilder.hpp"
 #include "lwspp/client/ClientBuilder.hpp"
 #include "lwspp/client/ClientLogicBase.hpp"
+#include "lwspp/client/ClientRuntimeBuilder.hpp"
+#include "lwspp/client/IClientRuntime.hpp"
 #include "lwspp/client/SslSettingsBuilder.hpp"
+#include "lwspp/client/contract/IEventLoop.hpp"
+#include "lwspp/client/contract/IMultiClientLogic.hpp"
 
 namespace lwspp
 {
@@ -52,6 +59,22 @@ private:
     const ClientBuilder& _clientBuilder;
 };
 
+class TestClientRuntimeBuilder
+{
+public:
+    explicit TestClientRuntimeBuilder(const ClientRuntimeBuilder& runtimeBuidler)
+        : _runtimeBuilder(runtimeBuidler)
+    {}
+
+    auto getClientRuntimeContext() const -> const ClientRuntimeContext&
+    {
+        return *_runtimeBuilder._context;
+    }
+
+private:
+    const ClientRuntimeBuilder& _runtimeBuilder;
+};
+
 } // namespace cli
 } // namespace lwspp
 
@@ -82,6 +105,48 @@ const int KEEPALIVE_PROBES = 5;
 const int KEEPALIVE_PROBES_INTERVAL = 10;
 const int LWS_LOG_LEVEL = 9;
 const int LWS_LOG_LEVEL_DISABLE = 0;
+const unsigned int MAX_MESSAGES_PER_WRITE = 8;
+const size_t MAX_BYTES_PER_WRITE = 4096;
+const size_t MAX_FRAGMENT_SIZE = 1024;
+const size_t MAX_QUEUED_MESSAGES = 1000;
+const size_t MAX_QUEUED_BYTES = 1024 * 1024;
+const size_t STREAM_CHUNK_SIZE = 16 * 1024;
+const size_t MAX_MESSAGE_SIZE = 1024 * 1024;
+const int COMPRESSION_LEVEL = 6;
+const int COMPRESSION_WINDOW_BITS = 12;
+const int COMPRESSION_MEMORY_LEVEL = 4;
+const int COMPRESSION_INVALID_WINDOW_BITS = 8;
+const size_t RX_BUFFER_SIZE = 8192;
+const size_t TX_PACKET_SIZE = 16384;
+const int SOCKET_SEND_BUFFER_SIZE = 131072;
+const int SOCKET_RECEIVE_BUFFER_SIZE = 262144;
+const int INVALID_SOCKET_BUFFER_SIZE = -1;
+const unsigned int SERVICE_THREADS = 4;
+
+class EventLoop : public contract::IEventLoop
+{
+public:
+    void watchFd(int, short) noexcept override {}
+    void unwatchFd(int) noexcept override {}
+    void wakeUp() noexcept override {}
+};
+
+class MultiClientLogic : public contract::IMultiClientLogic
+{
+public:
+    void onFirstDataPacket(ConnectionId, size_t) noexcept override {}
+    void onBinaryDataReceive(ConnectionId, const DataPacket&) noexcept override {}
+    void onTextDataReceive(ConnectionId, const DataPacket&) noexcept override {}
+    void onConnect(ConnectionId, IConnectionInfoPtr) noexcept override {}
+    void onDisconnect(ConnectionId) noexcept override {}
+    void onError(ConnectionId, const std::string&) noexcept override {}
+    void onWarning(ConnectionId, const std::string&) noexcept override {}
+    void onWatermark(ConnectionId, Watermark) noexcept override {}
+};
+
+// The runtime which is not built by the ClientRuntimeBuilder
+class ForeignRuntime : public IClientRuntime
+{};
 
 auto toString(CallbackVersion version) -> std::string
 {
@@ -89,6 +154,8 @@ auto toString(CallbackVersion version) -> std::string
     {
     case CallbackVersion::v1_Amsterdam:
         return "v1_Andromeda";
+    case CallbackVersion::v2_Barcelona:
+        return "v2_Barcelona";
     default:
         return "Undefined";
     }
@@ -99,16 +166,49 @@ void compareClientContexts(const ClientContext& actual, const ClientContext& exp
     // Mandatory parameters
     REQUIRE(toString(actual.callbackVersion) == toString(expected.callbackVersion));
     REQUIRE(actual.clientLogic == expected.clientLogic);
+    REQUIRE(actual.multiClientLogic == expected.multiClientLogic);
     REQUIRE(actual.address == expected.address);
     REQUIRE(actual.port == expected.port);
 
     // Non-mandatory parameters
     REQUIRE(actual.protocolName == expected.protocolName);
     REQUIRE(actual.path == expected.path);
+    REQUIRE(actual.connections.size() == expected.connections.size());
+    for (size_t i = 0; i < actual.connections.size() && i < expected.connections.size(); ++i)
+    {
+        REQUIRE(actual.connections[i].address == expected.connections[i].address);
+        REQUIRE(actual.connections[i].port == expected.connections[i].port);
+        REQUIRE(actual.connections[i].path == expected.connections[i].path);
+    }
     REQUIRE(actual.keepAliveTimeout == expected.keepAliveTimeout);
     REQUIRE(actual.keepAliveProbes == expected.keepAliveProbes);
     REQUIRE(actual.keepAliveProbesInterval == expected.keepAliveProbesInterval);
     REQUIRE(actual.lwsLogLevel == expected.lwsLogLevel);
+    REQUIRE(actual.eventLoop == expected.eventLoop);
+    REQUIRE(actual.runtime == expected.runtime);
+    REQUIRE(actual.maxMessagesPerWrite == expected.maxMessagesPerWrite);
+    REQUIRE(actual.maxBytesPerWrite == expected.maxBytesPerWrite);
+    REQUIRE(actual.maxFragmentSize == expected.maxFragmentSize);
+    REQUIRE(actual.maxQueuedMessages == expected.maxQueuedMessages);
+    REQUIRE(actual.maxQueuedBytes == expected.maxQueuedBytes);
+    REQUIRE(actual.slowConsumerPolicy == expected.slowConsumerPolicy);
+    REQUIRE(actual.streamChunkSize == expected.streamChunkSize);
+    REQUIRE(actual.maxMessageSize == expected.maxMessageSize);
+    REQUIRE(actual.rxBufferSize == expected.rxBufferSize);
+    REQUIRE(actual.txPacketSize == expected.txPacketSize);
+    REQUIRE(actual.socketSendBufferSize == expected.socketSendBufferSize);
+    REQUIRE(actual.socketReceiveBufferSize == expected.socketReceiveBufferSize);
+    REQUIRE(actual.tcpNoDelay == expected.tcpNoDelay);
+    REQUIRE(((actual.compression != nullptr && expected.compression != nullptr) ||
+             (actual.compression == nullptr && expected.compression == nullptr)));
+
+    if (actual.compression != nullptr && expected.compression != nullptr)
+    {
+        REQUIRE(actual.compression->compressionLevel == expected.compression->compressionLevel);
+        REQUIRE(actual.compression->windowBits == expected.compression->windowBits);
+        REQUIRE(actual.compression->memoryLevel == expected.compression->memoryLevel);
+        REQUIRE(actual.compression->noContextTakeover == expected.compression->noContextTakeover);
+    }
     REQUIRE(((actual.ssl != nullptr && expected.ssl != nullptr) ||
              (actual.ssl == nullptr && expected.ssl == nullptr)));
 
@@ -139,6 +239,9 @@ SCENARIO( "ClientContext setup", "[client_builder]" )
         WHEN( "All parameters are set" )
         {
             auto handler = std::make_shared<ClientLogicBase>();
+            auto eventLoop = std::make_shared<EventLoop>();
+            auto runtime = std::make_shared<ForeignRuntime>();
+            auto multiClientLogic = std::make_shared<MultiClientLogic>();
             auto sslSettings = SslSettingsBuilder{}
                                    .setPrivateKeyFilepath(CLIENT_KEY_PATH)
                                    .setCertFilepath(CLIENT_CERT_PATH)
@@ -151,19 +254,43 @@ SCENARIO( "ClientContext setup", "[client_builder]" )
                                    .skipServerCertHostnameCheck()
                                    .ignoreServerCaSert()
                                    .build();
+            auto compressionSettings = CompressionSettingsBuilder{}
+                                           .setCompressionLevel(COMPRESSION_LEVEL)
+                                           .setWindowBits(COMPRESSION_WINDOW_BITS)
+                                           .setMemoryLevel(COMPRESSION_MEMORY_LEVEL)
+                                           .disableContextTakeover()
+                                           .build();
             clientBuilder
                 .setCallbackVersion(CallbackVersion::v1_Amsterdam)
                 .setAddress(ADDRESS)
                 .setPort(PORT)
                 .setClientLogic(handler)
+                .setMultiClientLogic(multiClientLogic)
                 .setClientControlAcceptor(handler)
                 .setProtocolName(PROTOCOL_NAME)
                 .setPath(PATH)
+                .addConnection(Endpoint{ADDRESS, PORT, PATH})
                 .setKeepAliveTimeout(KEEPALIVE_TIMEOUT)
                 .setKeepAliveProbes(KEEPALIVE_PROBES)
                 .setKeepAliveProbesInterval(KEEPALIVE_PROBES_INTERVAL)
                 .setLwsLogLevel(LWS_LOG_LEVEL)
-                .setSslSettings(sslSettings);
+                .setEventLoop(eventLoop)
+                .setRuntime(runtime)
+                .setMaxMessagesPerWrite(MAX_MESSAGES_PER_WRITE)
+                .setMaxBytesPerWrite(MAX_BYTES_PER_WRITE)
+                .setMaxFragmentSize(MAX_FRAGMENT_SIZE)
+                .setMaxQueuedMessages(MAX_QUEUED_MESSAGES)
+                .setMaxQueuedBytes(MAX_QUEUED_BYTES)
+                .setSlowConsumerPolicy(SlowConsumerPolicy::DropOldest)
+                .setStreamChunkSize(STREAM_CHUNK_SIZE)
+                .setMaxMessageSize(MAX_MESSAGE_SIZE)
+                .setRxBufferSize(RX_BUFFER_SIZE)
+                .setTxPacketSize(TX_PACKET_SIZE)
+                .setSocketSendBufferSize(SOCKET_SEND_BUFFER_SIZE)
+                .setSocketReceiveBufferSize(SOCKET_RECEIVE_BUFFER_SIZE)
+                .setTcpNoDelay(false)
+                .setSslSettings(sslSettings)
+                .setCompression(compressionSettings);
 
             const ClientContext& actual = TestClientBuilder{clientBuilder}.getClientContext();
 
@@ -174,8 +301,10 @@ SCENARIO( "ClientContext setup", "[client_builder]" )
                 expected.address = ADDRESS;
                 expected.port = PORT;
                 expected.clientLogic = handler;
+                expected.multiClientLogic = multiClientLogic;
                 expected.protocolName = PROTOCOL_NAME;
                 expected.path = PATH;
+                expected.connections.push_back(Endpoint{ADDRESS, PORT, PATH});
                 expected.ssl = std::make_shared<SslSettings>();
                 expected.ssl->privateKeyPath = CLIENT_KEY_PATH;
                 expected.ssl->certPath = CLIENT_CERT_PATH;
@@ -191,6 +320,26 @@ SCENARIO( "ClientContext setup", "[client_builder]" )
                 expected.keepAliveProbes = KEEPALIVE_PROBES;
                 expected.keepAliveProbesInterval = KEEPALIVE_PROBES_INTERVAL;
                 expected.lwsLogLevel = LWS_LOG_LEVEL;
+                expected.eventLoop = eventLoop;
+                expected.runtime = runtime;
+                expected.maxMessagesPerWrite = MAX_MESSAGES_PER_WRITE;
+                expected.maxBytesPerWrite = MAX_BYTES_PER_WRITE;
+                expected.maxFragmentSize = MAX_FRAGMENT_SIZE;
+                expected.maxQueuedMessages = MAX_QUEUED_MESSAGES;
+                expected.maxQueuedBytes = MAX_QUEUED_BYTES;
+                expected.slowConsumerPolicy = SlowConsumerPolicy::DropOldest;
+                expected.streamChunkSize = STREAM_CHUNK_SIZE;
+                expected.maxMessageSize = MAX_MESSAGE_SIZE;
+                expected.rxBufferSize = RX_BUFFER_SIZE;
+                expected.txPacketSize = TX_PACKET_SIZE;
+                expected.socketSendBufferSize = SOCKET_SEND_BUFFER_SIZE;
+                expected.socketReceiveBufferSize = SOCKET_RECEIVE_BUFFER_SIZE;
+                expected.tcpNoDelay = false;
+                expected.compression = std::make_shared<CompressionSettings>();
+                expected.compression->compressionLevel = COMPRESSION_LEVEL;
+                expected.compression->windowBits = COMPRESSION_WINDOW_BITS;
+                expected.compression->memoryLevel = COMPRESSION_MEMORY_LEVEL;
+                expected.compression->noContextTakeover = true;
 
                 compareClientContexts(actual, expected);
             }
@@ -338,6 +487,223 @@ SCENARIO( "Client construction", "[client_builder]" )
                                         "Required parameter is undefined: keep alive probes interval");
                 }
             }
+
+            AND_WHEN( "Max messages per write is zero" )
+            {
+                clientBuilder.setMaxMessagesPerWrite(0);
+
+                THEN( "Exception is thrown on client build" )
+                {
+                    REQUIRE_THROWS_WITH(clientBuilder.build(),
+                                        "Invalid parameter value: max messages per write");
+                }
+            }
+
+            AND_WHEN( "Max bytes per write is zero" )
+            {
+                clientBuilder.setMaxBytesPerWrite(0);
+
+                THEN( "Exception is thrown on client build" )
+                {
+                    REQUIRE_THROWS_WITH(clientBuilder.build(),
+                                        "Invalid parameter value: max bytes per write");
+                }
+            }
+
+            AND_WHEN( "Stream chunk size is zero" )
+            {
+                clientBuilder.setStreamChunkSize(0);
+
+                THEN( "Exception is thrown on client build" )
+                {
+                    REQUIRE_THROWS_WITH(clientBuilder.build(),
+                                        "Invalid parameter value: stream chunk size");
+                }
+            }
+
+            AND_WHEN( "Max message size is zero" )
+            {
+                clientBuilder.setMaxMessageSize(0);
+
+                THEN( "Exception is thrown on client build" )
+                {
+                    REQUIRE_THROWS_WITH(clientBuilder.build(),
+                                        "Invalid parameter value: max message size");
+                }
+            }
+
+            AND_WHEN( "Compression window bits is out of range" )
+            {
+                clientBuilder.setCompression(CompressionSettingsBuilder{}
+                                                 .setWindowBits(COMPRESSION_INVALID_WINDOW_BITS)
+                                                 .build());
+
+                THEN( "Exception is thrown on client build" )
+                {
+                    REQUIRE_THROWS_WITH(clientBuilder.build(),
+                                        "Invalid parameter value: compression window bits");
+                }
+            }
+
+            AND_WHEN( "Socket receive buffer size is negative" )
+            {
+                clientBuilder.setSocketReceiveBufferSize(INVALID_SOCKET_BUFFER_SIZE);
+
+                THEN( "Exception is thrown on client build" )
+                {
+                    REQUIRE_THROWS_WITH(clientBuilder.build(),
+                                        "Invalid parameter value: socket receive buffer size");
+                }
+            }
+
+            AND_WHEN( "Runtime is not built by the runtime builder" )
+            {
+                clientBuilder.setRuntime(std::make_shared<ForeignRuntime>());
+
+                THEN( "Exception is thrown on client build" )
+                {
+                    REQUIRE_THROWS_WITH(clientBuilder.build(),
+                                        "Invalid parameter value: runtime");
+                }
+            }
+
+            AND_WHEN( "Runtime is set with the event loop" )
+            {
+                clientBuilder
+                    .setRuntime(ClientRuntimeBuilder{}.build())
+                    .setEventLoop(std::make_shared<EventLoop>());
+
+                THEN( "Exception is thrown on client build" )
+                {
+                    REQUIRE_THROWS_WITH(clientBuilder.build(),
+                                        "Invalid parameter value: event loop");
+                }
+            }
+
+            AND_WHEN( "Multi client logic is set with the client logic" )
+            {
+                clientBuilder.setMultiClientLogic(std::make_shared<MultiClientLogic>());
+
+                THEN( "Exception is thrown on client build" )
+                {
+                    REQUIRE_THROWS_WITH(clientBuilder.build(),
+                                        "Invalid parameter value: multi client logic");
+                }
+            }
+
+            AND_WHEN( "Connection is added with the client logic" )
+            {
+                clientBuilder.addConnection(Endpoint{ADDRESS, PORT, PATH});
+
+                THEN( "Exception is thrown on client build" )
+                {
+                    REQUIRE_THROWS_WITH(clientBuilder.build(),
+                                        "Invalid parameter value: client logic");
+                }
+            }
+        }
+
+        WHEN( "Multi client logic and connections are set" )
+        {
+            auto handler = std::make_shared<ClientLogicBase>();
+            clientBuilder
+                .setCallbackVersion(CallbackVersion::v1_Amsterdam)
+                .setAddress(ADDRESS)
+                .setPort(PORT)
+                .setMultiClientLogic(std::make_shared<MultiClientLogic>())
+                .setClientControlAcceptor(handler)
+                .addConnection(Endpoint{ADDRESS, PORT, PATH});
+
+            THEN( "Client builds successfully" )
+            {
+                REQUIRE_NOTHROW(clientBuilder.build());
+            }
+
+            AND_WHEN( "Connection endpoint has no port" )
+            {
+                clientBuilder.addConnection(Endpoint{ADDRESS, UNDEFINED_PORT, PATH});
+
+                THEN( "Exception is thrown on client build" )
+                {
+                    REQUIRE_THROWS_WITH(clientBuilder.build(),
+                                        "Invalid parameter value: connection endpoint");
+                }
+            }
+
+            AND_WHEN( "Event loop is set" )
+            {
+                clientBuilder.setEventLoop(std::make_shared<EventLoop>());
+
+                THEN( "Exception is thrown on client build" )
+                {
+                    REQUIRE_THROWS_WITH(clientBuilder.build(),
+                                        "Invalid parameter value: event loop");
+                }
+            }
+        }
+    } // GIVEN
+} // SCENARIO
+
+SCENARIO( "ClientRuntimeContext setup", "[client_builder]" )
+{
+    GIVEN( "ClientRuntimeBuilder" )
+    {
+        auto runtimeBuilder = ClientRuntimeBuilder{};
+
+        WHEN( "All parameters are set" )
+        {
+            auto sslSettings = SslSettingsBuilder{}
+                                   .setPrivateKeyFilepath(CLIENT_KEY_PATH)
+                                   .setCertFilepath(CLIENT_CERT_PATH)
+                                   .build();
+            auto compressionSettings = CompressionSettingsBuilder{}.build();
+            runtimeBuilder
+                .setServiceThreads(SERVICE_THREADS)
+                .setSslSettings(sslSettings)
+                .setCompression(compressionSettings)
+                .setKeepAliveTimeout(KEEPALIVE_TIMEOUT)
+                .setKeepAliveProbes(KEEPALIVE_PROBES)
+                .setKeepAliveProbesInterval(KEEPALIVE_PROBES_INTERVAL)
+                .setLwsLogLevel(LWS_LOG_LEVEL)
+                .setRxBufferSize(RX_BUFFER_SIZE)
+                .setTxPacketSize(TX_PACKET_SIZE);
+
+            const ClientRuntimeContext& actual =
+                TestClientRuntimeBuilder{runtimeBuilder}.getClientRuntimeContext();
+
+            THEN( "Client runtime context has correct data" )
+            {
+                REQUIRE(actual.serviceThreads == SERVICE_THREADS);
+                REQUIRE(actual.ssl == sslSettings);
+                REQUIRE(actual.compression == compressionSettings);
+                REQUIRE(actual.keepAliveTimeout == KEEPALIVE_TIMEOUT);
+                REQUIRE(actual.keepAliveProbes == KEEPALIVE_PROBES);
+                REQUIRE(actual.keepAliveProbesInterval == KEEPALIVE_PROBES_INTERVAL);
+                REQUIRE(actual.lwsLogLevel == LWS_LOG_LEVEL);
+                REQUIRE(actual.rxBufferSize == RX_BUFFER_SIZE);
+                REQUIRE(actual.txPacketSize == TX_PACKET_SIZE);
+            }
+        }
+
+        WHEN( "No parameters are set" )
+        {
+            runtimeBuilder.setLwsLogLevel(LWS_LOG_LEVEL_DISABLE);
+
+            THEN( "Client runtime builds successfully" )
+            {
+                REQUIRE_NOTHROW(runtimeBuilder.build());
+            }
+        }
+
+        WHEN( "Service threads is zero" )
+        {
+            runtimeBuilder.setServiceThreads(0);
+
+            THEN( "Exception is thrown on client runtime build" )
+            {
+                REQUIRE_THROWS_WITH(runtimeBuilder.build(),
+                                    "Invalid parameter value: service threads");
+            }
         }
     } // GIVEN
 } // SCENARIO
@@ -61,14 +61,17 @@ void ChatMessageSender::sendUserMessage(const Message& message)
         {
             _serverControl->sendTextData(messageToSend);
         }
+        else if (message.to.connectionId != message.from.connectionId &&
+                 message.from.connectionId != srv::UNDEFINED_CONNECTION_ID)
+        {
+            // The recipient and the sender share the one message
+            const auto connectionIds = std::vector<srv::ConnectionId>{message.to.connectionId,
+                                                                      message.from.connectionId};
+            _serverControl->sendTextData(connectionIds, messageToSend);
+        }
         else
         {
             _serverControl->sendTextData(message.to.connectionId, messageToSend);
-            if (message.to.connectionId != message.from.connectionId &&
-                message.from.connectionId != srv::UNDEFINED_CONNECTION_ID)
-            {
-                _serverControl->sendTextData(message.from.connectionId, messageToSend);
-            }
         }
     }
 }
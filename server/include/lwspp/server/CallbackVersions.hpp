@@ -41,10 +41,12 @@ namespace srv
  */
 enum class CallbackVersion : uint8_t
 {
+    // Delivers the received data as it comes, a message can be split into several packets
     v1_Andromeda,
+    // Delivers the received message once and whole, the data packet contains the entire message
+    v2_BlackHole,
 
     // Reserved for future versions
-//    v2_BlackHole,
 //    v3_Chaos,
 //    v4_DarkEnergy,
 //    v5_Entropy,
@@ -0,0 +1,71 @@
+/*
+ * lwspp - C++ wrapper for the libwebsockets library
+ *
+ * Copyright (C) 2023 - 2023 Volodymyr Lotoshko <vlotoshko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "lwspp/server/TypesFwd.hpp"
+
+namespace lwspp
+{
+namespace srv
+{
+
+/**
+ * @brief The CompressionSettingsBuilder class constructs the permessage-deflate settings that can
+ * be utilized by the server builder to build a server compressing the sent messages. The messages
+ * are compressed only if the client supports the permessage-deflate extension.
+ */
+class CompressionSettingsBuilder
+{
+public:
+    CompressionSettingsBuilder();
+    ~CompressionSettingsBuilder();
+
+    CompressionSettingsBuilder(CompressionSettingsBuilder&&) noexcept;
+    auto operator=(CompressionSettingsBuilder&&) noexcept -> CompressionSettingsBuilder&;
+
+    CompressionSettingsBuilder(const CompressionSettingsBuilder&) = delete;
+    auto operator=(const CompressionSettingsBuilder&) -> CompressionSettingsBuilder& = delete;
+
+public:
+    auto build() const -> CompressionSettingsPtr;
+
+    // For more information please look for the deflateInit2 description of the zlib
+    // Compression level, from 0 (no compression) to 9 (best compression)
+    auto setCompressionLevel(int) -> CompressionSettingsBuilder&;
+    // Base two logarithm of the LZ77 window size, from 9 to 15
+    auto setWindowBits(int) -> CompressionSettingsBuilder&;
+    // Memory used for the internal compression state, from 1 (minimum) to 9 (maximum)
+    auto setMemoryLevel(int) -> CompressionSettingsBuilder&;
+
+    // Resets the compression context for each message, the server does not keep the LZ77 window
+    // between messages. Costs the compression ratio, saves the memory of the connection.
+    auto disableContextTakeover() -> CompressionSettingsBuilder&;
+
+private:
+    std::unique_ptr<CompressionSettings> _settings;
+};
+
+} // namespace srv
+} // namespace lwspp
@@ -31,8 +31,8 @@ namespace lwspp
 namespace srv
 {
 
-const ConnectionId UNDEFINED_CONNECTION_ID = static_cast<int>(0U - 1);
-const ConnectionId ALL_CONNECTIONS = static_cast<int>(0U - 2);
+const ConnectionId UNDEFINED_CONNECTION_ID = ~ConnectionId{0};
+const ConnectionId ALL_CONNECTIONS = ~ConnectionId{0} - 1;
 
 } // namespace srv
 } // namespace lwspp
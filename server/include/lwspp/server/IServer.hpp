@@ -35,7 +35,10 @@ namespace srv
  * Use the server builder to obtain an instance of the server implementation.
  *
  * @note The server starts listening upon construction and stops listening upon destruction.
- * @note The server operates within a separate thread to handle incoming connections.
+ * @note The server operates within a separate thread to handle incoming connections, or within
+ * several threads if it is configured with ServerBuilder::setServiceThreads.
+ * @note When the server is configured with ServerBuilder::setEventLoop, it has no thread of
+ * its own and is serviced by the external event loop through the methods below.
  */
 class IServer
 {
@@ -48,6 +51,16 @@ public:
 
     IServer(const IServer&) = delete;
     auto operator=(const IServer&) noexcept -> IServer& = delete;
+
+public:
+    // Services the poll events (POLLIN, POLLOUT, POLLHUP, ...) occurred on the socket watched by
+    // the external event loop. Must be called on the loop thread only.
+    virtual void serviceFd(int fd, short revents) = 0;
+    // Services the work of the server which is not bound to the sockets: the data sent from the
+    // other threads and the timeouts. Must be called on the loop thread only, when the loop is
+    // woken up and when the returned timeout in milliseconds expires. The zero timeout means
+    // the server has buffered data to process and should be serviced again immediately.
+    virtual auto service() -> int = 0;
 };
 
 } // namespace srv
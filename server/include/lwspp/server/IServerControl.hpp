@@ -27,7 +27,9 @@
 #include <string>
 #include <vector>
 
+#include "lwspp/server/SendBuffer.hpp"
 #include "lwspp/server/Types.hpp"
+#include "lwspp/server/TypesFwd.hpp"
 
 namespace lwspp
 {
@@ -52,21 +54,92 @@ public:
 
 public:
     // Sends text data to the specified client identified by ConnectionId.
-    // The provided text data should be valid UTF-8 text.
-    virtual void sendTextData(ConnectionId, const std::string&) = 0;
+    // The provided text data should be valid UTF-8 text. Returns whether the data is queued,
+    // see SlowConsumerPolicy.
+    virtual auto sendTextData(ConnectionId, const std::string&) -> SendResult = 0;
 
     // Sends binary data to the specified client identified by ConnectionId.
-    virtual void sendBinaryData(ConnectionId, const std::vector<char>&) = 0;
+    virtual auto sendBinaryData(ConnectionId, const std::vector<char>&) -> SendResult = 0;
 
-    // Sends text data to all connected clients.
-    //The provided text data should be valid UTF-8 text.
+    // Sends text data to all connected clients. The slow consumer policy applies to every
+    // connection separately. The provided text data should be valid UTF-8 text.
     virtual void sendTextData(const std::string&) = 0;
 
     // Sends binary data to all connected clients.
     virtual void sendBinaryData(const std::vector<char>&) = 0;
 
+    // Overloads taking the ownership of the data. The SendBuffer reserves the headroom required
+    // by the libwebsockets in front of the data, so it is queued without any copy. The string and
+    // the vector are always copied, serialize the data into the SendBuffer to avoid the copy.
+    virtual auto sendTextData(ConnectionId, SendBuffer&&) -> SendResult = 0;
+    virtual auto sendBinaryData(ConnectionId, SendBuffer&&) -> SendResult = 0;
+
+    virtual void sendTextData(SendBuffer&&) = 0;
+    virtual void sendBinaryData(SendBuffer&&) = 0;
+
+    // Sends the data to the specified client through the lane of the given priority, e.g. the
+    // urgent notice is not queued behind the bulk data.
+    virtual auto sendTextData(ConnectionId, const std::string&, Priority) -> SendResult = 0;
+    virtual auto sendBinaryData(ConnectionId, const std::vector<char>&, Priority) -> SendResult = 0;
+    virtual auto sendTextData(ConnectionId, SendBuffer&&, Priority) -> SendResult = 0;
+    virtual auto sendBinaryData(ConnectionId, SendBuffer&&, Priority) -> SendResult = 0;
+
+    // Streams the binary data pulled from the producer to the specified client in fragments,
+    // see contract::IStreamProducer and setStreamChunkSize option of the ServerBuilder.
+    virtual auto sendBinaryStream(ConnectionId, contract::IStreamProducerPtr) -> SendResult = 0;
+    // Resumes the stream parked by the not ready chunk of its producer, see StreamChunk. Can be
+    // called from any thread. Returns false for the unknown connection.
+    virtual auto resumeStream(ConnectionId) -> bool = 0;
+
+    // Sends the data conflated by the key to the specified client. The data replaces the not yet
+    // written data of the same key queued to the connection instead of being appended, so a slow
+    // client receives only the latest data per key. The replaced data keeps its place in the queue.
+    virtual auto sendTextData(ConnectionId, const ConflationKey&, const std::string&)
+    -> SendResult = 0;
+    virtual auto sendBinaryData(ConnectionId, const ConflationKey&, const std::vector<char>&)
+    -> SendResult = 0;
+    virtual auto sendTextData(ConnectionId, const ConflationKey&, SendBuffer&&) -> SendResult = 0;
+    virtual auto sendBinaryData(ConnectionId, const ConflationKey&, SendBuffer&&) -> SendResult = 0;
+
+    // Sends the data to the specified clients, the unknown clients are skipped. The payload is
+    // shared by the clients and the slow consumer policy applies to every client separately.
+    virtual void sendTextData(const std::vector<ConnectionId>&, const std::string&) = 0;
+    virtual void sendBinaryData(const std::vector<ConnectionId>&, const std::vector<char>&) = 0;
+    virtual void sendTextData(const std::vector<ConnectionId>&, SendBuffer&&) = 0;
+    virtual void sendBinaryData(const std::vector<ConnectionId>&, SendBuffer&&) = 0;
+
+    // Sends the data to all connected clients except the specified one, e.g. the sender of
+    // the data.
+    virtual void sendTextDataExcept(ConnectionId, const std::string&) = 0;
+    virtual void sendBinaryDataExcept(ConnectionId, const std::vector<char>&) = 0;
+    virtual void sendTextDataExcept(ConnectionId, SendBuffer&&) = 0;
+    virtual void sendBinaryDataExcept(ConnectionId, SendBuffer&&) = 0;
+
+    // Subscribes the specified client to the topic. The subscriptions of the client are removed
+    // when it disconnects. Returns false if the client is unknown.
+    virtual auto subscribe(ConnectionId, const Topic&) -> bool = 0;
+    virtual void unsubscribe(ConnectionId, const Topic&) = 0;
+
+    // Sends the data to all the clients subscribed to the topic. The payload is shared by the
+    // subscribers and the slow consumer policy applies to every subscriber separately.
+    virtual void publishTextData(const Topic&, const std::string&) = 0;
+    virtual void publishBinaryData(const Topic&, const std::vector<char>&) = 0;
+    virtual void publishTextData(const Topic&, SendBuffer&&) = 0;
+    virtual void publishBinaryData(const Topic&, SendBuffer&&) = 0;
+
+    // Pauses the reading from the specified client, so the TCP backpressure slows the client
+    // down instead of the received data piling up in the server, and resumes it. Can be called
+    // from any thread, the service thread pauses or resumes the reading shortly after.
+    // Returns false for the unknown connection.
+    virtual auto pauseReceiving(ConnectionId) -> bool = 0;
+    virtual auto resumeReceiving(ConnectionId) -> bool = 0;
+
     // Closes the specified client connection.
     virtual void closeConnection(ConnectionId) = 0;
+
+    // Returns the compression statistics of the specified client connection, see setCompression
+    // option of the ServerBuilder. Returns empty statistics for the unknown connection.
+    virtual auto getCompressionStats(ConnectionId) -> CompressionStats = 0;
 };
 
 } // namespace srv
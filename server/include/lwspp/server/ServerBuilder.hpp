@@ -70,6 +70,72 @@ public:
     auto setServerString(std::string) -> ServerBuilder&;
     auto setLwsLogLevel(int) -> ServerBuilder&;
 
+    // Number of threads servicing the connections. Connections are spread across the threads
+    // by the libwebsockets, each thread runs its own service loop. The libwebsockets library
+    // should be built with LWS_MAX_SMP > 1, otherwise the only one thread is used. With several
+    // threads the logic callbacks of different connections run concurrently, see
+    // contract::IServerLogic.
+    auto setServiceThreads(unsigned int) -> ServerBuilder&;
+
+    // Services the server sockets by the given external event loop instead of the server thread,
+    // see contract::IEventLoop. The loop calls IServer::serviceFd and IServer::service on its
+    // thread. Requires the single service thread and the libwebsockets built with
+    // LWS_WITH_EXTERNAL_POLL.
+    auto setEventLoop(contract::IEventLoopPtr) -> ServerBuilder&;
+
+    // Runs the server logic callbacks on the given number of worker threads instead of the
+    // service threads, so the slow logic does not hold the network I/O. The callbacks of every
+    // connection keep their order and are never run concurrently. The received data is copied
+    // for the workers. When the given number of the events of the connection waits for the
+    // workers, the reading from the connection is paused until the half of them is processed.
+    // The zero threads (the default) run the logic on the service threads.
+    auto setLogicThreads(unsigned int) -> ServerBuilder&;
+    auto setMaxQueuedLogicEvents(size_t) -> ServerBuilder&;
+
+    // Limits the data written to the connection on a single writable event. Queued messages are
+    // written one by one while the socket can take more data and none of the limits is reached.
+    // At least one message is written, even if it is larger than the bytes limit.
+    auto setMaxMessagesPerWrite(unsigned int) -> ServerBuilder&;
+    auto setMaxBytesPerWrite(size_t) -> ServerBuilder&;
+
+    // Splits the messages larger than the given size into fragments, every fragment counts as
+    // the message in the limits above. So the large message does not hold the service loop and
+    // the control frames are sent between its fragments. The zero value (the default) disables it.
+    auto setMaxFragmentSize(size_t) -> ServerBuilder&;
+
+    // Limits the data queued to every connection, the zero limit means no limit. The policy
+    // applies when the limit is reached, see SlowConsumerPolicy and IServerLogic::onWatermark.
+    auto setMaxQueuedMessages(size_t) -> ServerBuilder&;
+    auto setMaxQueuedBytes(size_t) -> ServerBuilder&;
+    auto setSlowConsumerPolicy(SlowConsumerPolicy) -> ServerBuilder&;
+
+    // The size of the chunk pulled from the stream producer, see IServerControl::sendBinaryStream
+    auto setStreamChunkSize(size_t) -> ServerBuilder&;
+
+    // Limits the size of the message reassembled for the CallbackVersion::V2, the connection is
+    // closed with the 1009 (message too big) status if the received message exceeds it.
+    // 16 MiB by default
+    auto setMaxMessageSize(size_t) -> ServerBuilder&;
+
+    // Enables the permessage-deflate extension, see CompressionSettingsBuilder
+    auto setCompression(CompressionSettingsPtr) -> ServerBuilder&;
+
+    // Socket and buffer tuning, the zero value keeps the libwebsockets or the system default.
+    // The rx buffer size is the largest data chunk passed to the receive callback, the tx packet
+    // size is the largest data chunk written to the socket at once.
+    auto setRxBufferSize(size_t) -> ServerBuilder&;
+    auto setTxPacketSize(size_t) -> ServerBuilder&;
+    // The SO_SNDBUF and SO_RCVBUF of the accepted sockets. The listening socket takes them too
+    // if the libwebsockets is built with LWS_WITH_EXTERNAL_POLL, so the accepted sockets have
+    // them from the handshake.
+    auto setSocketSendBufferSize(int) -> ServerBuilder&;
+    auto setSocketReceiveBufferSize(int) -> ServerBuilder&;
+    // Disables the Nagle's algorithm on the accepted sockets, enabled by default
+    auto setTcpNoDelay(bool) -> ServerBuilder&;
+    // The queue length of the pending connections of the listening socket. Requires the
+    // libwebsockets built with LWS_WITH_EXTERNAL_POLL, the server throws on construction otherwise.
+    auto setListenBacklog(int) -> ServerBuilder&;
+
 private:
     std::unique_ptr<ServerContext> _context;
 
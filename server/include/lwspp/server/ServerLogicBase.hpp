@@ -47,6 +47,7 @@ public:
     void onTextDataReceive(ConnectionId, const DataPacket&) noexcept override;
     void onError(ConnectionId, const std::string& errorMessage) noexcept override;
     void onWarning(ConnectionId, const std::string& warningMessage) noexcept override;
+    void onWatermark(ConnectionId, Watermark) noexcept override;
     
     void acceptServerControl(IServerControlPtr) noexcept override;
 
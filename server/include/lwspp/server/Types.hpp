@@ -24,6 +24,8 @@
 
 #pragma once
 
+#include <chrono>
+#include <cstdint>
 #include <string>
 
 namespace lwspp
@@ -33,9 +35,17 @@ namespace srv
 
 // TODO: consider strong types using
 using Port = int;
-using ConnectionId = int;
+// The connection id consists of the socket fd in the low 32 bits and the generation of the fd in
+// the high 32 bits. The socket fd is reused by the system, the generation is not, so the id of
+// the closed connection never refers to the new connection.
+using ConnectionId = uint64_t;
 using IP = std::string;
 using Path = std::string;
+// Identifies the data superseded by the newer data of the same key, e.g. the quote of the
+// instrument, see IServerControl
+using ConflationKey = std::string;
+// Names the group of the connections to publish the data to, see IServerControl
+using Topic = std::string;
 
 struct DataPacket
 {
@@ -49,5 +59,74 @@ struct DataPacket
     size_t remains = 0;
 };
 
+// Applies to the connection whose outbound queue reaches its limit, see setMaxQueuedMessages
+// and setMaxQueuedBytes options of the ServerBuilder
+enum class SlowConsumerPolicy : uint8_t
+{
+    // The data is not queued, the send returns SendResult::Rejected
+    Reject,
+    // The data is queued, the oldest queued messages are dropped to fit the limits
+    DropOldest,
+    // The data is dropped, the send returns SendResult::Dropped
+    DropNewest,
+    // The connection is closed with the policy violation close code
+    Disconnect
+};
+
+enum class SendResult : uint8_t
+{
+    Queued,
+    Rejected,
+    Dropped,
+    Disconnected,
+    UnknownConnection
+};
+
+// Selects the outbound lane of the connection. The high priority lane is written first, but it
+// gives way to the bulk lane periodically, so the bulk data is never starved. The data sent
+// without the priority goes to the bulk lane.
+enum class Priority : uint8_t
+{
+    High,
+    Bulk
+};
+
+// The outbound queue of the connection reaches its limit (High) or drains below the half
+// of the limits (Low)
+enum class Watermark : uint8_t
+{
+    High,
+    Low
+};
+
+// The chunk of the streamed data, see contract::IStreamProducer
+struct StreamChunk
+{
+    size_t size;
+    // The last chunk ends the message, it can be empty
+    bool isLast;
+    // The producer has no data yet, nothing is written and the stream is parked until
+    // IServerControl::resumeStream is called. The empty chunk which is not the last one parks
+    // the stream too.
+    bool isReady = true;
+};
+
+// The permessage-deflate statistics of the connection
+struct CompressionStats
+{
+    // Size of the sent data messages before and after compression.
+    uint64_t uncompressedBytes = 0;
+    uint64_t compressedBytes = 0;
+
+    // CPU time spent on the compression.
+    std::chrono::nanoseconds cpuTime{0};
+
+    auto ratio() const -> double
+    {
+        return compressedBytes == 0 ? 1.0 :
+                   static_cast<double>(uncompressedBytes) / static_cast<double>(compressedBytes);
+    }
+};
+
 } // namespace srv
 } // namespace lwspp
@@ -43,15 +43,24 @@ using IConnectionInfoPtr = std::shared_ptr<IConnectionInfo>;
 class SslSettings;
 using SslSettingsPtr = std::shared_ptr<SslSettings>;
 
+class CompressionSettings;
+using CompressionSettingsPtr = std::shared_ptr<CompressionSettings>;
+
 namespace contract
 {
 
+class IEventLoop;
+using IEventLoopPtr = std::shared_ptr<IEventLoop>;
+
 class IServerControlAcceptor;
 using IServerControlAcceptorPtr = std::shared_ptr<IServerControlAcceptor>;
 
 class IServerLogic;
 using IServerLogicPtr = std::shared_ptr<IServerLogic>;
 
+class IStreamProducer;
+using IStreamProducerPtr = std::shared_ptr<IStreamProducer>;
+
 } // namespace contract
 } // namespace srv
 } // namespace lwspp
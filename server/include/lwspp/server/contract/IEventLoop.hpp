@@ -0,0 +1,75 @@
+/*
+ * lwspp - C++ wrapper for the libwebsockets library
+ *
+ * Copyright (C) 2023 - 2023 Volodymyr Lotoshko <vlotoshko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+namespace lwspp
+{
+namespace srv
+{
+namespace contract
+{
+
+/**
+ * @brief The IEventLoop class defines an interface of the external event loop, which services
+ * the sockets of the server on its own thread instead of the server thread, see
+ * ServerBuilder::setEventLoop. Users of the library must implement this interface themselves.
+ *
+ * The loop polls the watched sockets and passes the occurred events to IServer::serviceFd,
+ * and calls IServer::service when it is woken up or the returned timeout expires. All the
+ * server callbacks are invoked on the loop thread then.
+ *
+ * @note The sockets are passed to the loop by the poll callbacks of the libwebsockets, which
+ * are emitted only if the libwebsockets is built with the LWS_WITH_EXTERNAL_POLL option (off by
+ * default). The server throws on construction with the external event loop otherwise.
+ *
+ * @note The sockets are also watched and unwatched while the server is created and destroyed,
+ * so the server should be created and destroyed on the loop thread as well.
+ */
+class IEventLoop
+{
+public:
+    IEventLoop() = default;
+    virtual ~IEventLoop() = default;
+
+    IEventLoop(IEventLoop&&) = default;
+    auto operator=(IEventLoop&&) noexcept -> IEventLoop& = default;
+
+    IEventLoop(const IEventLoop&) = delete;
+    auto operator=(const IEventLoop&) noexcept -> IEventLoop& = delete;
+
+public:
+    // Invoked on the loop thread when the socket should be watched for the given poll events
+    // (POLLIN, POLLOUT), and when the events of the watched socket are changed.
+    virtual void watchFd(int fd, short events) noexcept = 0;
+    // Invoked on the loop thread when the socket should not be watched anymore.
+    virtual void unwatchFd(int fd) noexcept = 0;
+    // Invoked from any thread when the server has work for the loop thread, e.g. the data
+    // to send. The loop should call IServer::service on its thread soon.
+    virtual void wakeUp() noexcept = 0;
+};
+
+} // namespace contract
+} // namespace srv
+} // namespace lwspp
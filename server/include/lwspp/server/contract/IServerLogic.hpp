@@ -39,6 +39,16 @@ namespace contract
 /**
  * @brief The IServerLogic class defines an interface for implementing server behavior.
  * Users of the library must implement this interface themselves.
+ *
+ * The callbacks are invoked by the service threads, see ServerBuilder::setServiceThreads, or by
+ * the logic threads, see ServerBuilder::setLogicThreads. The callbacks of one connection are never
+ * run concurrently, but with several threads the callbacks of different connections run
+ * concurrently on different threads, so the state shared between connections must be
+ * synchronized by the implementation.
+ *
+ * @note The only exception is onWatermark with Watermark::High. Without the logic threads it is
+ * invoked by the thread sending the data, so it may run concurrently with the other callbacks
+ * of the same connection.
  */
 class IServerLogic
 {
@@ -64,6 +74,12 @@ public:
     virtual void onDisconnect(ConnectionId) noexcept = 0;
     virtual void onError(ConnectionId, const std::string& errorMessage) noexcept = 0;
     virtual void onWarning(ConnectionId, const std::string& errorMessage) noexcept = 0;
+
+    // Invoked when the outbound queue of the connection crosses its watermark. Both watermarks
+    // are reported by the service thread of the connection (or by the logic thread if the logic
+    // threads are set), so the high one always comes before the low one. Does nothing by default,
+    // the queue limits are optional.
+    virtual void onWatermark(ConnectionId, Watermark) noexcept {}
 };
 
 } // namespace contract
@@ -0,0 +1,68 @@
+/*
+ * lwspp - C++ wrapper for the libwebsockets library
+ *
+ * Copyright (C) 2023 - 2023 Volodymyr Lotoshko <vlotoshko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "lwspp/server/Types.hpp"
+
+namespace lwspp
+{
+namespace srv
+{
+namespace contract
+{
+
+/**
+ * @brief Produces the binary data streamed in fragments, see sendBinaryStream.
+ *
+ * The data is pulled chunk by chunk by the service thread when the connection becomes writable,
+ * so the data is never buffered whole. The chunk is written as the websocket frame of the one
+ * message, no other data is sent to the connection until the last chunk is written. The producer
+ * without the data at hand returns the not ready chunk and calls IServerControl::resumeStream
+ * when the data arrives.
+ * Users of the library must implement this interface themselves.
+ */
+class IStreamProducer
+{
+public:
+    IStreamProducer() = default;
+    virtual ~IStreamProducer() = default;
+
+    IStreamProducer(const IStreamProducer&) = default;
+    auto operator=(const IStreamProducer&) noexcept -> IStreamProducer& = default;
+
+    IStreamProducer(IStreamProducer&&) = default;
+    auto operator=(IStreamProducer&&) noexcept -> IStreamProducer& = default;
+
+public:
+    // Writes the next chunk of the data into the buffer of the given capacity. Invoked by the
+    // service thread, so it should not block.
+    virtual auto produceChunk(char* buffer, size_t capacity) noexcept -> StreamChunk = 0;
+};
+
+} // namespace contract
+} // namespace srv
+} // namespace lwspp
@@ -27,6 +27,7 @@
 #include <string>
 
 #include "lwspp/server/CallbackVersions.hpp"
+#include "lwspp/server/Consts.hpp"
 #include "lwspp/server/Types.hpp"
 
 namespace lwspp
@@ -40,11 +41,39 @@ const std::string UNDEFINED_FILE_PATH = "UNDEFINED_FILE_PATH";
 const std::string UNDEFINED_NAME = "UNDEFINED_NAME";
 const int UNDEFINED_UNSET = 0;
 
-const ConnectionId ALL_CONNECTIONS = static_cast<int>(0U - 1);
 const unsigned int MAX_PATH_SIZE = 1024 * 4;
 const std::string DEFAULT_PROTOCOL_NAME = "/";
 // 7 = LLL_ERR | LLL_WARN | LLL_NOTICE - default value for the libwebsockets 4.3.2
 const int DEFAULT_LWS_LOG_LEVEL = 7;
+const unsigned int DEFAULT_MAX_MESSAGES_PER_WRITE = 32;
+const size_t DEFAULT_MAX_BYTES_PER_WRITE = 64 * 1024;
+const size_t DEFAULT_MAX_FRAGMENT_SIZE = 0;
+const size_t DEFAULT_STREAM_CHUNK_SIZE = 64 * 1024;
+const size_t DEFAULT_MAX_MESSAGE_SIZE = 16 * 1024 * 1024;
+const SlowConsumerPolicy DEFAULT_SLOW_CONSUMER_POLICY = SlowConsumerPolicy::Reject;
+// The receive buffer of greater capacity is released after the message is delivered. The frame
+// length declared by the peer is also reserved in advance up to this size only
+const size_t MAX_RETAINED_RECEIVE_BUFFER = 1024 * 1024;
+
+// The permessage-deflate defaults of the libwebsockets
+const int DEFAULT_COMPRESSION_LEVEL = 1;
+const int DEFAULT_COMPRESSION_WINDOW_BITS = 15;
+const int DEFAULT_COMPRESSION_MEMORY_LEVEL = 8;
+const int MIN_COMPRESSION_LEVEL = 0;
+const int MAX_COMPRESSION_LEVEL = 9;
+// The 8 window bits are not supported by the deflate compressor
+const int MIN_COMPRESSION_WINDOW_BITS = 9;
+const int MAX_COMPRESSION_WINDOW_BITS = 15;
+const int MIN_COMPRESSION_MEMORY_LEVEL = 1;
+const int MAX_COMPRESSION_MEMORY_LEVEL = 9;
+const unsigned int DEFAULT_SERVICE_THREADS = 1;
+// The longest wait of the external event loop, the lws timeouts are checked once a second
+const int MAX_EVENT_LOOP_TIMEOUT_MS = 1000;
+// The logic is run by the service threads by default
+const unsigned int DEFAULT_LOGIC_THREADS = 0;
+const size_t DEFAULT_MAX_QUEUED_LOGIC_EVENTS = 1024;
+// The libwebsockets disables the Nagle's algorithm on its sockets
+const bool DEFAULT_TCP_NO_DELAY = true;
 
 } // namespace srv
 } // namespace lwspp
@@ -24,6 +24,7 @@
 
 #pragma once
 
+#include "LwsAdapter/LwsTypes.hpp"
 #include "LwsAdapter/LwsTypesFwd.hpp"
 #include "lwspp/server/TypesFwd.hpp"
 
@@ -50,7 +51,20 @@ public:
 public:
     virtual void setStopping() = 0;
     virtual auto isStopping() const -> bool = 0;
+    virtual auto getWriteBudget() const -> WriteBudget = 0;
+    virtual auto getQueueLimits() const -> QueueLimits = 0;
+    // The size of the chunk buffer of the streamed message
+    virtual auto getStreamChunkSize() const -> size_t = 0;
+    // The limit of the reassembled received message
+    virtual auto getMaxMessageSize() const -> size_t = 0;
+    // Returns nullptr if the compression is disabled
+    virtual auto getCompressionSettings() const -> const CompressionSettingsPtr& = 0;
+    virtual auto getSocketSettings() const -> const SocketSettings& = 0;
+    // Returns nullptr if the server runs its own service loop
+    virtual auto getEventLoop() const -> const contract::IEventLoopPtr& = 0;
     virtual auto getConnections() -> ILwsConnectionsPtr = 0;
+    virtual auto getTopics() -> ILwsTopicsPtr = 0;
+    virtual auto getPendingWrites() -> ILwsPendingWritesPtr = 0;
 
     virtual auto getServerLogic() -> contract::IServerLogicPtr = 0;
 };
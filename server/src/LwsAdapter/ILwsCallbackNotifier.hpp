@@ -52,6 +52,10 @@ public:
     virtual void notifyPendingDataAdded(const ILwsConnectionPtr&) = 0;
     // Notifies that pending data was added to send to the all connections.
     virtual void notifyPendingDataAdded() = 0;
+    // Notifies that pending data was added to send to the given connections.
+    virtual void notifyPendingDataAdded(const std::vector<ILwsConnectionPtr>&) = 0;
+    // Notifies that the reading from the connection should be paused or resumed.
+    virtual void notifyReceivingChanged(const ILwsConnectionPtr&) = 0;
     // Notifies that this connection should be closed.
     virtual void notifyCloseConnection(const ILwsConnectionPtr&) = 0;
 };
@@ -36,6 +36,7 @@ namespace srv
 
 /**
  * @brief The ILwsConnections class represents a container for storing and accessing all ILwsConnection instances.
+ * The connections are added and removed by the service threads only, any thread can access them.
  */
 class ILwsConnections
 {
@@ -50,10 +51,17 @@ public:
     auto operator=(ILwsConnections&&) noexcept -> ILwsConnections& = default;
 
 public:
+    // Creates the id for the new connection with the given socket fd
+    virtual auto makeConnectionId(int socketFd) -> ConnectionId = 0;
+
     virtual void add(ILwsConnectionPtr) = 0;
     virtual void remove(ConnectionId) = 0;
     virtual auto get(ConnectionId) -> ILwsConnectionPtr = 0;
-    virtual auto getAllConnections() -> std::vector<ILwsConnectionPtr> = 0;
+    // Returns the connections of the given ids in a single pass, the unknown ids are skipped and
+    // the duplicated ones are returned once
+    virtual auto get(const std::vector<ConnectionId>&) -> std::vector<ILwsConnectionPtr> = 0;
+    // Returns the immutable snapshot of the current connections
+    virtual auto getAllConnections() -> ConnectionsSnapshotPtr = 0;
 };
 
 } // namespace srv
@@ -0,0 +1,65 @@
+/*
+ * lwspp - C++ wrapper for the libwebsockets library
+ *
+ * Copyright (C) 2023 - 2023 Volodymyr Lotoshko <vlotoshko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "LwsAdapter/LwsTypesFwd.hpp"
+#include "lwspp/server/TypesFwd.hpp"
+
+namespace lwspp
+{
+namespace srv
+{
+
+/**
+ * @brief The ILwsPendingWrites class collects the connections which have data to send, so the
+ * service threads can request the writable callbacks for them. The libwebsockets does not allow
+ * to request the writable callback from the other threads.
+ */
+class ILwsPendingWrites
+{
+public:
+    ILwsPendingWrites() = default;
+    virtual ~ILwsPendingWrites() = default;
+
+    ILwsPendingWrites(const ILwsPendingWrites&) = default;
+    auto operator=(const ILwsPendingWrites&) -> ILwsPendingWrites& = default;
+
+    ILwsPendingWrites(ILwsPendingWrites&&) noexcept = default;
+    auto operator=(ILwsPendingWrites&&) noexcept -> ILwsPendingWrites& = default;
+
+public:
+    // Can be called from any thread. Return true if the service thread of the connection
+    // should be woken up, false if the wake up is already requested.
+    virtual auto add(const ILwsConnectionPtr&) -> bool = 0;
+    virtual auto addAllConnections() -> bool = 0;
+
+    // Service thread only. Requests the writable callbacks for the pending connections
+    // which belong to the given service thread, and pauses or resumes their reading.
+    // The low watermark reached by dropping the oldest messages is reported to the logic.
+    virtual void requestWritable(int serviceThreadIndex, contract::IServerLogic&) = 0;
+};
+
+} // namespace srv
+} // namespace lwspp
@@ -0,0 +1,62 @@
+/*
+ * lwspp - C++ wrapper for the libwebsockets library
+ *
+ * Copyright (C) 2023 - 2023 Volodymyr Lotoshko <vlotoshko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "lwspp/server/Types.hpp"
+#include "LwsAdapter/LwsTypesFwd.hpp"
+
+namespace lwspp
+{
+namespace srv
+{
+
+/**
+ * @brief The ILwsTopics class represents the index of the topic subscriptions. Any thread can
+ * subscribe, unsubscribe and get the subscribers, the service threads remove the closed connections.
+ */
+class ILwsTopics
+{
+public:
+    ILwsTopics() = default;
+    virtual ~ILwsTopics() = default;
+
+    ILwsTopics(const ILwsTopics&) = default;
+    auto operator=(const ILwsTopics&) -> ILwsTopics& = default;
+
+    ILwsTopics(ILwsTopics&&) noexcept = default;
+    auto operator=(ILwsTopics&&) noexcept -> ILwsTopics& = default;
+
+public:
+    // Returns false if the connection is unknown or already closed
+    virtual auto subscribe(ConnectionId, const Topic&) -> bool = 0;
+    virtual void unsubscribe(ConnectionId, const Topic&) = 0;
+    // Removes all the subscriptions of the closed connection
+    virtual void removeConnection(ConnectionId) = 0;
+    // Returns the immutable snapshot of the current subscribers of the topic
+    virtual auto getSubscribers(const Topic&) -> ConnectionsSnapshotPtr = 0;
+};
+
+} // namespace srv
+} // namespace lwspp
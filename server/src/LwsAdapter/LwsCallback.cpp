@@ -22,15 +22,28 @@
  * IN THE SOFTWARE.
  */
 
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <exception>
+#include <vector>
 
+#include "CompressionSettings.hpp"
 #include "ConnectionInfo.hpp"
 #include "Consts.hpp"
 #include "LwsAdapter/ILwsCallbackContext.hpp"
-#include "LwsAdapter/ILwsConnections.hpp" // IWYU pragma: keep
+#include "LwsAdapter/ILwsConnection.hpp"
+#include "LwsAdapter/ILwsConnections.hpp"   // IWYU pragma: keep
+#include "LwsAdapter/ILwsPendingWrites.hpp" // IWYU pragma: keep
+#include "LwsAdapter/ILwsTopics.hpp"        // IWYU pragma: keep
 #include "LwsAdapter/LwsCallback.hpp"
+#include "LwsAdapter/LwsCompression.hpp"
 #include "LwsAdapter/LwsConnection.hpp"
-#include "lwspp/server/contract/IServerLogic.hpp" // IWYU pragma: keep
+#include "LwsAdapter/LwsMessage.hpp"
+#include "LwsAdapter/LwsSocket.hpp"
+#include "lwspp/server/contract/IEventLoop.hpp"      // IWYU pragma: keep
+#include "lwspp/server/contract/IServerLogic.hpp"    // IWYU pragma: keep
+#include "lwspp/server/contract/IStreamProducer.hpp" // IWYU pragma: keep
 
 namespace lwspp
 {
@@ -47,9 +60,11 @@ auto getCallbackContext(lws* wsInstance) -> ILwsCallbackContext&
     return *(reinterpret_cast<ILwsCallbackContext *>(contextData));
 }
 
-auto getConnectionId(lws* wsInstance) -> ConnectionId
+// The session is kept in the per session data, it is set when the connection is established.
+// The per session data is absent for the callbacks not bound to the connection.
+auto getConnectionId(const LwsSession* session) -> ConnectionId
 {
-    return lws_get_socket_fd(wsInstance);
+    return session != nullptr ? session->connectionId : UNDEFINED_CONNECTION_ID;
 }
 
 auto getConnectionIP(lws* wsInstance) -> IP
@@ -69,37 +84,311 @@ auto getConnectionPath(lws* wsInstance) -> Path
     return static_cast<Path>(buffer.data());
 }
 
-auto sendMessage(lws* wsInstance, const Message& message) -> bool
+// Returns the data of the message to be written by lws_write. The payload shared with the other
+// connections is copied into the write buffer of the connection along with the headroom, because
+// lws_write writes the frame header in front of the data and the other service threads may write
+// the same payload at the same time. The payload owned by the message alone is written in place.
+auto getWritableData(ILwsConnection& connection, const Message& message, size_t offset,
+                     size_t size) -> unsigned char*
 {
-    // C-style cast to convert from const char* to unsigned char*
-    auto* messageBegin = (unsigned char*)(message.second.data() + LWS_PRE);
-    const int expectedSize = static_cast<int>(message.second.size() - LWS_PRE);
+    auto* data = message.payload->data() + offset;
+    if (message.payload.use_count() == 1)
+    {
+        // The reads of the connections which have released the payload happen before the writes
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return data;
+    }
+
+    auto& buffer = connection.getWriteBuffer();
+    buffer.resize(LWS_PRE + size);
+    std::copy_n(data, size, buffer.data() + LWS_PRE);
+    return buffer.data() + LWS_PRE;
+}
+
+auto sendMessage(lws* wsInstance, ILwsConnection& connection, const Message& message) -> bool
+{
+    const size_t size = message.payload->size();
+    auto* messageBegin = getWritableData(connection, message, 0, size);
+    const int expectedSize = static_cast<int>(size);
+
+    auto writeProtocol = message.dataType == DataType::Text ? LWS_WRITE_TEXT : LWS_WRITE_BINARY;
 
-    auto writeProtocol = message.first == DataType::Text ? LWS_WRITE_TEXT : LWS_WRITE_BINARY;
-    const int actualSize = lws_write(wsInstance, messageBegin, expectedSize, writeProtocol);
+    const int actualSize = lws_write(wsInstance, messageBegin, size, writeProtocol);
     return expectedSize == actualSize;
 }
 
-} // namespace
+// Drains the compressed output left by the permessage-deflate extension. The libwebsockets takes
+// the output of the extension by the empty write, the opcode of the drained message is reused.
+auto flushDeflate(lws* wsInstance) -> bool
+{
+    std::array<unsigned char, LWS_PRE> buffer{};
+    return lws_write(wsInstance, buffer.data() + LWS_PRE, 0, LWS_WRITE_CONTINUATION) >= 0;
+}
 
-auto lwsCallback_v1(
+// Writes the next fragment of the message. The lws_write writes the frame header in front of
+// the fragment, over the data written before, so the fragment of the shared payload is copied
+// into the write buffer of the connection, see getWritableData.
+auto sendFragment(lws* wsInstance, ILwsConnection& connection, Message& message,
+                  size_t fragmentSize) -> bool
+{
+    const size_t offset = message.writtenSize;
+    const bool isLast = offset + fragmentSize == message.payload->size();
+    message.writtenSize += fragmentSize;
+
+    int writeProtocol = message.dataType == DataType::Text ? LWS_WRITE_TEXT : LWS_WRITE_BINARY;
+    writeProtocol = offset == 0 ? writeProtocol : LWS_WRITE_CONTINUATION;
+    writeProtocol = isLast ? writeProtocol : writeProtocol | LWS_WRITE_NO_FIN;
+
+    auto* fragment = getWritableData(connection, message, offset, fragmentSize);
+    const int expectedSize = static_cast<int>(fragmentSize);
+    const int actualSize = lws_write(wsInstance, fragment, fragmentSize,
+                                     static_cast<lws_write_protocol>(writeProtocol));
+    return expectedSize == actualSize;
+}
+
+// Pulls the next chunk of the streamed message into the chunk buffer of the message
+auto produceStreamChunk(Message& message, size_t chunkSize) -> StreamChunk
+{
+    if (message.payload == nullptr)
+    {
+        message.payload = std::make_shared<Payload>(std::string(LWS_PRE + chunkSize, '\0'));
+    }
+
+    auto& payload = *message.payload;
+    auto chunk = message.producer->produceChunk(reinterpret_cast<char*>(payload.data()),
+                                                payload.size());
+    chunk.size = std::min(chunk.size, payload.size());
+    return chunk;
+}
+
+// Writes the chunk as the fragment of the streamed message, the message is ended by the last one
+auto sendStreamChunk(lws* wsInstance, Message& message, const StreamChunk& chunk) -> bool
+{
+    const int opcode = message.isStreamStarted ? LWS_WRITE_CONTINUATION : LWS_WRITE_BINARY;
+    const int writeProtocol = chunk.isLast ? opcode : opcode | LWS_WRITE_NO_FIN;
+    message.isStreamStarted = true;
+
+    const int expectedSize = static_cast<int>(chunk.size);
+    const int actualSize = lws_write(wsInstance, message.payload->data(), chunk.size,
+                                     static_cast<lws_write_protocol>(writeProtocol));
+    return expectedSize == actualSize;
+}
+
+// Writes the pending messages while the socket can take more data and the write budget
+// is not exhausted. Returns false on the write error.
+auto sendPendingData(lws* wsInstance, ILwsConnection& connection,
+                     ILwsCallbackContext& callbackContext) -> bool
+{
+    if (connection.takeHighWatermark())
+    {
+        callbackContext.getServerLogic()->onWatermark(connection.getConnectionId(),
+                                                      Watermark::High);
+    }
+
+    // The compressed output of the previous message is drained first, the message data is kept
+    // until then
+    if (connection.isDeflatePending())
+    {
+        if (!flushDeflate(wsInstance))
+        {
+            return false;
+        }
+        if (connection.isDeflatePending())
+        {
+            lws_callback_on_writable(wsInstance);
+            return true;
+        }
+    }
+    connection.releaseWrittenMessage();
+    if (connection.trimPendingData())
+    {
+        callbackContext.getServerLogic()->onWatermark(connection.getConnectionId(), Watermark::Low);
+    }
+
+    const auto budget = callbackContext.getWriteBudget();
+    unsigned int messagesWritten = 0;
+    size_t bytesWritten = 0;
+
+    while (!callbackContext.isStopping())
+    {
+        auto* message = connection.frontPendingData();
+        if (message == nullptr)
+        {
+            return true;
+        }
+
+        if (message->producer != nullptr)
+        {
+            const auto chunk = produceStreamChunk(*message, callbackContext.getStreamChunkSize());
+            // The parked stream is not polled, the producer resumes it when the data arrives.
+            // NOTE: The writable request is made by the resume, so nothing else is requested here
+            if (!chunk.isReady || (chunk.size == 0 && !chunk.isLast))
+            {
+                return true;
+            }
+
+            if (!sendStreamChunk(wsInstance, *message, chunk))
+            {
+                return false;
+            }
+            bytesWritten += chunk.size;
+
+            // NOTE: The chunk buffer is reused by the next chunk, so the compressed output of
+            // the chunk should be drained on the next writable events first
+            if (chunk.isLast)
+            {
+                if (connection.isDeflatePending())
+                {
+                    connection.keepWrittenMessage(std::move(*message));
+                }
+                if (connection.popPendingData(0))
+                {
+                    callbackContext.getServerLogic()->onWatermark(connection.getConnectionId(),
+                                                                  Watermark::Low);
+                }
+            }
+
+            if (connection.isDeflatePending() ||
+                ++messagesWritten >= budget.maxMessages || bytesWritten >= budget.maxBytes ||
+                lws_send_pipe_choked(wsInstance) != 0)
+            {
+                break;
+            }
+            continue;
+        }
+
+        const size_t messageSize = message->payload->size();
+        const bool isFragmented = budget.maxFragmentSize != 0 &&
+                                  messageSize > budget.maxFragmentSize;
+        const size_t writeSize = isFragmented ?
+                                 std::min(budget.maxFragmentSize, messageSize - message->writtenSize) :
+                                 messageSize;
+        if (isFragmented)
+        {
+            if (!sendFragment(wsInstance, connection, *message, writeSize))
+            {
+                return false;
+            }
+        }
+        else if (!sendMessage(wsInstance, connection, *message))
+        {
+            return false;
+        }
+        bytesWritten += writeSize;
+
+        // NOTE: The compressed output not taken by the socket is drained on the next writable
+        // events, so the message data is kept until then and no other message is written
+        // in the meantime. The fragmented message stays in the queue until its last fragment
+        // is written.
+        const bool isDeflatePending = connection.isDeflatePending();
+        if (!isFragmented || message->writtenSize == messageSize)
+        {
+            if (isDeflatePending)
+            {
+                connection.keepWrittenMessage(std::move(*message));
+            }
+            if (connection.popPendingData(messageSize))
+            {
+                callbackContext.getServerLogic()->onWatermark(connection.getConnectionId(),
+                                                              Watermark::Low);
+            }
+        }
+
+        if (isDeflatePending || ++messagesWritten >= budget.maxMessages ||
+            bytesWritten >= budget.maxBytes || lws_send_pipe_choked(wsInstance) != 0)
+        {
+            break;
+        }
+    }
+
+    if (!callbackContext.isStopping() &&
+        (connection.hasPendingData() || connection.isDeflatePending()))
+    {
+        lws_callback_on_writable(wsInstance);
+    }
+    return true;
+}
+
+// Checks the received fragment along with the remains of its frame against the message size
+// limit before anything is buffered
+auto isMessageTooLarge(lws* wsInstance, const std::vector<char>& buffer, size_t len,
+                       size_t maxMessageSize) -> bool
+{
+    const size_t received = lws_is_first_fragment(wsInstance) != 0 ? 0 : buffer.size();
+    const size_t remains = lws_remaining_packet_payload(wsInstance);
+    return len > maxMessageSize || remains > maxMessageSize - len ||
+           received > maxMessageSize - len - remains;
+}
+
+// Appends the received fragment to the receive buffer. Returns true if the message is complete.
+auto appendFragment(lws* wsInstance, std::vector<char>& buffer, const char* data, size_t len) -> bool
+{
+    if (lws_is_first_fragment(wsInstance) != 0)
+    {
+        buffer.clear();
+    }
+
+    // The frame length is known on its first fragment, so the single frame message
+    // is placed without reallocations. The length is declared by the peer, so it is trusted
+    // up to the retained buffer size only
+    const size_t remains = std::min(lws_remaining_packet_payload(wsInstance),
+                                    MAX_RETAINED_RECEIVE_BUFFER);
+    const size_t required = buffer.size() + len + remains;
+    if (buffer.capacity() < required)
+    {
+        buffer.reserve(buffer.empty() ? required : std::max(required, buffer.capacity() * 2));
+    }
+    buffer.insert(buffer.end(), data, data + len);
+
+    return lws_is_final_fragment(wsInstance) != 0;
+}
+
+void resetReceiveBuffer(std::vector<char>& buffer)
+{
+    if (buffer.capacity() > MAX_RETAINED_RECEIVE_BUFFER)
+    {
+        std::vector<char>{}.swap(buffer);
+    }
+    else
+    {
+        buffer.clear();
+    }
+}
+
+auto handleCallback_v1(
         lws* wsInstance,
         lws_callback_reasons reason,
-        void* /*userData*/,
+        void* userData,
         void* in/*pointer*/,
         size_t len/*length*/)
 -> int
 {
     auto& callbackContext = getCallbackContext(wsInstance);
     auto serverLogic = callbackContext.getServerLogic();
-    auto connectionId = getConnectionId(wsInstance);
+    auto* session = reinterpret_cast<LwsSession*>(userData);
+    auto connectionId = getConnectionId(session);
 
     switch(reason)
     {
     case LWS_CALLBACK_ESTABLISHED:
     {
         auto connections = callbackContext.getConnections();
-        connections->add(std::make_shared<LwsConnection>(connectionId, wsInstance));
+        connectionId = connections->makeConnectionId(lws_get_socket_fd(wsInstance));
+        auto connection = std::make_shared<LwsConnection>(connectionId, wsInstance,
+                                                          callbackContext.getQueueLimits());
+        *session = LwsSession{connectionId, connection.get()};
+        connections->add(std::move(connection));
+
+        if (const auto& compression = callbackContext.getCompressionSettings())
+        {
+            setupCompression(wsInstance, *compression);
+        }
+
+        if (!setupConnectionSocket(lws_get_socket_fd(wsInstance),
+                                   callbackContext.getSocketSettings()))
+        {
+            serverLogic->onWarning(connectionId, "Failed to apply the socket settings");
+        }
 
         auto connectionInfo =
             std::make_shared<ConnectionInfo>(connectionId, getConnectionIP(wsInstance),
@@ -109,31 +398,22 @@ auto lwsCallback_v1(
     }
     case LWS_CALLBACK_SERVER_WRITEABLE:
     {
-        auto connections = callbackContext.getConnections();
-        if (auto connection = connections->get(connectionId))
+        // NOTE: The session holds the connection until it is closed, the registry lookup
+        // is not needed here
+        if (auto* connection = session != nullptr ? session->connection : nullptr)
         {
             if (connection->markedToClose())
             {
-                lws_close_reason(wsInstance, LWS_CLOSE_STATUS_GOINGAWAY, nullptr, 0);
+                const auto closeStatus =
+                    connection->getCloseReason() == CloseReason::SlowConsumer ?
+                        LWS_CLOSE_STATUS_POLICY_VIOLATION : LWS_CLOSE_STATUS_GOINGAWAY;
+                lws_close_reason(wsInstance, closeStatus, nullptr, 0);
                 return CLOSE_SESSION;
             }
 
-            auto& messages = connection->getPendingData();
-            if (!messages.empty() && !callbackContext.isStopping())
+            if (!sendPendingData(wsInstance, *connection, callbackContext))
             {
-                auto& message = messages.front();
-                if (sendMessage(wsInstance, message))
-                {
-                    messages.pop();
-                    if (!messages.empty())
-                    {
-                        lws_callback_on_writable(wsInstance);
-                    }
-                }
-                else
-                {
-                    serverLogic->onError(connectionId, "Error writing data to socket");
-                }
+                serverLogic->onError(connectionId, "Error writing data to socket");
             }
         }
         else
@@ -165,10 +445,58 @@ auto lwsCallback_v1(
         }
         break;
     }
+    case LWS_CALLBACK_EVENT_WAIT_CANCELLED:
+    {
+        // The service thread is woken up by the lws_cancel_service, see LwsCallbackNotifier
+        callbackContext.getPendingWrites()->requestWritable(lws_get_tsi(wsInstance),
+                                                            *serverLogic);
+        break;
+    }
+    case LWS_CALLBACK_ADD_POLL_FD:
+    {
+        // The listening socket is added to the service loop along with the accepted ones.
+        // NOTE: The libwebsockets built without LWS_WITH_EXTERNAL_POLL does not emit the poll
+        // callbacks and there is no other way to reach its listening socket, see LwsServer
+        const auto* pollArgs = reinterpret_cast<const lws_pollargs*>(in);
+        if (!setupListeningSocket(pollArgs->fd, callbackContext.getSocketSettings()))
+        {
+            serverLogic->onWarning(connectionId, "Failed to apply the listening socket settings");
+        }
+
+        if (const auto& eventLoop = callbackContext.getEventLoop())
+        {
+            eventLoop->watchFd(pollArgs->fd, static_cast<short>(pollArgs->events));
+        }
+        break;
+    }
+    case LWS_CALLBACK_CHANGE_MODE_POLL_FD:
+    {
+        if (const auto& eventLoop = callbackContext.getEventLoop())
+        {
+            const auto* pollArgs = reinterpret_cast<const lws_pollargs*>(in);
+            eventLoop->watchFd(pollArgs->fd, static_cast<short>(pollArgs->events));
+        }
+        break;
+    }
+    case LWS_CALLBACK_DEL_POLL_FD:
+    {
+        if (const auto& eventLoop = callbackContext.getEventLoop())
+        {
+            const auto* pollArgs = reinterpret_cast<const lws_pollargs*>(in);
+            eventLoop->unwatchFd(pollArgs->fd);
+        }
+        break;
+    }
     case LWS_CALLBACK_CLOSED:
     {
         auto connections = callbackContext.getConnections();
         connections->remove(connectionId);
+        callbackContext.getTopics()->removeConnection(connectionId);
+        if (session != nullptr && session->connection != nullptr)
+        {
+            session->connection->detachLwsInstance();
+            session->connection = nullptr;
+        }
         serverLogic->onDisconnect(connectionId);
         break;
     }
@@ -178,5 +506,107 @@ auto lwsCallback_v1(
     return 0;
 }
 
+auto handleCallback_v2(
+        lws* wsInstance,
+        lws_callback_reasons reason,
+        void* userData,
+        void* in/*pointer*/,
+        size_t len/*length*/)
+-> int
+{
+    auto* session = reinterpret_cast<LwsSession*>(userData);
+    if (reason != LWS_CALLBACK_RECEIVE || session == nullptr || session->connection == nullptr)
+    {
+        return handleCallback_v1(wsInstance, reason, userData, in, len);
+    }
+
+    auto& callbackContext = getCallbackContext(wsInstance);
+    auto serverLogic = callbackContext.getServerLogic();
+    const auto connectionId = session->connectionId;
+
+    if (lws_is_first_fragment(wsInstance) != 0)
+    {
+        serverLogic->onFirstDataPacket(connectionId,
+                                       len + lws_remaining_packet_payload(wsInstance));
+    }
+
+    auto& buffer = session->connection->getReceiveBuffer();
+    if (isMessageTooLarge(wsInstance, buffer, len, callbackContext.getMaxMessageSize()))
+    {
+        std::vector<char>{}.swap(buffer);
+        serverLogic->onError(connectionId, "The received message exceeds the max message size");
+        lws_close_reason(wsInstance, LWS_CLOSE_STATUS_MESSAGE_TOO_LARGE, nullptr, 0);
+        return CLOSE_SESSION;
+    }
+
+    if (!appendFragment(wsInstance, buffer, reinterpret_cast<const char *>(in), len))
+    {
+        return 0;
+    }
+
+    const DataPacket dataPacket{buffer.data(), buffer.size(), 0};
+    if (lws_frame_is_binary(wsInstance) == 1)
+    {
+        serverLogic->onBinaryDataReceive(connectionId, dataPacket);
+    }
+    else
+    {
+        serverLogic->onTextDataReceive(connectionId, dataPacket);
+    }
+
+    resetReceiveBuffer(buffer);
+    return 0;
+}
+
+// The exceptions must not pass through the C code of the libwebsockets, so the connection
+// whose callback failed is closed instead
+auto runCallback(
+        LwsCallback* callback,
+        lws* wsInstance,
+        lws_callback_reasons reason,
+        void* userData,
+        void* in,
+        size_t len)
+-> int
+{
+    try
+    {
+        return callback(wsInstance, reason, userData, in, len);
+    }
+    catch (const std::exception& e)
+    {
+        lwsl_err("lwspp: the callback reason %d failed: %s\n", static_cast<int>(reason), e.what());
+    }
+    catch (...)
+    {
+        lwsl_err("lwspp: the callback reason %d failed\n", static_cast<int>(reason));
+    }
+    return CLOSE_SESSION;
+}
+
+} // namespace
+
+auto lwsCallback_v1(
+        lws* wsInstance,
+        lws_callback_reasons reason,
+        void* userData,
+        void* in/*pointer*/,
+        size_t len/*length*/)
+-> int
+{
+    return runCallback(handleCallback_v1, wsInstance, reason, userData, in, len);
+}
+
+auto lwsCallback_v2(
+        lws* wsInstance,
+        lws_callback_reasons reason,
+        void* userData,
+        void* in/*pointer*/,
+        size_t len/*length*/)
+-> int
+{
+    return runCallback(handleCallback_v2, wsInstance, reason, userData, in, len);
+}
+
 } // namespace srv
 } // namespace lwspp
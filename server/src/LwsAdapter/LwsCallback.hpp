@@ -50,5 +50,18 @@ auto lwsCallback_v1(
         size_t len)
 -> int;
 
+/**
+ * @brief lwsCallback_v2 is the LwsCallback function that reassembles the received fragments
+ * into the reusable per-connection buffer and delivers each message once and whole. The other
+ * reasons are handled by the lwsCallback_v1.
+ */
+auto lwsCallback_v2(
+        lws *wsi,
+        lws_callback_reasons reason,
+        void* userData,
+        void* in,
+        size_t len)
+-> int;
+
 } // namespace srv
 } // namespace lwspp
@@ -29,9 +29,22 @@ namespace lwspp
 namespace srv
 {
 
-LwsCallbackContext::LwsCallbackContext(contract::IServerLogicPtr e, ILwsConnectionsPtr s)
+LwsCallbackContext::LwsCallbackContext(contract::IServerLogicPtr e, ILwsConnectionsPtr s,
+                                       ILwsTopicsPtr t, ILwsPendingWritesPtr w, WriteBudget b,
+                                       QueueLimits q, size_t z, size_t m,
+                                       CompressionSettingsPtr c, SocketSettings o,
+                                       contract::IEventLoopPtr l)
     : _serverLogic(std::move(e))
     , _connections(std::move(s))
+    , _topics(std::move(t))
+    , _pendingWrites(std::move(w))
+    , _writeBudget(b)
+    , _queueLimits(q)
+    , _streamChunkSize(z)
+    , _maxMessageSize(m)
+    , _compression(std::move(c))
+    , _socketSettings(o)
+    , _eventLoop(std::move(l))
 {}
 
 void LwsCallbackContext::setStopping()
@@ -44,11 +57,56 @@ auto LwsCallbackContext::isStopping() const -> bool
     return _isStopping;
 }
 
+auto LwsCallbackContext::getWriteBudget() const -> WriteBudget
+{
+    return _writeBudget;
+}
+
+auto LwsCallbackContext::getQueueLimits() const -> QueueLimits
+{
+    return _queueLimits;
+}
+
+auto LwsCallbackContext::getStreamChunkSize() const -> size_t
+{
+    return _streamChunkSize;
+}
+
+auto LwsCallbackContext::getMaxMessageSize() const -> size_t
+{
+    return _maxMessageSize;
+}
+
+auto LwsCallbackContext::getCompressionSettings() const -> const CompressionSettingsPtr&
+{
+    return _compression;
+}
+
+auto LwsCallbackContext::getSocketSettings() const -> const SocketSettings&
+{
+    return _socketSettings;
+}
+
+auto LwsCallbackContext::getEventLoop() const -> const contract::IEventLoopPtr&
+{
+    return _eventLoop;
+}
+
 auto LwsCallbackContext::getConnections() -> ILwsConnectionsPtr
 {
     return _connections;
 }
 
+auto LwsCallbackContext::getTopics() -> ILwsTopicsPtr
+{
+    return _topics;
+}
+
+auto LwsCallbackContext::getPendingWrites() -> ILwsPendingWritesPtr
+{
+    return _pendingWrites;
+}
+
 auto LwsCallbackContext::getServerLogic() -> contract::IServerLogicPtr
 {
     return _serverLogic;
@@ -24,6 +24,8 @@
 
 #pragma once
 
+#include <atomic>
+
 #include "LwsAdapter/ILwsCallbackContext.hpp"
 
 namespace lwspp
@@ -34,19 +36,40 @@ namespace srv
 class LwsCallbackContext : public ILwsCallbackContext
 {
 public:
-    LwsCallbackContext(contract::IServerLogicPtr, ILwsConnectionsPtr);
+    LwsCallbackContext(contract::IServerLogicPtr, ILwsConnectionsPtr, ILwsTopicsPtr,
+                       ILwsPendingWritesPtr, WriteBudget, QueueLimits, size_t streamChunkSize,
+                       size_t maxMessageSize, CompressionSettingsPtr, SocketSettings,
+                       contract::IEventLoopPtr);
 
     void setStopping() override;
     auto isStopping() const -> bool override;
+    auto getWriteBudget() const -> WriteBudget override;
+    auto getQueueLimits() const -> QueueLimits override;
+    auto getStreamChunkSize() const -> size_t override;
+    auto getMaxMessageSize() const -> size_t override;
+    auto getCompressionSettings() const -> const CompressionSettingsPtr& override;
+    auto getSocketSettings() const -> const SocketSettings& override;
+    auto getEventLoop() const -> const contract::IEventLoopPtr& override;
     auto getConnections() -> ILwsConnectionsPtr override;
+    auto getTopics() -> ILwsTopicsPtr override;
+    auto getPendingWrites() -> ILwsPendingWritesPtr override;
 
     auto getServerLogic() -> contract::IServerLogicPtr override;
 
 private:
     contract::IServerLogicPtr _serverLogic;
     ILwsConnectionsPtr _connections;
+    ILwsTopicsPtr _topics;
+    ILwsPendingWritesPtr _pendingWrites;
+    WriteBudget _writeBudget;
+    QueueLimits _queueLimits;
+    size_t _streamChunkSize;
+    size_t _maxMessageSize;
+    CompressionSettingsPtr _compression;
+    SocketSettings _socketSettings;
+    contract::IEventLoopPtr _eventLoop;
 
-    bool _isStopping = false;
+    std::atomic<bool> _isStopping{false};
 };
 
 } // namespace srv
@@ -0,0 +1,235 @@
+/*
+ * lwspp - C++ wrapper for the libwebsockets library
+ *
+ * Copyright (C) 2023 - 2023 Volodymyr Lotoshko <vlotoshko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <ctime>
+#include <map>
+#include <string>
+
+#include "CompressionSettings.hpp"
+#include "LwsAdapter/ILwsConnection.hpp"
+#include "LwsAdapter/LwsCompression.hpp"
+#include "LwsAdapter/LwsTypes.hpp"
+
+namespace lwspp
+{
+namespace srv
+{
+namespace
+{
+
+const char* const PERMESSAGE_DEFLATE = "permessage-deflate";
+const char* const SERVER_MAX_WINDOW_BITS = "server_max_window_bits";
+const char* const SERVER_NO_CONTEXT_TAKEOVER = "server_no_context_takeover";
+const unsigned int MAX_EXTENSIONS_HEADER_SIZE = 1024;
+
+auto getThreadCpuTime() -> std::chrono::nanoseconds
+{
+    timespec time{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+    return std::chrono::seconds{time.tv_sec} + std::chrono::nanoseconds{time.tv_nsec};
+}
+
+// Wraps the permessage-deflate extension of the libwebsockets to collect the compression
+// statistics of the connection and to track the compressed output left to drain
+auto lwsExtensionCallback_pmDeflate(
+        lws_context* context,
+        const lws_extension* extension,
+        lws* wsInstance,
+        lws_extension_callback_reasons reason,
+        void* user,
+        void* in,
+        size_t len)
+-> int
+{
+    if (reason != LWS_EXT_CB_PAYLOAD_TX || in == nullptr)
+    {
+        return lws_extension_callback_pm_deflate(context, extension, wsInstance, reason,
+                                                 user, in, len);
+    }
+
+    const auto* buffers = reinterpret_cast<lws_ext_pm_deflate_rx_ebufs*>(in);
+    const auto uncompressedBytes = static_cast<size_t>(std::max(buffers->eb_in.len, 0));
+    const auto startTime = getThreadCpuTime();
+
+    const int result = lws_extension_callback_pm_deflate(context, extension, wsInstance, reason,
+                                                         user, in, len);
+
+    const auto* session = reinterpret_cast<LwsSession*>(lws_wsi_user(wsInstance));
+    if (result >= 0 && session != nullptr && session->connection != nullptr)
+    {
+        const auto compressedBytes = static_cast<size_t>(std::max(buffers->eb_out.len, 0));
+        session->connection->addCompressionStats(uncompressedBytes, compressedBytes,
+                                                 getThreadCpuTime() - startTime);
+        session->connection->setDeflatePending(result == PMDR_HAS_PENDING);
+    }
+    return result;
+}
+
+using ExtensionsHeader = std::array<char, MAX_EXTENSIONS_HEADER_SIZE>;
+using DeflateParameters = std::map<std::string, std::string>;
+
+auto trim(const std::string& text) -> std::string
+{
+    const auto first = text.find_first_not_of(" \t");
+    if (first == std::string::npos)
+    {
+        return std::string{};
+    }
+    return text.substr(first, text.find_last_not_of(" \t") - first + 1);
+}
+
+// Parses the parameters of the permessage-deflate entry of the extensions header, see RFC 7692.
+// Returns false if the header is missing or does not fit the buffer, if there is no entry or
+// several ones, and if the parameter is repeated.
+auto parseDeflateParameters(lws* wsInstance, DeflateParameters& parameters) -> bool
+{
+    ExtensionsHeader buffer{};
+    const int length = lws_hdr_copy(wsInstance, buffer.data(), static_cast<int>(buffer.size()),
+                                    WSI_TOKEN_EXTENSIONS);
+    if (length <= 0)
+    {
+        return false;
+    }
+
+    const std::string header{buffer.data(), static_cast<size_t>(length)};
+    bool isFound = false;
+    size_t extensionStart = 0;
+    while (extensionStart <= header.size())
+    {
+        const size_t extensionEnd = std::min(header.find(',', extensionStart), header.size());
+        const auto extension = header.substr(extensionStart, extensionEnd - extensionStart);
+        extensionStart = extensionEnd + 1;
+
+        size_t tokenEnd = std::min(extension.find(';'), extension.size());
+        if (trim(extension.substr(0, tokenEnd)) != PERMESSAGE_DEFLATE)
+        {
+            continue;
+        }
+        if (isFound)
+        {
+            return false;
+        }
+        isFound = true;
+
+        while (tokenEnd < extension.size())
+        {
+            const size_t tokenStart = tokenEnd + 1;
+            tokenEnd = std::min(extension.find(';', tokenStart), extension.size());
+            const auto token = extension.substr(tokenStart, tokenEnd - tokenStart);
+
+            const size_t separator = token.find('=');
+            auto value = separator == std::string::npos ? std::string{}
+                                                        : trim(token.substr(separator + 1));
+            // The value may be the quoted string
+            if (value.size() >= 2 && value.front() == '"' && value.back() == '"')
+            {
+                value = value.substr(1, value.size() - 2);
+            }
+            if (!parameters.emplace(trim(token.substr(0, separator)), value).second)
+            {
+                return false;
+            }
+        }
+    }
+    return isFound;
+}
+
+// Returns the window bits of the parameter value or zero if the value is not valid
+auto parseWindowBits(const std::string& value) -> int
+{
+    if (value.empty() || value.size() > 2 ||
+        !std::all_of(value.begin(), value.end(), [](char c){ return c >= '0' && c <= '9'; }))
+    {
+        return 0;
+    }
+
+    const int windowBits = std::stoi(value);
+    return windowBits >= MIN_COMPRESSION_WINDOW_BITS &&
+           windowBits <= MAX_COMPRESSION_WINDOW_BITS ? windowBits : 0;
+}
+
+// Returns the window bits the client allows the server to use or zero if the offer is not valid
+auto getAllowedWindowBits(const DeflateParameters& parameters) -> int
+{
+    const auto found = parameters.find(SERVER_MAX_WINDOW_BITS);
+    return found != parameters.end() ? parseWindowBits(found->second)
+                                     : MAX_COMPRESSION_WINDOW_BITS;
+}
+
+// Returns nonzero if the permessage-deflate is not negotiated with the client
+auto setExtensionOption(lws* wsInstance, const char* option, int value) -> int
+{
+    return lws_set_extension_option(wsInstance, PERMESSAGE_DEFLATE, option,
+                                    std::to_string(value).c_str());
+}
+
+} // namespace
+
+auto createLwsExtensions(const CompressionSettingsPtr& compression) -> LwsExtensions
+{
+    if (compression == nullptr)
+    {
+        return LwsExtensions{};
+    }
+
+    return LwsExtensions {
+        {
+            PERMESSAGE_DEFLATE,
+            lwsExtensionCallback_pmDeflate,
+            PERMESSAGE_DEFLATE // client offer, not used by the server
+        },
+        { nullptr, nullptr, nullptr }
+    };
+}
+
+void setupCompression(lws* wsInstance, const CompressionSettings& compression)
+{
+    // NOTE: The libwebsockets rejects the options of the extension not active on the connection
+    if (setExtensionOption(wsInstance, "compression_level", compression.compressionLevel) != 0)
+    {
+        return;
+    }
+    setExtensionOption(wsInstance, "mem_level", compression.memoryLevel);
+
+    // The window negotiated by the libwebsockets is kept if the offer is not understood
+    DeflateParameters parameters;
+    const int allowedWindowBits =
+        parseDeflateParameters(wsInstance, parameters) ? getAllowedWindowBits(parameters) : 0;
+    if (allowedWindowBits != 0)
+    {
+        setExtensionOption(wsInstance, SERVER_MAX_WINDOW_BITS,
+                           std::min(compression.windowBits, allowedWindowBits));
+    }
+
+    if (compression.noContextTakeover)
+    {
+        lws_set_extension_option(wsInstance, PERMESSAGE_DEFLATE, SERVER_NO_CONTEXT_TAKEOVER, "");
+    }
+}
+
+} // namespace srv
+} // namespace lwspp
@@ -23,32 +23,28 @@
  */
 
 #include "LwsAdapter/LwsConnection.hpp"
+#include "LwsAdapter/LwsMessage.hpp"
 
 namespace lwspp
 {
 namespace srv
 {
-
 namespace
 {
 
-// NOTE: Additional space with the size of LWS_PRE should be added in the front of the data
-// For more information please read lws_write description
-template <typename Container>
-auto addPrefixToMessage(const Container& message) -> std::string
-{
-    std::string result;
-    // NOTE: resize can throw bad alloc if message is too large
-    result.resize(LWS_PRE + message.size());
-    std::copy(message.cbegin(), message.cend(), &result[0] + LWS_PRE);
-    return result;
-}
+// The low watermark is the half of the queue limits
+const size_t LOW_WATERMARK_DIVISOR = 2;
+// The high priority messages written in a row at most while the bulk lane has pending data
+const unsigned int HIGH_PRIORITY_WEIGHT = 4;
 
 } // namespace
 
-LwsConnection::LwsConnection(ConnectionId connectionId, LwsInstanceRawPtr instance)
+LwsConnection::LwsConnection(ConnectionId connectionId, LwsInstanceRawPtr instance,
+                             QueueLimits queueLimits)
     : _connectionId(connectionId)
     , _wsInstance(instance)
+    , _serviceThreadIndex(lws_get_tsi(instance))
+    , _queueLimits(queueLimits)
 {}
 
 auto LwsConnection::getConnectionId() const -> ConnectionId
@@ -61,40 +57,355 @@ auto LwsConnection::getLwsInstance() -> LwsInstanceRawPtr
     return _wsInstance;
 }
 
-void LwsConnection::addBinaryDataToSend(const std::vector<char>& binaryData)
+auto LwsConnection::getServiceThreadIndex() const -> int
+{
+    return _serviceThreadIndex;
+}
+
+auto LwsConnection::wakeUpServiceThread() -> bool
+{
+    const std::lock_guard<std::mutex> guard(_instanceMutex);
+    if (!_isInstanceAttached)
+    {
+        return false;
+    }
+    lws_cancel_service_pt(_wsInstance);
+    return true;
+}
+
+void LwsConnection::detachLwsInstance()
+{
+    const std::lock_guard<std::mutex> guard(_instanceMutex);
+    _isInstanceAttached = false;
+}
+
+// NOTE: The limits are checked without the lock, the concurrent producers may exceed them
+// by the messages they send at the same time
+auto LwsConnection::addDataToSend(Message message) -> EnqueueResult
+{
+    if (_closeReason == CloseReason::SlowConsumer)
+    {
+        return EnqueueResult{SendResult::Disconnected, false};
+    }
+
+    const bool isConflated = !message.conflationKey.empty();
+    if (isConflated && replaceConflatedPayload_(message, false))
+    {
+        return EnqueueResult{SendResult::Queued, false};
+    }
+
+    const size_t messageSize = getQueuedSize(message);
+    bool highWatermarkReached = false;
+    if (isLimitReached_(messageSize))
+    {
+        highWatermarkReached = !_aboveHighWatermark.exchange(true);
+        switch (_queueLimits.policy)
+        {
+        case SlowConsumerPolicy::Reject:
+            return EnqueueResult{SendResult::Rejected, highWatermarkReached};
+        case SlowConsumerPolicy::DropNewest:
+            return EnqueueResult{SendResult::Dropped, highWatermarkReached};
+        case SlowConsumerPolicy::Disconnect:
+            markToClose(CloseReason::SlowConsumer);
+            return EnqueueResult{SendResult::Disconnected, highWatermarkReached};
+        case SlowConsumerPolicy::DropOldest:
+            // The service thread drops the oldest messages, see trimPendingData
+            break;
+        }
+    }
+
+    // The message of the same key could be queued by the concurrent producer in the meantime
+    if (isConflated && replaceConflatedPayload_(message, true))
+    {
+        return EnqueueResult{SendResult::Queued, highWatermarkReached};
+    }
+
+    ++_queuedMessages;
+    _queuedBytes += messageSize;
+    auto& lane = getLane_(message.priority);
+    lane.push(std::move(message));
+    return EnqueueResult{SendResult::Queued, highWatermarkReached};
+}
+
+auto LwsConnection::frontPendingData() -> Message*
+{
+    auto* lane = selectFrontLane_();
+    return lane != nullptr ? frontMessage_(*lane) : nullptr;
+}
+
+auto LwsConnection::hasPendingData() -> bool
+{
+    return !getLane_(Priority::High).empty() || !getLane_(Priority::Bulk).empty();
+}
+
+auto LwsConnection::popPendingData(size_t messageSize) -> bool
 {
-    std::string payload = addPrefixToMessage(binaryData);
+    auto* lane = selectFrontLane_();
+    if (lane == nullptr)
+    {
+        return false;
+    }
 
-    const std::lock_guard<std::mutex> guard(_mutex);
-    _pendingData.emplace(DataType::Binary, std::move(payload));
+    _highPriorityInRow = _frontLane == Priority::High ? _highPriorityInRow + 1 : 0;
+    _isFrontLaneSelected = false;
+    return popMessage_(*lane, messageSize);
 }
 
-void LwsConnection::addTextDataToSend(const std::string& textData)
+auto LwsConnection::trimPendingData() -> bool
 {
-    std::string payload = addPrefixToMessage(textData);
+    if (_queueLimits.policy != SlowConsumerPolicy::DropOldest)
+    {
+        return false;
+    }
 
-    const std::lock_guard<std::mutex> guard(_mutex);
-    _pendingData.emplace(DataType::Text, std::move(payload));
+    // NOTE: The other messages can not be sent between the fragments of the started message,
+    // so the queue is not trimmed until the message is written
+    auto* lane = _isFrontLaneSelected ? &getLane_(_frontLane) : nullptr;
+    if (lane != nullptr && lane->front() != nullptr && isWriteStarted(*lane->front()))
+    {
+        return false;
+    }
+
+    // The bulk data is dropped first. The last message is kept even if it exceeds the limits
+    // on its own.
+    _isFrontLaneSelected = false;
+    bool isBelowLowWatermark = false;
+    while (_queuedMessages > 1 && exceedsLimits_(_queuedMessages, _queuedBytes))
+    {
+        auto& bulkLane = getLane_(Priority::Bulk);
+        auto& dropLane = bulkLane.empty() ? getLane_(Priority::High) : bulkLane;
+        isBelowLowWatermark |= popMessage_(dropLane, getQueuedSize(*frontMessage_(dropLane)));
+    }
+    return isBelowLowWatermark;
 }
 
-auto LwsConnection::getPendingData() -> std::queue<Message>&
+auto LwsConnection::takeHighWatermark() -> bool
 {
-    if (_pendingDataToSend.empty())
+    if (_isHighWatermarkReported || !_aboveHighWatermark)
     {
-        const std::lock_guard<std::mutex> guard(_mutex);
-        _pendingDataToSend.swap(_pendingData);
+        return false;
     }
-    return _pendingDataToSend;
+    _isHighWatermarkReported = true;
+    return true;
+}
+
+auto LwsConnection::getReceiveBuffer() -> std::vector<char>&
+{
+    return _receiveBuffer;
+}
+
+auto LwsConnection::getWriteBuffer() -> std::vector<unsigned char>&
+{
+    return _writeBuffer;
+}
+
+void LwsConnection::keepWrittenMessage(Message message)
+{
+    _writtenMessage = std::move(message);
+}
+
+void LwsConnection::releaseWrittenMessage()
+{
+    _writtenMessage.payload.reset();
+}
+
+void LwsConnection::addCompressionStats(size_t uncompressedBytes, size_t compressedBytes,
+                                        std::chrono::nanoseconds cpuTime)
+{
+    _uncompressedBytes += uncompressedBytes;
+    _compressedBytes += compressedBytes;
+    _compressionCpuTime += cpuTime.count();
+}
+
+auto LwsConnection::getCompressionStats() const -> CompressionStats
+{
+    auto stats = CompressionStats{};
+    stats.uncompressedBytes = _uncompressedBytes;
+    stats.compressedBytes = _compressedBytes;
+    stats.cpuTime = std::chrono::nanoseconds{_compressionCpuTime};
+    return stats;
+}
+
+void LwsConnection::setDeflatePending(bool isPending)
+{
+    _isDeflatePending = isPending;
+}
+
+auto LwsConnection::isDeflatePending() const -> bool
+{
+    return _isDeflatePending;
 }
 
 auto lwspp::srv::LwsConnection::markedToClose() -> bool
 {
-    return _markedToClose;
+    return _closeReason != CloseReason::None;
 }
 
-void LwsConnection::markToClose()
+void LwsConnection::markToClose(CloseReason reason)
 {
-    _markedToClose = true;
+    _closeReason = reason;
+}
+
+auto LwsConnection::getCloseReason() const -> CloseReason
+{
+    return _closeReason;
+}
+
+auto LwsConnection::markPendingWrite() -> bool
+{
+    return !_pendingWrite.exchange(true);
+}
+
+auto LwsConnection::clearPendingWrite() -> bool
+{
+    return _pendingWrite.exchange(false);
+}
+
+auto LwsConnection::pauseReceiving(ReceivingPauseReason reason) -> bool
+{
+    const auto reasonBit = static_cast<uint8_t>(reason);
+    const bool isChanged = _receivingPauseReasons.fetch_or(reasonBit) == 0;
+    if (isChanged)
+    {
+        _receivingChanged = true;
+    }
+    return isChanged;
+}
+
+auto LwsConnection::resumeReceiving(ReceivingPauseReason reason) -> bool
+{
+    const auto reasonBit = static_cast<uint8_t>(reason);
+    const bool isChanged =
+        _receivingPauseReasons.fetch_and(static_cast<uint8_t>(~reasonBit)) == reasonBit;
+    if (isChanged)
+    {
+        _receivingChanged = true;
+    }
+    return isChanged;
+}
+
+auto LwsConnection::isReceivingPaused() const -> bool
+{
+    return _receivingPauseReasons != 0;
+}
+
+auto LwsConnection::takeReceivingChange() -> bool
+{
+    return _receivingChanged.exchange(false);
+}
+
+// The empty queue takes the message of any size
+auto LwsConnection::isLimitReached_(size_t messageSize) const -> bool
+{
+    const size_t queuedMessages = _queuedMessages;
+    if (queuedMessages == 0)
+    {
+        return false;
+    }
+
+    return exceedsLimits_(queuedMessages + 1, _queuedBytes + messageSize);
+}
+
+auto LwsConnection::exceedsLimits_(size_t messages, size_t bytes) const -> bool
+{
+    return (_queueLimits.maxMessages != 0 && messages > _queueLimits.maxMessages) ||
+           (_queueLimits.maxBytes != 0 && bytes > _queueLimits.maxBytes);
+}
+
+auto LwsConnection::isBelowLowWatermark_() const -> bool
+{
+    return !exceedsLimits_(_queuedMessages * LOW_WATERMARK_DIVISOR,
+                           _queuedBytes * LOW_WATERMARK_DIVISOR);
+}
+
+auto LwsConnection::getLane_(Priority priority) -> MpscQueue<Message>&
+{
+    return _lanes[static_cast<size_t>(priority)];
+}
+
+// The lane is selected until its front message is popped, so the front message stays the same.
+// The high priority lane gives way to the bulk lane after HIGH_PRIORITY_WEIGHT messages in a row.
+auto LwsConnection::selectFrontLane_() -> MpscQueue<Message>*
+{
+    if (!_isFrontLaneSelected)
+    {
+        const bool hasHighPriority = !getLane_(Priority::High).empty();
+        const bool hasBulk = !getLane_(Priority::Bulk).empty();
+        if (!hasHighPriority && !hasBulk)
+        {
+            return nullptr;
+        }
+
+        const bool isBulkTurn = hasBulk &&
+                                (!hasHighPriority || _highPriorityInRow >= HIGH_PRIORITY_WEIGHT);
+        _frontLane = isBulkTurn ? Priority::Bulk : Priority::High;
+        _isFrontLaneSelected = true;
+    }
+    return &getLane_(_frontLane);
+}
+
+auto LwsConnection::frontMessage_(MpscQueue<Message>& lane) -> Message*
+{
+    auto* message = lane.front();
+    if (message != nullptr && !message->conflationKey.empty())
+    {
+        takeConflatedPayload_(*message);
+    }
+    return message;
+}
+
+// Returns true if the queue has drained below the low watermark. The crossing not reported
+// as the high watermark yet is not reported as the low one either.
+auto LwsConnection::popMessage_(MpscQueue<Message>& lane, size_t messageSize) -> bool
+{
+    lane.pop();
+    --_queuedMessages;
+    _queuedBytes -= messageSize;
+
+    if (_aboveHighWatermark && isBelowLowWatermark_() && _aboveHighWatermark.exchange(false))
+    {
+        const bool isLowWatermarkReached = _isHighWatermarkReported;
+        _isHighWatermarkReported = false;
+        return isLowWatermarkReached;
+    }
+    return false;
+}
+
+// Returns true if the payload of the queued message of the same key is replaced, otherwise
+// registers the payload for the key of the message to be queued if requested
+auto LwsConnection::replaceConflatedPayload_(const Message& message, bool registerNewKey) -> bool
+{
+    std::lock_guard<std::mutex> lock{_conflationMutex};
+    auto found = _conflatedPayloads.find(message.conflationKey);
+    if (found == _conflatedPayloads.end())
+    {
+        if (registerNewKey)
+        {
+            _conflatedPayloads.emplace(message.conflationKey,
+                                       ConflatedData{message.dataType, message.payload});
+        }
+        return false;
+    }
+
+    const size_t replacedSize = found->second.payload->size();
+    found->second = ConflatedData{message.dataType, message.payload};
+    _queuedBytes += message.payload->size();
+    _queuedBytes -= replacedSize;
+    return true;
+}
+
+// The newer data of the key is queued as the new message from now on
+void LwsConnection::takeConflatedPayload_(Message& message)
+{
+    std::lock_guard<std::mutex> lock{_conflationMutex};
+    auto found = _conflatedPayloads.find(message.conflationKey);
+    if (found != _conflatedPayloads.end())
+    {
+        message.dataType = found->second.dataType;
+        message.payload = std::move(found->second.payload);
+        _conflatedPayloads.erase(found);
+    }
+    message.conflationKey.clear();
 }
 
 } // namespace srv
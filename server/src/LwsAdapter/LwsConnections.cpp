@@ -22,6 +22,10 @@
  * IN THE SOFTWARE.
  */
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 #include "LwsAdapter/LwsConnections.hpp"
 #include "LwsAdapter/ILwsConnection.hpp" // IWYU pragma: keep
 
@@ -30,22 +34,105 @@ namespace lwspp
 namespace srv
 {
 
+namespace
+{
+
+const unsigned int GENERATION_SHIFT = 32;
+
+auto isInSlotTable(int socketFd, size_t tableSize) -> bool
+{
+    return socketFd >= 0 && static_cast<size_t>(socketFd) < tableSize;
+}
+
+auto getSocketFd(ConnectionId connectionId) -> int
+{
+    return static_cast<int>(static_cast<uint32_t>(connectionId));
+}
+
+template <typename Entry>
+void deleteEntries(Entry* entry)
+{
+    while (entry != nullptr)
+    {
+        delete std::exchange(entry, entry->next);
+    }
+}
+
+} // namespace
+
+LwsConnections::LwsConnections()
+{
+    for (auto& chunk : _chunks)
+    {
+        chunk.store(nullptr);
+    }
+}
+
+LwsConnections::~LwsConnections()
+{
+    for (auto& chunkEntry : _chunks)
+    {
+        auto* chunk = chunkEntry.load();
+        if (chunk == nullptr)
+        {
+            continue;
+        }
+
+        for (auto& slot : chunk->slots)
+        {
+            deleteEntries(slot.entry.load());
+            deleteEntries(slot.retired.load());
+        }
+        delete chunk;
+    }
+}
+
+auto LwsConnections::makeConnectionId(int socketFd) -> ConnectionId
+{
+    auto* slot = getOrCreateSlot_(socketFd);
+    auto& generation = slot != nullptr ? slot->generation : _overflowGeneration;
+
+    const ConnectionId nextGeneration = ++generation;
+    return (nextGeneration << GENERATION_SHIFT) | static_cast<uint32_t>(socketFd);
+}
+
 void LwsConnections::add(ILwsConnectionPtr connection)
 {
+    const auto connectionId = connection->getConnectionId();
+    if (auto* slot = getOrCreateSlot_(getSocketFd(connectionId)))
+    {
+        publish_(*slot, new Entry{connection, nullptr});
+    }
+
     const std::lock_guard<std::mutex> guard(_mutex);
-    _connections.insert({connection->getConnectionId(), connection});
-    _cacheExpired = true;
+    _connections[connectionId] = std::move(connection);
+    _snapshot.reset();
 }
 
 void LwsConnections::remove(ConnectionId connectionId)
 {
+    if (get(connectionId) == nullptr)
+    {
+        return;
+    }
+
+    if (auto* slot = findSlot_(getSocketFd(connectionId)))
+    {
+        publish_(*slot, nullptr);
+    }
+
     const std::lock_guard<std::mutex> guard(_mutex);
     _connections.erase(connectionId);
-    _cacheExpired = true;
+    _snapshot.reset();
 }
 
 auto LwsConnections::get(ConnectionId connectionId) -> ILwsConnectionPtr
 {
+    if (isInSlotTable(getSocketFd(connectionId), CHUNK_SIZE * MAX_CHUNKS))
+    {
+        return getFromSlot_(connectionId);
+    }
+
     const std::lock_guard<std::mutex> guard(_mutex);
     auto it = _connections.find(connectionId);
     if (it != _connections.end())
@@ -55,24 +142,174 @@ auto LwsConnections::get(ConnectionId connectionId) -> ILwsConnectionPtr
     return ILwsConnectionPtr{};
 }
 
-auto LwsConnections::getAllConnections() -> std::vector<ILwsConnectionPtr>
+// The ids out of the slot table range are looked up under the one lock
+auto LwsConnections::get(const std::vector<ConnectionId>& connectionIds)
+-> std::vector<ILwsConnectionPtr>
 {
-    if (_cacheExpired)
+    std::vector<ILwsConnectionPtr> connections;
+    connections.reserve(connectionIds.size());
+
+    bool hasOverflowIds = false;
+    for (auto connectionId : connectionIds)
+    {
+        if (!isInSlotTable(getSocketFd(connectionId), CHUNK_SIZE * MAX_CHUNKS))
+        {
+            hasOverflowIds = true;
+        }
+        else if (auto connection = getFromSlot_(connectionId))
+        {
+            connections.push_back(std::move(connection));
+        }
+    }
+
+    if (hasOverflowIds)
     {
-        _cachedConnections.clear();
-        _cachedConnections.reserve(_connections.size());
         const std::lock_guard<std::mutex> guard(_mutex);
-        if (_cacheExpired)
+        for (auto connectionId : connectionIds)
         {
-            for(auto& entry : _connections)
+            if (isInSlotTable(getSocketFd(connectionId), CHUNK_SIZE * MAX_CHUNKS))
             {
-                _cachedConnections.push_back(entry.second);
+                continue;
             }
-            _cacheExpired = false;
+
+            auto it = _connections.find(connectionId);
+            if (it != _connections.end())
+            {
+                connections.push_back(it->second);
+            }
+        }
+    }
+
+    // The message is queued once per connection even if its id is repeated
+    std::sort(connections.begin(), connections.end());
+    connections.erase(std::unique(connections.begin(), connections.end()), connections.end());
+    return connections;
+}
+
+auto LwsConnections::getAllConnections() -> ConnectionsSnapshotPtr
+{
+    const std::lock_guard<std::mutex> guard(_mutex);
+    if (_snapshot == nullptr)
+    {
+        auto snapshot = std::make_shared<std::vector<ILwsConnectionPtr>>();
+        snapshot->reserve(_connections.size());
+        for(auto& entry : _connections)
+        {
+            snapshot->push_back(entry.second);
+        }
+        _snapshot = std::move(snapshot);
+    }
+
+    return _snapshot;
+}
+
+auto LwsConnections::getFromSlot_(ConnectionId connectionId) -> ILwsConnectionPtr
+{
+    ILwsConnectionPtr connection;
+    if (auto* slot = findSlot_(getSocketFd(connectionId)))
+    {
+        slot->readers.fetch_add(1);
+        // The slot can hold the newer connection with the same socket fd
+        const auto* entry = slot->entry.load();
+        if (entry != nullptr && entry->connection->getConnectionId() == connectionId)
+        {
+            connection = entry->connection;
         }
+
+        if (slot->readers.fetch_sub(1) == 1)
+        {
+            reclaim_(*slot);
+        }
+    }
+    return connection;
+}
+
+// Replaces the published entry of the slot, the replaced one is retired
+void LwsConnections::publish_(Slot& slot, Entry* entry)
+{
+    auto* replaced = slot.entry.exchange(entry);
+    if (replaced == nullptr)
+    {
+        return;
+    }
+
+    replaced->next = slot.retired.load();
+    while (!slot.retired.compare_exchange_weak(replaced->next, replaced))
+    {
+    }
+    reclaim_(slot);
+}
+
+// NOTE: The retired entries are not published anymore, so the reader coming after the readers
+// count is checked never gets them. The entries are returned if the slot has the readers, the
+// last of them reclaims the entries again.
+void LwsConnections::reclaim_(Slot& slot)
+{
+    if (slot.retired.load() == nullptr)
+    {
+        return;
+    }
+
+    auto* retired = slot.retired.exchange(nullptr);
+    if (retired == nullptr)
+    {
+        return;
+    }
+
+    if (slot.readers.load() == 0)
+    {
+        deleteEntries(retired);
+        return;
+    }
+
+    auto* last = retired;
+    while (last->next != nullptr)
+    {
+        last = last->next;
+    }
+
+    last->next = slot.retired.load();
+    while (!slot.retired.compare_exchange_weak(last->next, retired))
+    {
+    }
+}
+
+auto LwsConnections::findSlot_(int socketFd) -> Slot*
+{
+    if (!isInSlotTable(socketFd, CHUNK_SIZE * MAX_CHUNKS))
+    {
+        return nullptr;
     }
 
-    return _cachedConnections;
+    const auto index = static_cast<size_t>(socketFd);
+    auto* chunk = _chunks[index / CHUNK_SIZE].load(std::memory_order_acquire);
+    return chunk != nullptr ? &chunk->slots[index % CHUNK_SIZE] : nullptr;
+}
+
+auto LwsConnections::getOrCreateSlot_(int socketFd) -> Slot*
+{
+    if (!isInSlotTable(socketFd, CHUNK_SIZE * MAX_CHUNKS))
+    {
+        return nullptr;
+    }
+
+    const auto index = static_cast<size_t>(socketFd);
+    auto& chunkEntry = _chunks[index / CHUNK_SIZE];
+    auto* chunk = chunkEntry.load(std::memory_order_acquire);
+    if (chunk == nullptr)
+    {
+        // Several service threads can create the chunk at the same time
+        auto* newChunk = new Chunk{};
+        if (chunkEntry.compare_exchange_strong(chunk, newChunk, std::memory_order_acq_rel))
+        {
+            chunk = newChunk;
+        }
+        else
+        {
+            delete newChunk;
+        }
+    }
+    return &chunk->slots[index % CHUNK_SIZE];
 }
 
 } // namespace srv
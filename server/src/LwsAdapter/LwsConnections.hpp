@@ -24,6 +24,9 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <map>
 #include <mutex>
 
@@ -35,18 +38,75 @@ namespace lwspp
 namespace srv
 {
 
+/**
+ * @brief The LwsConnections class stores the connections in the table of slots indexed by the
+ * socket fd part of the connection id. Reading the slot is lock-free, so the sender threads do not
+ * contend with each other and with the service threads. The service thread does not wait for the
+ * readers either: the replaced entry of the slot is retired and freed by whoever leaves the slot
+ * last. The stale ids, which refer to the previous connections with the same socket fd, are not
+ * resolved.
+ */
 class LwsConnections : public ILwsConnections
 {
 public:
+    LwsConnections();
+    ~LwsConnections() override;
+
+    LwsConnections(const LwsConnections&) = delete;
+    auto operator=(const LwsConnections&) -> LwsConnections& = delete;
+
+    LwsConnections(LwsConnections&&) = delete;
+    auto operator=(LwsConnections&&) -> LwsConnections& = delete;
+
+public:
+    auto makeConnectionId(int socketFd) -> ConnectionId override;
+
     void add(ILwsConnectionPtr) override;
     void remove(ConnectionId) override;
     auto get(ConnectionId) -> ILwsConnectionPtr override;
-    auto getAllConnections() -> std::vector<ILwsConnectionPtr> override;
+    auto get(const std::vector<ConnectionId>&) -> std::vector<ILwsConnectionPtr> override;
+    auto getAllConnections() -> ConnectionsSnapshotPtr override;
 
 private:
+    static const size_t CHUNK_SIZE = 1024;
+    static const size_t MAX_CHUNKS = 1024;
+
+    // The entry is immutable while it is published, the retired entries are linked by the next
+    struct Entry
+    {
+        ILwsConnectionPtr connection;
+        Entry* next;
+    };
+
+    // The retired entries are freed when there are no readers of the slot
+    struct Slot
+    {
+        std::atomic<Entry*> entry{nullptr};
+        std::atomic<Entry*> retired{nullptr};
+        std::atomic<unsigned int> readers{0};
+        std::atomic<uint32_t> generation{0};
+    };
+
+    struct Chunk
+    {
+        std::array<Slot, CHUNK_SIZE> slots;
+    };
+
+    auto getFromSlot_(ConnectionId) -> ILwsConnectionPtr;
+    auto findSlot_(int socketFd) -> Slot*;
+    auto getOrCreateSlot_(int socketFd) -> Slot*;
+    void publish_(Slot&, Entry*);
+    void reclaim_(Slot&);
+
+private:
+    // The chunks of the slots are allocated on demand and never released until destruction
+    std::array<std::atomic<Chunk*>, MAX_CHUNKS> _chunks;
+    // The generation of the socket fds out of the slot table range
+    std::atomic<uint32_t> _overflowGeneration{0};
+
+    // All the connections, the ids out of the slot table range are looked up here
     std::map<ConnectionId, ILwsConnectionPtr> _connections;
-    std::vector<ILwsConnectionPtr> _cachedConnections;
-    bool _cacheExpired = true;
+    ConnectionsSnapshotPtr _snapshot;
     std::mutex _mutex;
 };
 
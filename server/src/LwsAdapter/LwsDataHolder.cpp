@@ -22,6 +22,7 @@
  * IN THE SOFTWARE.
  */
 
+#include "LwsAdapter/LwsCompression.hpp"
 #include "LwsAdapter/LwsDataHolder.hpp"
 #include "LwsAdapter/LwsProtocolsFactory.hpp"
 #include "ServerContext.hpp"
@@ -34,11 +35,15 @@ namespace srv
 LwsDataHolder::LwsDataHolder(const ServerContext& context)
     : port(context.port)
     , protocolName(context.protocolName)
-    , protocols(createLwsProtocols(context.callbackVersion, protocolName))
+    , protocols(createLwsProtocols(context.callbackVersion, protocolName,
+                                   context.rxBufferSize, context.txPacketSize))
     , ssl(context.ssl)
+    , compression(context.compression)
+    , extensions(createLwsExtensions(compression))
     , vhostName(context.vhostName)
     , serverString(context.serverString)
     , lwsLogLevel(context.lwsLogLevel)
+    , serviceThreads(context.serviceThreads)
     , keepAliveTimeout(context.keepAliveTimeout)
     , keepAliveProbesInterval(context.keepAliveProbesInterval)
     , keepAliveProbes(context.keepAliveProbes)
@@ -46,9 +46,12 @@ struct LwsDataHolder
     std::string protocolName;
     LwsProtocols protocols;
     SslSettingsPtr ssl;
+    CompressionSettingsPtr compression;
+    LwsExtensions extensions;
     std::string vhostName;
     std::string serverString;
     int lwsLogLevel = 0;
+    unsigned int serviceThreads = 0;
 
     int keepAliveTimeout = 0;
     int keepAliveProbesInterval = 0;
@@ -0,0 +1,423 @@
+/*
+ * lwspp - C++ wrapper for the libwebsockets library
+ *
+ * Copyright (C) 2023 - 2023 Volodymyr Lotoshko <vlotoshko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <libwebsockets.h>
+#include <string>
+#include <utility>
+
+#include "lwspp/server/IConnectionInfo.hpp" // IWYU pragma: keep
+
+#include "LwsAdapter/ILwsCallbackNotifier.hpp" // IWYU pragma: keep
+#include "LwsAdapter/ILwsConnection.hpp"       // IWYU pragma: keep
+#include "LwsAdapter/ILwsConnections.hpp"      // IWYU pragma: keep
+#include "LwsAdapter/LwsLogicDispatcher.hpp"
+#include "LwsAdapter/LwsTypes.hpp"
+
+namespace lwspp
+{
+namespace srv
+{
+namespace
+{
+
+// The reading from the connection is resumed when its strand is drained to the half of the limit
+const size_t RESUME_RECEIVING_DIVISOR = 2;
+// The strand gives up the worker after this number of events, so the other strands wait less
+const size_t MAX_EVENTS_PER_TURN = 16;
+
+} // namespace
+
+LwsLogicDispatcher::LwsLogicDispatcher(contract::IServerLogicPtr e, ILwsConnectionsPtr s,
+                                       unsigned int threads, size_t maxQueuedEvents)
+    : _serverLogic(std::move(e))
+    , _connections(std::move(s))
+    , _maxQueuedEvents(maxQueuedEvents)
+{
+    for (unsigned int i = 0; i < threads; ++i)
+    {
+        _workers.emplace_back([this]{ runWorker_(); });
+    }
+}
+
+LwsLogicDispatcher::~LwsLogicDispatcher()
+{
+    stop();
+}
+
+void LwsLogicDispatcher::setCallbackNotifier(ILwsCallbackNotifierPtr notifier)
+{
+    const std::lock_guard<std::mutex> guard(_mutex);
+    _notifier = std::move(notifier);
+}
+
+void LwsLogicDispatcher::stop()
+{
+    {
+        const std::lock_guard<std::mutex> guard(_mutex);
+        _isStopping = true;
+    }
+    _hasReadyStrands.notify_all();
+
+    for (auto& worker : _workers)
+    {
+        if (worker.joinable())
+        {
+            worker.join();
+        }
+    }
+}
+
+// NOTE: The connection whose event is lost is closed, the same as the connection whose callback
+// failed, see runCallback. The exceptions must not pass through the noexcept callbacks.
+template <typename MakeEvent>
+void LwsLogicDispatcher::dispatch_(ConnectionId connectionId, MakeEvent makeEvent,
+                                   bool isReceived) noexcept
+{
+    try
+    {
+        // The connection is looked up in advance, its reading is paused under the lock of the
+        // strand. Otherwise the worker could drain the strand before the pause and never resume.
+        auto connection = isReceived ? _connections->get(connectionId) : nullptr;
+        auto strand = getStrand_(connectionId);
+
+        bool isScheduled = false;
+        bool isReceivingPaused = false;
+        {
+            const std::lock_guard<std::mutex> guard(strand->mutex);
+            strand->events.push_back(makeEvent());
+
+            if (connection != nullptr && !strand->isReceivingPaused &&
+                strand->events.size() >= _maxQueuedEvents)
+            {
+                strand->isReceivingPaused = true;
+                isReceivingPaused =
+                    connection->pauseReceiving(ReceivingPauseReason::LogicDispatcher);
+            }
+
+            if (!strand->isScheduled)
+            {
+                strand->isScheduled = isScheduled = true;
+            }
+        }
+
+        // NOTE: The data is received on the service thread of the connection, so the reading is
+        // paused right here. The worker resumes it through the service thread, which applies the
+        // current state of the connection after this callback returns.
+        if (isReceivingPaused)
+        {
+            lws_rx_flow_control(connection->getLwsInstance(), 0);
+        }
+
+        if (!isScheduled)
+        {
+            return;
+        }
+
+        bool isStopping = false;
+        {
+            const std::lock_guard<std::mutex> guard(_mutex);
+            isStopping = _isStopping;
+            if (!isStopping)
+            {
+                _readyStrands.push_back(strand);
+            }
+        }
+
+        if (isStopping)
+        {
+            // The workers may be gone, the strand is run here. It is scheduled meanwhile,
+            // so the events dispatched concurrently are run here as well.
+            while (runStrand_(*strand))
+            {
+            }
+            return;
+        }
+        _hasReadyStrands.notify_one();
+    }
+    catch (const std::exception& e)
+    {
+        lwsl_err("lwspp: the event of the connection %llu is not dispatched: %s\n",
+                 static_cast<unsigned long long>(connectionId), e.what());
+        closeConnection_(connectionId);
+    }
+    catch (...)
+    {
+        lwsl_err("lwspp: the event of the connection %llu is not dispatched\n",
+                 static_cast<unsigned long long>(connectionId));
+        closeConnection_(connectionId);
+    }
+}
+
+void LwsLogicDispatcher::onFirstDataPacket(ConnectionId connectionId, size_t messageLength) noexcept
+{
+    dispatch_(connectionId, [connectionId, messageLength]() -> Event
+              {
+                  return [connectionId, messageLength](contract::IServerLogic& logic)
+                  {
+                      logic.onFirstDataPacket(connectionId, messageLength);
+                  };
+              }, true);
+}
+
+// NOTE: The data packet refers to the buffer of the libwebsockets, which is valid until the
+// callback returns only, so the data is copied for the worker
+void LwsLogicDispatcher::onBinaryDataReceive(ConnectionId connectionId,
+                                             const DataPacket& dataPacket) noexcept
+{
+    dispatch_(connectionId, [connectionId, &dataPacket]() -> Event
+              {
+                  return [connectionId, data = std::string(dataPacket.data, dataPacket.length),
+                          remains = dataPacket.remains](contract::IServerLogic& logic)
+                  {
+                      logic.onBinaryDataReceive(connectionId,
+                                                DataPacket{data.data(), data.size(), remains});
+                  };
+              }, true);
+}
+
+void LwsLogicDispatcher::onTextDataReceive(ConnectionId connectionId,
+                                           const DataPacket& dataPacket) noexcept
+{
+    dispatch_(connectionId, [connectionId, &dataPacket]() -> Event
+              {
+                  return [connectionId, data = std::string(dataPacket.data, dataPacket.length),
+                          remains = dataPacket.remains](contract::IServerLogic& logic)
+                  {
+                      logic.onTextDataReceive(connectionId,
+                                              DataPacket{data.data(), data.size(), remains});
+                  };
+              }, true);
+}
+
+void LwsLogicDispatcher::onConnect(IConnectionInfoPtr connectionInfo) noexcept
+{
+    const auto connectionId = connectionInfo->getConnectionId();
+    dispatch_(connectionId, [&connectionInfo]() -> Event
+              {
+                  return [connectionInfo](contract::IServerLogic& logic)
+                  {
+                      logic.onConnect(connectionInfo);
+                  };
+              }, false);
+}
+
+// The disconnect is the last event of the connection, so its strand is forgotten. The strand
+// is kept by the workers until its events are run.
+void LwsLogicDispatcher::onDisconnect(ConnectionId connectionId) noexcept
+{
+    dispatch_(connectionId, [connectionId]() -> Event
+              {
+                  return [connectionId](contract::IServerLogic& logic)
+                  {
+                      logic.onDisconnect(connectionId);
+                  };
+              }, false);
+
+    removeStrand_(connectionId);
+}
+
+void LwsLogicDispatcher::onError(ConnectionId connectionId,
+                                 const std::string& errorMessage) noexcept
+{
+    dispatch_(connectionId, [connectionId, &errorMessage]() -> Event
+              {
+                  return [connectionId, errorMessage](contract::IServerLogic& logic)
+                  {
+                      logic.onError(connectionId, errorMessage);
+                  };
+              }, false);
+}
+
+void LwsLogicDispatcher::onWarning(ConnectionId connectionId,
+                                   const std::string& errorMessage) noexcept
+{
+    dispatch_(connectionId, [connectionId, &errorMessage]() -> Event
+              {
+                  return [connectionId, errorMessage](contract::IServerLogic& logic)
+                  {
+                      logic.onWarning(connectionId, errorMessage);
+                  };
+              }, false);
+}
+
+void LwsLogicDispatcher::onWatermark(ConnectionId connectionId, Watermark watermark) noexcept
+{
+    dispatch_(connectionId, [connectionId, watermark]() -> Event
+              {
+                  return [connectionId, watermark](contract::IServerLogic& logic)
+                  {
+                      logic.onWatermark(connectionId, watermark);
+                  };
+              }, false);
+}
+
+auto LwsLogicDispatcher::getStrand_(ConnectionId connectionId) -> StrandPtr
+{
+    auto& shard = _shards[connectionId % STRANDS_SHARDS];
+    const std::lock_guard<std::mutex> guard(shard.mutex);
+    auto& strand = shard.strands[connectionId];
+    if (strand == nullptr)
+    {
+        strand = std::make_shared<Strand>();
+        strand->connectionId = connectionId;
+    }
+    return strand;
+}
+
+void LwsLogicDispatcher::removeStrand_(ConnectionId connectionId)
+{
+    auto& shard = _shards[connectionId % STRANDS_SHARDS];
+    const std::lock_guard<std::mutex> guard(shard.mutex);
+    shard.strands.erase(connectionId);
+}
+
+// The strand is run by the one thread at a time, the one which has scheduled it
+auto LwsLogicDispatcher::runStrand_(Strand& strand) -> bool
+{
+    for (size_t i = 0; i < MAX_EVENTS_PER_TURN; ++i)
+    {
+        Event event;
+        bool isReceivingResumed = false;
+        {
+            const std::lock_guard<std::mutex> guard(strand.mutex);
+            if (strand.events.empty())
+            {
+                break;
+            }
+            event = std::move(strand.events.front());
+            strand.events.pop_front();
+
+            if (strand.isReceivingPaused &&
+                strand.events.size() <= _maxQueuedEvents / RESUME_RECEIVING_DIVISOR)
+            {
+                strand.isReceivingPaused = false;
+                isReceivingResumed = true;
+            }
+        }
+
+        if (isReceivingResumed)
+        {
+            resumeReceiving_(strand.connectionId);
+        }
+        // The exception of the logic would end the worker thread, the connection is closed instead
+        try
+        {
+            event(*_serverLogic);
+        }
+        catch (const std::exception& e)
+        {
+            lwsl_err("lwspp: the event of the connection %llu failed: %s\n",
+                     static_cast<unsigned long long>(strand.connectionId), e.what());
+            closeConnection_(strand.connectionId);
+        }
+        catch (...)
+        {
+            lwsl_err("lwspp: the event of the connection %llu failed\n",
+                     static_cast<unsigned long long>(strand.connectionId));
+            closeConnection_(strand.connectionId);
+        }
+    }
+
+    // The unfinished strand stays scheduled and waits for its next turn
+    const std::lock_guard<std::mutex> guard(strand.mutex);
+    if (strand.events.empty())
+    {
+        strand.isScheduled = false;
+        return false;
+    }
+    return true;
+}
+
+void LwsLogicDispatcher::runWorker_()
+{
+    while (true)
+    {
+        StrandPtr strand;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _hasReadyStrands.wait(lock, [this]{ return _isStopping || !_readyStrands.empty(); });
+            // The events queued before the stop are run anyway
+            if (_readyStrands.empty())
+            {
+                return;
+            }
+
+            strand = std::move(_readyStrands.front());
+            _readyStrands.pop_front();
+        }
+
+        // The other strands wait less if the unfinished one is put at the back
+        if (runStrand_(*strand))
+        {
+            const std::lock_guard<std::mutex> guard(_mutex);
+            _readyStrands.push_back(std::move(strand));
+        }
+    }
+}
+
+// NOTE: The lws_rx_flow_control can not be called outside of the service thread, the service
+// thread is woken up instead and resumes the reading itself, see ILwsPendingWrites. The reading
+// stays paused if the logic has paused it as well.
+void LwsLogicDispatcher::resumeReceiving_(ConnectionId connectionId)
+{
+    ILwsCallbackNotifierPtr notifier;
+    {
+        const std::lock_guard<std::mutex> guard(_mutex);
+        notifier = _notifier;
+    }
+
+    auto connection = _connections->get(connectionId);
+    if (notifier != nullptr && connection != nullptr &&
+        connection->resumeReceiving(ReceivingPauseReason::LogicDispatcher))
+    {
+        notifier->notifyReceivingChanged(connection);
+    }
+}
+
+// The service thread closes the connection, see ILwsCallbackNotifier::notifyCloseConnection
+void LwsLogicDispatcher::closeConnection_(ConnectionId connectionId) noexcept
+{
+    try
+    {
+        ILwsCallbackNotifierPtr notifier;
+        {
+            const std::lock_guard<std::mutex> guard(_mutex);
+            notifier = _notifier;
+        }
+
+        auto connection = _connections->get(connectionId);
+        if (notifier != nullptr && connection != nullptr)
+        {
+            notifier->notifyCloseConnection(connection);
+        }
+    }
+    catch (...)
+    {
+        lwsl_err("lwspp: the connection %llu is not closed\n",
+                 static_cast<unsigned long long>(connectionId));
+    }
+}
+
+} // namespace srv
+} // namespace lwspp
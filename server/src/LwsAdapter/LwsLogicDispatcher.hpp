@@ -0,0 +1,135 @@
+/*
+ * lwspp - C++ wrapper for the libwebsockets library
+ *
+ * Copyright (C) 2023 - 2023 Volodymyr Lotoshko <vlotoshko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "lwspp/server/contract/IServerLogic.hpp"
+
+#include "LwsAdapter/LwsTypesFwd.hpp"
+
+namespace lwspp
+{
+namespace srv
+{
+
+/**
+ * @brief The LwsLogicDispatcher class passes the events to the server logic on the worker
+ * threads, so the slow logic does not hold the service threads. The events of every connection
+ * are queued to its own strand, which is run by one worker at a time, so they keep their order.
+ * Any idle worker takes the next ready strand. The service thread never waits for the workers,
+ * the reading from the connection is paused instead when its strand is full. The events are
+ * queued under the lock of their strand, the shared lock is taken only to schedule the strand.
+ */
+class LwsLogicDispatcher : public contract::IServerLogic
+{
+public:
+    LwsLogicDispatcher(contract::IServerLogicPtr, ILwsConnectionsPtr, unsigned int threads,
+                       size_t maxQueuedEvents);
+    ~LwsLogicDispatcher() override;
+
+    LwsLogicDispatcher(const LwsLogicDispatcher&) = delete;
+    auto operator=(const LwsLogicDispatcher&) -> LwsLogicDispatcher& = delete;
+
+    LwsLogicDispatcher(LwsLogicDispatcher&&) = delete;
+    auto operator=(LwsLogicDispatcher&&) -> LwsLogicDispatcher& = delete;
+
+    // The notifier wakes up the service thread to resume the reading from the connection
+    void setCallbackNotifier(ILwsCallbackNotifierPtr);
+    // Runs the events queued so far and stops the workers, the later events are passed
+    // to the logic directly
+    void stop();
+
+    void onFirstDataPacket(ConnectionId, size_t messageLength) noexcept override;
+    void onBinaryDataReceive(ConnectionId, const DataPacket&) noexcept override;
+    void onTextDataReceive(ConnectionId, const DataPacket&) noexcept override;
+
+    void onConnect(IConnectionInfoPtr) noexcept override;
+    void onDisconnect(ConnectionId) noexcept override;
+    void onError(ConnectionId, const std::string& errorMessage) noexcept override;
+    void onWarning(ConnectionId, const std::string& errorMessage) noexcept override;
+
+    void onWatermark(ConnectionId, Watermark) noexcept override;
+
+private:
+    using Event = std::function<void(contract::IServerLogic&)>;
+
+    struct Strand
+    {
+        ConnectionId connectionId;
+        std::deque<Event> events;
+        bool isScheduled = false;
+        bool isReceivingPaused = false;
+        std::mutex mutex;
+    };
+    using StrandPtr = std::shared_ptr<Strand>;
+
+    // The strands are split by the connection id, so the events of the different connections
+    // do not contend for the one lock of the map
+    struct StrandsShard
+    {
+        std::unordered_map<ConnectionId, StrandPtr> strands;
+        std::mutex mutex;
+    };
+    static const size_t STRANDS_SHARDS = 16;
+
+    // The event is made inside, so the connection is closed if it can not be queued, see
+    // closeConnection_. The received data pauses the reading when the strand is full, the
+    // service thread only.
+    template <typename MakeEvent>
+    void dispatch_(ConnectionId, MakeEvent, bool isReceived) noexcept;
+    auto getStrand_(ConnectionId) -> StrandPtr;
+    void removeStrand_(ConnectionId);
+    // Returns true if the strand still has the events after its turn
+    auto runStrand_(Strand&) -> bool;
+    void runWorker_();
+    void resumeReceiving_(ConnectionId);
+    void closeConnection_(ConnectionId) noexcept;
+
+private:
+    contract::IServerLogicPtr _serverLogic;
+    ILwsConnectionsPtr _connections;
+    ILwsCallbackNotifierPtr _notifier;
+    size_t _maxQueuedEvents;
+
+    std::array<StrandsShard, STRANDS_SHARDS> _shards;
+    // The ready strands and the stop flag are guarded by the mutex
+    std::deque<StrandPtr> _readyStrands;
+    std::vector<std::thread> _workers;
+    bool _isStopping = false;
+    std::condition_variable _hasReadyStrands;
+    std::mutex _mutex;
+};
+
+} // namespace srv
+} // namespace lwspp
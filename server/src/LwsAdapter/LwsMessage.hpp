@@ -0,0 +1,93 @@
+/*
+ * lwspp - C++ wrapper for the libwebsockets library
+ *
+ * Copyright (C) 2023 - 2023 Volodymyr Lotoshko <vlotoshko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "lwspp/server/SendBuffer.hpp"
+#include "LwsAdapter/LwsTypes.hpp"
+
+namespace lwspp
+{
+namespace srv
+{
+
+/**
+ * @brief The Payload class owns the message data with LWS_PRE bytes of the headroom in front
+ * of it, see lws_write description. The same payload can be shared by several connections,
+ * e.g. on broadcast. The lws_write writes the frame header into the headroom, so the shared
+ * payload is never written in place, see ILwsConnection::getWriteBuffer.
+ */
+class Payload
+{
+public:
+    // Takes the buffer which already has the headroom in front of the data
+    explicit Payload(std::string);
+
+    auto data() -> unsigned char*;
+    auto size() const -> size_t;
+
+private:
+    std::string _buffer;
+};
+
+// Copies the data into the new payload
+auto makeMessage(DataType, const std::string&) -> Message;
+auto makeMessage(DataType, const std::vector<char>&) -> Message;
+
+// Takes the ownership of the data without any copy
+auto makeMessage(DataType, SendBuffer&&) -> Message;
+
+// The binary message streamed from the producer, see contract::IStreamProducer
+auto makeStreamMessage(contract::IStreamProducerPtr) -> Message;
+
+// The size of the message data held by the queue. The streamed data is not held by the queue.
+auto getQueuedSize(const Message&) -> size_t;
+
+// The first fragment of the message is written, no other message can be written until its last one
+auto isWriteStarted(const Message&) -> bool;
+
+// The message of the given priority, see IServerControl
+template <typename Data>
+auto makePrioritizedMessage(DataType dataType, Priority priority, Data&& data) -> Message
+{
+    auto message = makeMessage(dataType, std::forward<Data>(data));
+    message.priority = priority;
+    return message;
+}
+
+// The message conflated by the key, see IServerControl
+template <typename Data>
+auto makeConflatedMessage(DataType dataType, const ConflationKey& key, Data&& data) -> Message
+{
+    auto message = makeMessage(dataType, std::forward<Data>(data));
+    message.conflationKey = key;
+    return message;
+}
+
+} // namespace srv
+} // namespace lwspp
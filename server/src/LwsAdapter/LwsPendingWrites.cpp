@@ -0,0 +1,157 @@
+/*
+ * lwspp - C++ wrapper for the libwebsockets library
+ *
+ * Copyright (C) 2023 - 2023 Volodymyr Lotoshko <vlotoshko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <libwebsockets.h>
+
+#include "LwsAdapter/ILwsConnection.hpp"  // IWYU pragma: keep
+#include "LwsAdapter/ILwsConnections.hpp" // IWYU pragma: keep
+#include "LwsAdapter/LwsPendingWrites.hpp"
+#include "lwspp/server/contract/IServerLogic.hpp" // IWYU pragma: keep
+
+namespace lwspp
+{
+namespace srv
+{
+
+LwsPendingWrites::LwsPendingWrites(unsigned int serviceThreads, ILwsConnectionsPtr c)
+    : _connections(std::move(c))
+{
+    for (unsigned int i = 0; i < serviceThreads; ++i)
+    {
+        _serviceThreads.push_back(std::unique_ptr<ServiceThreadWrites>(new ServiceThreadWrites{}));
+    }
+}
+
+auto LwsPendingWrites::add(const ILwsConnectionPtr& connection) -> bool
+{
+    // NOTE: The service thread is checked before the connection is marked, otherwise the mark
+    // is never cleared and the connection is never queued again
+    auto* writes = getServiceThreadWrites_(connection->getServiceThreadIndex());
+    if (writes == nullptr)
+    {
+        return false;
+    }
+
+    // The connection is already queued, the wake up is requested by the one who queued it
+    if (!connection->markPendingWrite())
+    {
+        return false;
+    }
+
+    writes->connections.push(connection);
+    return !writes->wakeupRequested.exchange(true);
+}
+
+auto LwsPendingWrites::addAllConnections() -> bool
+{
+    bool wakeupRequired = false;
+    for (auto& writes : _serviceThreads)
+    {
+        writes->allConnections = true;
+        wakeupRequired = !writes->wakeupRequested.exchange(true) || wakeupRequired;
+    }
+    return wakeupRequired;
+}
+
+void LwsPendingWrites::requestWritable(int serviceThreadIndex, contract::IServerLogic& serverLogic)
+{
+    auto* writes = getServiceThreadWrites_(serviceThreadIndex);
+    if (writes == nullptr)
+    {
+        return;
+    }
+
+    // NOTE: The flag is cleared before the connections are taken, so the data added after this
+    // point requests the new wake up
+    writes->wakeupRequested = false;
+
+    if (writes->allConnections.exchange(false))
+    {
+        for (auto& connection : *_connections->getAllConnections())
+        {
+            if (connection != nullptr &&
+                connection->getServiceThreadIndex() == serviceThreadIndex)
+            {
+                connection->clearPendingWrite();
+                serviceConnection_(*connection, serverLogic);
+            }
+        }
+    }
+
+    while (auto* front = writes->connections.front())
+    {
+        auto connection = std::move(*front);
+        writes->connections.pop();
+
+        // The connection could be already closed, or already processed above
+        if (connection->clearPendingWrite() &&
+            _connections->get(connection->getConnectionId()) == connection)
+        {
+            serviceConnection_(*connection, serverLogic);
+        }
+    }
+}
+
+auto LwsPendingWrites::getServiceThreadWrites_(int serviceThreadIndex) -> ServiceThreadWrites*
+{
+    if (serviceThreadIndex < 0 || static_cast<size_t>(serviceThreadIndex) >= _serviceThreads.size())
+    {
+        return nullptr;
+    }
+    return _serviceThreads[static_cast<size_t>(serviceThreadIndex)].get();
+}
+
+// Runs on the service thread of the connection, so the pending data can be trimmed here
+void LwsPendingWrites::serviceConnection_(ILwsConnection& connection,
+                                          contract::IServerLogic& serverLogic)
+{
+    auto* wsInstance = connection.getLwsInstance();
+
+    // The slow consumer may never become writable, so it is closed without waiting for that
+    if (connection.getCloseReason() == CloseReason::SlowConsumer)
+    {
+        lws_close_reason(wsInstance, LWS_CLOSE_STATUS_POLICY_VIOLATION, nullptr, 0);
+        lws_set_timeout(wsInstance, PENDING_TIMEOUT_CLOSE_SEND, LWS_TO_KILL_ASYNC);
+        return;
+    }
+
+    if (connection.takeReceivingChange())
+    {
+        lws_rx_flow_control(wsInstance, connection.isReceivingPaused() ? 0 : 1);
+    }
+
+    // The stalled connection does not become writable, the watermarks and the limits are kept here
+    if (connection.takeHighWatermark())
+    {
+        serverLogic.onWatermark(connection.getConnectionId(), Watermark::High);
+    }
+    if (connection.trimPendingData())
+    {
+        serverLogic.onWatermark(connection.getConnectionId(), Watermark::Low);
+    }
+    lws_callback_on_writable(wsInstance);
+}
+
+} // namespace srv
+} // namespace lwspp
@@ -0,0 +1,67 @@
+/*
+ * lwspp - C++ wrapper for the libwebsockets library
+ *
+ * Copyright (C) 2023 - 2023 Volodymyr Lotoshko <vlotoshko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "LwsAdapter/ILwsPendingWrites.hpp"
+#include "MpscQueue.hpp"
+
+namespace lwspp
+{
+namespace srv
+{
+
+class LwsPendingWrites : public ILwsPendingWrites
+{
+public:
+    LwsPendingWrites(unsigned int serviceThreads, ILwsConnectionsPtr);
+
+    auto add(const ILwsConnectionPtr&) -> bool override;
+    auto addAllConnections() -> bool override;
+
+    void requestWritable(int serviceThreadIndex, contract::IServerLogic&) override;
+
+private:
+    // Pending connections of the one service thread
+    struct ServiceThreadWrites
+    {
+        MpscQueue<ILwsConnectionPtr> connections;
+        std::atomic<bool> allConnections{false};
+        std::atomic<bool> wakeupRequested{false};
+    };
+
+    auto getServiceThreadWrites_(int serviceThreadIndex) -> ServiceThreadWrites*;
+    void serviceConnection_(ILwsConnection&, contract::IServerLogic&);
+
+private:
+    std::vector<std::unique_ptr<ServiceThreadWrites>> _serviceThreads;
+    ILwsConnectionsPtr _connections;
+};
+
+} // namespace srv
+} // namespace lwspp
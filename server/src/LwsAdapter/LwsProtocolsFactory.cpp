@@ -26,6 +26,7 @@
 
 #include "LwsAdapter/LwsCallback.hpp"
 #include "LwsAdapter/LwsProtocolsFactory.hpp"
+#include "LwsAdapter/LwsTypes.hpp"
 
 namespace lwspp
 {
@@ -38,7 +39,8 @@ const lws_protocols LWS_PROTOCOL_TERM_LIST { nullptr, nullptr, 0, 0, 0, nullptr,
 
 } // namespace
 
-auto createLwsProtocols(CallbackVersion version, const std::string& protocolName) -> LwsProtocols
+auto createLwsProtocols(CallbackVersion version, const std::string& protocolName,
+                        size_t rxBufferSize, size_t txPacketSize) -> LwsProtocols
 {
     LwsCallback* callback = nullptr;
 
@@ -47,6 +49,9 @@ auto createLwsProtocols(CallbackVersion version, const std::string& protocolName
     case CallbackVersion::v1_Andromeda:
         callback = lwsCallback_v1;
         break;
+    case CallbackVersion::v2_BlackHole:
+        callback = lwsCallback_v2;
+        break;
     default:
         // TODO: throw exception unsupported version
         break;
@@ -56,11 +61,11 @@ auto createLwsProtocols(CallbackVersion version, const std::string& protocolName
         {
             protocolName.c_str(),
             callback,
-            0, // per connection data size, not used
-            0, // rx buffer size
+            sizeof(LwsSession), // per connection data size
+            rxBufferSize, // rx buffer size
             static_cast<unsigned int>(version), // id
             nullptr, // pointer on user data
-            0 // tx packet size
+            txPacketSize // tx packet size
         },
         LWS_PROTOCOL_TERM_LIST
     };
@@ -32,7 +32,9 @@ namespace lwspp
 namespace srv
 {
 
-auto createLwsProtocols(CallbackVersion, const std::string& protocolName) -> LwsProtocols;
+// The zero buffer sizes keep the libwebsockets defaults
+auto createLwsProtocols(CallbackVersion, const std::string& protocolName,
+                        size_t rxBufferSize, size_t txPacketSize) -> LwsProtocols;
 
 } // namespace srv
 } // namespace lwspp
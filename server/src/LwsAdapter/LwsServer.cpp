@@ -22,9 +22,12 @@
  * IN THE SOFTWARE.
  */
 
+#include <future>
 #include <libwebsockets.h>
 #include <stdexcept>
+#include <vector>
 
+#include "lwspp/server/contract/IEventLoop.hpp"
 #include "lwspp/server/contract/IServerControlAcceptor.hpp" // IWYU pragma: keep
 
 #include "LwsAdapter/ILwsCallbackNotifier.hpp"
@@ -33,8 +36,11 @@
 #include "LwsAdapter/LwsConnections.hpp"
 #include "LwsAdapter/LwsContextDeleter.hpp"
 #include "LwsAdapter/LwsDataHolder.hpp"
+#include "LwsAdapter/LwsLogicDispatcher.hpp"
+#include "LwsAdapter/LwsPendingWrites.hpp"
 #include "LwsAdapter/LwsServer.hpp"
 #include "LwsAdapter/LwsServerControl.hpp"
+#include "LwsAdapter/LwsTopics.hpp"
 #include "ServerContext.hpp"
 #include "SslSettings.hpp" // IWYU pragma: keep
 
@@ -48,39 +54,113 @@ namespace
 class LwsCallbackNotifier : public ILwsCallbackNotifier
 {
 public:
-    LwsCallbackNotifier(const LwsDataHolderPtr& d, const LowLevelContextPtr& c)
-        : _dataHolder(d)
+    LwsCallbackNotifier(ILwsPendingWritesPtr w, const LowLevelContextPtr& c,
+                        contract::IEventLoopPtr l)
+        : _pendingWrites(std::move(w))
         , _lowLevelContext(c)
+        , _eventLoop(std::move(l))
     {}
-    
+
+    // NOTE: The lws_callback_on_writable can not be called outside of the service thread,
+    // the service thread is woken up instead and requests the writable callbacks itself.
+    // All the notifications made before the service thread wakes up cost the one wake up.
     void notifyPendingDataAdded(const ILwsConnectionPtr& connection) override
     {
-        lws_callback_on_writable(connection->getLwsInstance());
+        if (_pendingWrites->add(connection))
+        {
+            wakeUpServiceThread_(*connection);
+        }
     }
 
     void notifyPendingDataAdded() override
     {
-        if (auto context = _lowLevelContext.lock())
+        if (_pendingWrites->addAllConnections())
+        {
+            wakeUpService_();
+        }
+    }
+
+    // The connections of every service thread cost the one wake up of that thread
+    void notifyPendingDataAdded(const std::vector<ILwsConnectionPtr>& connections) override
+    {
+        for (const auto& connection : connections)
         {
-            if (auto dataHolder = _dataHolder.lock())
+            if (_pendingWrites->add(connection))
             {
-                lws_callback_on_writable_all_protocol(
-                    context.get(), dataHolder->protocols.data());
+                wakeUpServiceThread_(*connection);
             }
         }
     }
 
+    void notifyReceivingChanged(const ILwsConnectionPtr& connection) override
+    {
+        notifyPendingDataAdded(connection);
+    }
+
     void notifyCloseConnection(const ILwsConnectionPtr& connection) override
     {
-        connection->markToClose();
-        lws_callback_on_writable(connection->getLwsInstance());
+        connection->markToClose(CloseReason::GoingAway);
+        notifyPendingDataAdded(connection);
+    }
+
+private:
+    // Wakes up the service thread of the connection only, the others have nothing to do
+    void wakeUpServiceThread_(ILwsConnection& connection)
+    {
+        // The cancel pipe of the libwebsockets is not watched by the external event loop
+        if (_eventLoop != nullptr)
+        {
+            _eventLoop->wakeUp();
+        }
+        else if (!connection.wakeUpServiceThread())
+        {
+            // The connection is closed meanwhile, the wake up is still required by the others
+            wakeUpService_();
+        }
+    }
+
+    // Wakes up all the service threads
+    void wakeUpService_()
+    {
+        // The cancel pipe of the libwebsockets is not watched by the external event loop
+        if (_eventLoop != nullptr)
+        {
+            _eventLoop->wakeUp();
+        }
+        else if (auto context = _lowLevelContext.lock())
+        {
+            lws_cancel_service(context.get());
+        }
     }
 
 private:
-    LwsDataHolderWeak _dataHolder;
+    ILwsPendingWritesPtr _pendingWrites;
     LowLevelContextWeak _lowLevelContext;
+    contract::IEventLoopPtr _eventLoop;
 };
 
+// The sockets are passed to the external event loop and the listening socket is tuned by the
+// poll callbacks, which are emitted only by the libwebsockets built with the
+// LWS_WITH_EXTERNAL_POLL option
+void checkExternalPollSupport(const ServerContext& context)
+{
+#if !defined(LWS_WITH_EXTERNAL_POLL)
+    if (context.eventLoop != nullptr)
+    {
+        throw std::runtime_error{
+            "the external event loop requires the libwebsockets built with LWS_WITH_EXTERNAL_POLL"};
+    }
+
+    if (context.listenBacklog != UNDEFINED_UNSET)
+    {
+        throw std::runtime_error{
+            "the listen backlog requires the libwebsockets built with LWS_WITH_EXTERNAL_POLL"};
+    }
+#else
+    static_cast<void>(context);
+#endif
+}
+
 void setupSslSettings(lws_context_creation_info& lwsContextInfo, const SslSettingsPtr& ssl)
 {
     if (ssl != nullptr)
@@ -135,6 +215,12 @@ auto setupLowLeverContext(const ILwsCallbackContextPtr& callbackContext,
     lwsContextInfo.user = callbackContext.get();
     lwsContextInfo.port = dataHolder->port;
     lwsContextInfo.protocols = dataHolder->protocols.data();
+    lwsContextInfo.count_threads = dataHolder->serviceThreads;
+
+    if (!dataHolder->extensions.empty())
+    {
+        lwsContextInfo.extensions = dataHolder->extensions.data();
+    }
 
     if (dataHolder->keepAliveTimeout != UNDEFINED_UNSET)
     {
@@ -171,14 +257,46 @@ auto setupLowLeverContext(const ILwsCallbackContextPtr& callbackContext,
 } // namespace
 
 LwsServer::LwsServer(const ServerContext& context)
+    : _eventLoop(context.eventLoop)
 {
+    checkExternalPollSupport(context);
+
     auto connections = std::make_shared<LwsConnections>();
-    _callbackContext = std::make_shared<LwsCallbackContext>(context.serverLogic, connections);
+    auto topics = std::make_shared<LwsTopics>(connections);
+    auto pendingWrites = std::make_shared<LwsPendingWrites>(context.serviceThreads, connections);
+    const auto writeBudget = WriteBudget{context.maxMessagesPerWrite, context.maxBytesPerWrite,
+                                         context.maxFragmentSize};
+    const auto socketSettings = SocketSettings{context.socketSendBufferSize,
+                                               context.socketReceiveBufferSize,
+                                               context.tcpNoDelay, context.listenBacklog};
+    const auto queueLimits = QueueLimits{context.maxQueuedMessages, context.maxQueuedBytes,
+                                         context.slowConsumerPolicy};
+    auto serverLogic = context.serverLogic;
+    if (context.logicThreads != 0)
+    {
+        _logicDispatcher = std::make_shared<LwsLogicDispatcher>(context.serverLogic, connections,
+                                                                context.logicThreads,
+                                                                context.maxQueuedLogicEvents);
+        serverLogic = _logicDispatcher;
+    }
+
+    _callbackContext = std::make_shared<LwsCallbackContext>(std::move(serverLogic), connections,
+                                                            topics, pendingWrites, writeBudget,
+                                                            queueLimits, context.streamChunkSize,
+                                                            context.maxMessageSize,
+                                                            context.compression, socketSettings,
+                                                            context.eventLoop);
     _dataHolder = std::make_shared<LwsDataHolder>(context);
     _lowLevelContext = setupLowLeverContext(_callbackContext, _dataHolder);
 
-    auto notifier = std::make_shared<LwsCallbackNotifier>(_dataHolder, _lowLevelContext);
-    auto sender = std::make_shared<LwsServerControl>(connections, std::move(notifier));
+    auto notifier = std::make_shared<LwsCallbackNotifier>(pendingWrites, _lowLevelContext,
+                                                          context.eventLoop);
+    if (_logicDispatcher != nullptr)
+    {
+        _logicDispatcher->setCallbackNotifier(notifier);
+    }
+    auto sender = std::make_shared<LwsServerControl>(connections, std::move(topics),
+                                                     std::move(notifier));
     context.serverControlAcceptor->acceptServerControl(std::move(sender));
 }
 
@@ -186,6 +304,14 @@ LwsServer::~LwsServer()
 {
     stopListening();
     waitForServerStopped_();
+
+    // NOTE: The connections are closed when the context is destroyed, so the workers are stopped
+    // after that to run the disconnect events
+    _lowLevelContext.reset();
+    if (_logicDispatcher != nullptr)
+    {
+        _logicDispatcher->stop();
+    }
 }
 
 void LwsServer::startListening()
@@ -202,20 +328,44 @@ void LwsServer::startListening()
         }
     }
 
-    int res = 0;
-    while (res >= 0 && _state != State::Stopping)
+    // The external event loop services the context on its own thread
+    if (_eventLoop != nullptr)
+    {
+        return;
+    }
+
+    // The libwebsockets may create less threads than requested, see LWS_MAX_SMP
+    const int threadsCount = lws_get_count_threads(_lowLevelContext.get());
+
+    // The current thread services the first thread service index, the others are serviced
+    // by the additional threads
+    std::vector<std::future<int>> serviceLoops;
+    for (int tsi = 1; tsi < threadsCount; ++tsi)
+    {
+        serviceLoops.push_back(std::async(std::launch::async, [this, tsi]{ return runServiceLoop_(tsi); }));
+    }
+
+    int res = runServiceLoop_(0);
+    for (auto& serviceLoop : serviceLoops)
+    {
+        const int loopRes = serviceLoop.get();
+        if (res >= 0)
+        {
+            res = loopRes;
+        }
+    }
+
     {
-        res = lws_service(_lowLevelContext.get(), 0);
+        const std::lock_guard<std::mutex> guard(_mutex);
+        _state = State::Stopped;
     }
+    _isStoppedCV.notify_one();
 
     if (res < 0)
     {
         throw std::runtime_error{
             std::string{"lws_service stopped with the error code: "}.append(std::to_string(res))};
     }
-
-    _state = State::Stopped;
-    _isStoppedCV.notify_one();
 }
 
 void LwsServer::stopListening()
@@ -227,10 +377,60 @@ void LwsServer::stopListening()
     }
     else if (_state == State::Started)
     {
-        _state = State::Stopping;
         _callbackContext->setStopping();
-        lws_cancel_service(_lowLevelContext.get());
+        if (_eventLoop != nullptr)
+        {
+            // There is no service loop to wait for
+            _state = State::Stopped;
+        }
+        else
+        {
+            _state = State::Stopping;
+            lws_cancel_service(_lowLevelContext.get());
+        }
+    }
+}
+
+void LwsServer::serviceFd(int fd, short revents)
+{
+    auto pollFd = lws_pollfd{};
+    pollFd.fd = fd;
+    pollFd.events = revents;
+    pollFd.revents = revents;
+
+    const int res = lws_service_fd(_lowLevelContext.get(), &pollFd);
+    if (res < 0)
+    {
+        throw std::runtime_error{
+            std::string{"lws_service_fd failed with the error code: "}.append(std::to_string(res))};
+    }
+}
+
+auto LwsServer::service() -> int
+{
+    // Does the work of the LWS_CALLBACK_EVENT_WAIT_CANCELLED, since the external event loop is
+    // woken up instead of the libwebsockets one
+    _callbackContext->getPendingWrites()->requestWritable(0, *_callbackContext->getServerLogic());
+
+    // The null descriptor services the timeouts and the buffered data only
+    lws_service_fd(_lowLevelContext.get(), nullptr);
+    return lws_service_adjust_timeout(_lowLevelContext.get(), MAX_EVENT_LOOP_TIMEOUT_MS, 0);
+}
+
+auto LwsServer::runServiceLoop_(int tsi) -> int
+{
+    int res = 0;
+    while (res >= 0 && _state != State::Stopping)
+    {
+        res = lws_service_tsi(_lowLevelContext.get(), 0, tsi);
+    }
+
+    if (res < 0)
+    {
+        // Stops the service loops running in the other threads
+        stopListening();
     }
+    return res;
 }
 
 void LwsServer::waitForServerStopped_()
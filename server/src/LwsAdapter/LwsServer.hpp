@@ -24,12 +24,14 @@
 
 #pragma once
 
+#include <atomic>
 #include <condition_variable>
 #include <cstdint>
 #include <mutex>
 
 #include "LwsAdapter/LwsTypesFwd.hpp"
 #include "TypesFwd.hpp"
+#include "lwspp/server/TypesFwd.hpp"
 
 namespace lwspp
 {
@@ -48,11 +50,18 @@ public:
     LwsServer(const LwsServer&) = delete;
     auto operator=(const LwsServer&) -> LwsServer& = delete;
 
-    // NOTE: the 'startListening' method blocks the thread
+    // NOTE: the 'startListening' method blocks the thread. When the server is configured with
+    // several service threads, the additional threads are started and joined by this method.
+    // When the server is serviced by the external event loop, the method returns immediately
     void startListening();
     void stopListening();
 
+    // The external event loop interface, see IServer
+    void serviceFd(int fd, short revents);
+    auto service() -> int;
+
 private:
+    auto runServiceLoop_(int tsi) -> int;
     void waitForServerStopped_();
 
 private:
@@ -67,9 +76,11 @@ private:
     ILwsCallbackContextPtr _callbackContext;
     LwsDataHolderPtr _dataHolder;
     LowLevelContextPtr _lowLevelContext;
+    LwsLogicDispatcherPtr _logicDispatcher;
+    contract::IEventLoopPtr _eventLoop;
 
     std::condition_variable _isStoppedCV;
-    State _state = State::Initial;
+    std::atomic<State> _state{State::Initial};
     std::mutex _mutex;
 };
 
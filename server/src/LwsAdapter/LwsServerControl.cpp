@@ -26,72 +26,347 @@
 #include "LwsAdapter/ILwsCallbackNotifier.hpp" // IWYU pragma: keep
 #include "LwsAdapter/ILwsConnection.hpp"       // IWYU pragma: keep
 #include "LwsAdapter/ILwsConnections.hpp"      // IWYU pragma: keep
+#include "LwsAdapter/ILwsTopics.hpp"           // IWYU pragma: keep
+#include "LwsAdapter/LwsMessage.hpp"
 
 namespace lwspp
 {
 namespace srv
 {
 
-LwsServerControl::LwsServerControl(ILwsConnectionsPtr s, ILwsCallbackNotifierPtr n)
+LwsServerControl::LwsServerControl(ILwsConnectionsPtr s, ILwsTopicsPtr t,
+                                   ILwsCallbackNotifierPtr n)
     : _connections(std::move(s))
+    , _topics(std::move(t))
     , _notifier(std::move(n))
 {}
 
-void LwsServerControl::sendTextData(ConnectionId connectionId, const std::string& message)
+auto LwsServerControl::sendTextData(ConnectionId connectionId, const std::string& message)
+-> SendResult
+{
+    return sendMessage_(connectionId, makeMessage(DataType::Text, message));
+}
+
+auto LwsServerControl::sendBinaryData(ConnectionId connectionId, const std::vector<char>& data)
+-> SendResult
+{
+    return sendMessage_(connectionId, makeMessage(DataType::Binary, data));
+}
+
+void LwsServerControl::sendTextData(const std::string& message)
+{
+    broadcastMessage_(makeMessage(DataType::Text, message));
+}
+
+void LwsServerControl::sendBinaryData(const std::vector<char>& data)
+{
+    broadcastMessage_(makeMessage(DataType::Binary, data));
+}
+
+auto LwsServerControl::sendTextData(ConnectionId connectionId, SendBuffer&& message)
+-> SendResult
+{
+    return sendMessage_(connectionId, makeMessage(DataType::Text, std::move(message)));
+}
+
+auto LwsServerControl::sendBinaryData(ConnectionId connectionId, SendBuffer&& data)
+-> SendResult
+{
+    return sendMessage_(connectionId, makeMessage(DataType::Binary, std::move(data)));
+}
+
+void LwsServerControl::sendTextData(SendBuffer&& message)
+{
+    broadcastMessage_(makeMessage(DataType::Text, std::move(message)));
+}
+
+void LwsServerControl::sendBinaryData(SendBuffer&& data)
+{
+    broadcastMessage_(makeMessage(DataType::Binary, std::move(data)));
+}
+
+auto LwsServerControl::sendTextData(ConnectionId connectionId, const std::string& message,
+                                    Priority priority)
+-> SendResult
+{
+    return sendMessage_(connectionId,
+                        makePrioritizedMessage(DataType::Text, priority, message));
+}
+
+auto LwsServerControl::sendBinaryData(ConnectionId connectionId, const std::vector<char>& data,
+                                      Priority priority)
+-> SendResult
+{
+    return sendMessage_(connectionId,
+                        makePrioritizedMessage(DataType::Binary, priority, data));
+}
+
+auto LwsServerControl::sendTextData(ConnectionId connectionId, SendBuffer&& message,
+                                    Priority priority)
+-> SendResult
+{
+    return sendMessage_(connectionId,
+                        makePrioritizedMessage(DataType::Text, priority, std::move(message)));
+}
+
+auto LwsServerControl::sendBinaryData(ConnectionId connectionId, SendBuffer&& data,
+                                      Priority priority)
+-> SendResult
+{
+    return sendMessage_(connectionId,
+                        makePrioritizedMessage(DataType::Binary, priority, std::move(data)));
+}
+
+auto LwsServerControl::sendBinaryStream(ConnectionId connectionId,
+                                        contract::IStreamProducerPtr producer)
+-> SendResult
+{
+    return sendMessage_(connectionId, makeStreamMessage(std::move(producer)));
+}
+
+auto LwsServerControl::sendTextData(ConnectionId connectionId, const ConflationKey& key,
+                                    const std::string& message)
+-> SendResult
+{
+    return sendMessage_(connectionId, makeConflatedMessage(DataType::Text, key, message));
+}
+
+auto LwsServerControl::sendBinaryData(ConnectionId connectionId, const ConflationKey& key,
+                                      const std::vector<char>& data)
+-> SendResult
+{
+    return sendMessage_(connectionId, makeConflatedMessage(DataType::Binary, key, data));
+}
+
+auto LwsServerControl::sendTextData(ConnectionId connectionId, const ConflationKey& key,
+                                    SendBuffer&& message)
+-> SendResult
+{
+    return sendMessage_(connectionId,
+                        makeConflatedMessage(DataType::Text, key, std::move(message)));
+}
+
+auto LwsServerControl::sendBinaryData(ConnectionId connectionId, const ConflationKey& key,
+                                      SendBuffer&& data)
+-> SendResult
+{
+    return sendMessage_(connectionId,
+                        makeConflatedMessage(DataType::Binary, key, std::move(data)));
+}
+
+void LwsServerControl::sendTextData(const std::vector<ConnectionId>& connectionIds,
+                                    const std::string& message)
+{
+    multicastMessage_(connectionIds, makeMessage(DataType::Text, message));
+}
+
+void LwsServerControl::sendBinaryData(const std::vector<ConnectionId>& connectionIds,
+                                      const std::vector<char>& data)
+{
+    multicastMessage_(connectionIds, makeMessage(DataType::Binary, data));
+}
+
+void LwsServerControl::sendTextData(const std::vector<ConnectionId>& connectionIds,
+                                    SendBuffer&& message)
+{
+    multicastMessage_(connectionIds, makeMessage(DataType::Text, std::move(message)));
+}
+
+void LwsServerControl::sendBinaryData(const std::vector<ConnectionId>& connectionIds,
+                                      SendBuffer&& data)
+{
+    multicastMessage_(connectionIds, makeMessage(DataType::Binary, std::move(data)));
+}
+
+void LwsServerControl::sendTextDataExcept(ConnectionId excludedId, const std::string& message)
+{
+    broadcastMessage_(makeMessage(DataType::Text, message), excludedId);
+}
+
+void LwsServerControl::sendBinaryDataExcept(ConnectionId excludedId,
+                                            const std::vector<char>& data)
+{
+    broadcastMessage_(makeMessage(DataType::Binary, data), excludedId);
+}
+
+void LwsServerControl::sendTextDataExcept(ConnectionId excludedId, SendBuffer&& message)
+{
+    broadcastMessage_(makeMessage(DataType::Text, std::move(message)), excludedId);
+}
+
+void LwsServerControl::sendBinaryDataExcept(ConnectionId excludedId, SendBuffer&& data)
+{
+    broadcastMessage_(makeMessage(DataType::Binary, std::move(data)), excludedId);
+}
+
+auto LwsServerControl::subscribe(ConnectionId connectionId, const Topic& topic) -> bool
+{
+    return _topics->subscribe(connectionId, topic);
+}
+
+void LwsServerControl::unsubscribe(ConnectionId connectionId, const Topic& topic)
+{
+    _topics->unsubscribe(connectionId, topic);
+}
+
+void LwsServerControl::publishTextData(const Topic& topic, const std::string& message)
+{
+    publishMessage_(topic, makeMessage(DataType::Text, message));
+}
+
+void LwsServerControl::publishBinaryData(const Topic& topic, const std::vector<char>& data)
+{
+    publishMessage_(topic, makeMessage(DataType::Binary, data));
+}
+
+void LwsServerControl::publishTextData(const Topic& topic, SendBuffer&& message)
+{
+    publishMessage_(topic, makeMessage(DataType::Text, std::move(message)));
+}
+
+void LwsServerControl::publishBinaryData(const Topic& topic, SendBuffer&& data)
+{
+    publishMessage_(topic, makeMessage(DataType::Binary, std::move(data)));
+}
+
+// The service thread pulls the parked stream again when the connection becomes writable
+auto LwsServerControl::resumeStream(ConnectionId connectionId) -> bool
+{
+    auto connection = _connections->get(connectionId);
+    if (connection == nullptr)
+    {
+        return false;
+    }
+
+    _notifier->notifyPendingDataAdded(connection);
+    return true;
+}
+
+auto LwsServerControl::pauseReceiving(ConnectionId connectionId) -> bool
+{
+    auto connection = _connections->get(connectionId);
+    if (connection == nullptr)
+    {
+        return false;
+    }
+
+    if (connection->pauseReceiving(ReceivingPauseReason::User))
+    {
+        _notifier->notifyReceivingChanged(connection);
+    }
+    return true;
+}
+
+auto LwsServerControl::resumeReceiving(ConnectionId connectionId) -> bool
+{
+    auto connection = _connections->get(connectionId);
+    if (connection == nullptr)
+    {
+        return false;
+    }
+
+    if (connection->resumeReceiving(ReceivingPauseReason::User))
+    {
+        _notifier->notifyReceivingChanged(connection);
+    }
+    return true;
+}
+
+void LwsServerControl::closeConnection(ConnectionId connectionId)
 {
     if (auto connection = _connections->get(connectionId))
     {
-        connection->addTextDataToSend(message);
-        _notifier->notifyPendingDataAdded(connection);
+        _notifier->notifyCloseConnection(connection);
     }
 }
 
-void LwsServerControl::sendBinaryData(ConnectionId connectionId, const std::vector<char>& data)
+auto LwsServerControl::getCompressionStats(ConnectionId connectionId) -> CompressionStats
 {
     if (auto connection = _connections->get(connectionId))
     {
-        connection->addBinaryDataToSend(data);
-        _notifier->notifyPendingDataAdded(connection);
+        return connection->getCompressionStats();
     }
+    return CompressionStats{};
 }
 
-void LwsServerControl::sendTextData(const std::string& message)
+auto LwsServerControl::sendMessage_(ConnectionId connectionId, Message message) -> SendResult
 {
-    for(auto& entry : _connections->getAllConnections())
+    if (auto connection = _connections->get(connectionId))
     {
-        if (entry != nullptr)
-        {
-            entry->addTextDataToSend(message);
-        }
-        else
-        {
-            // TODO: log warning
-        }
+        const auto result = connection->addDataToSend(std::move(message));
+        onMessageQueued_(connection, result);
+        return result.sendResult;
     }
+    return SendResult::UnknownConnection;
+}
+
+void LwsServerControl::broadcastMessage_(Message message, ConnectionId excludedId)
+{
+    const auto connections = _connections->getAllConnections();
+    enqueueMessage_(message, *connections, excludedId);
     _notifier->notifyPendingDataAdded();
 }
 
-void LwsServerControl::sendBinaryData(const std::vector<char>& data)
+// The connections are resolved in a single pass and woken up all at once
+void LwsServerControl::multicastMessage_(const std::vector<ConnectionId>& connectionIds,
+                                         Message message)
+{
+    const auto connections = _connections->get(connectionIds);
+    if (connections.empty())
+    {
+        return;
+    }
+
+    enqueueMessage_(message, connections);
+    _notifier->notifyPendingDataAdded(connections);
+}
+
+// Only the subscribers of the topic are woken up, all of them at once
+void LwsServerControl::publishMessage_(const Topic& topic, Message message)
 {
-    for(auto& entry : _connections->getAllConnections())
+    const auto subscribers = _topics->getSubscribers(topic);
+    if (subscribers == nullptr)
+    {
+        return;
+    }
+
+    enqueueMessage_(message, *subscribers);
+    _notifier->notifyPendingDataAdded(*subscribers);
+}
+
+// The payload is serialized once and shared by all the connections
+void LwsServerControl::enqueueMessage_(const Message& message,
+                                       const std::vector<ILwsConnectionPtr>& connections,
+                                       ConnectionId excludedId)
+{
+    for(auto& entry : connections)
     {
         if (entry != nullptr)
         {
-            entry->addBinaryDataToSend(data);
+            if (entry->getConnectionId() == excludedId)
+            {
+                continue;
+            }
+
+            // NOTE: All the connections are serviced after the broadcast, including the ones
+            // to be closed or the ones which have reached the high watermark
+            entry->addDataToSend(message);
         }
         else
         {
             // TODO: log warning
         }
     }
-    _notifier->notifyPendingDataAdded();
 }
 
-void LwsServerControl::closeConnection(ConnectionId connectionId)
+void LwsServerControl::onMessageQueued_(const ILwsConnectionPtr& connection, EnqueueResult result)
 {
-    if (auto connection = _connections->get(connectionId))
+    // NOTE: The service thread closes the slow consumer, it does not wait for the writable
+    // callback which may never come. It reports the high watermark as well.
+    if (result.sendResult == SendResult::Queued || result.sendResult == SendResult::Disconnected ||
+        result.highWatermarkReached)
     {
-        _notifier->notifyCloseConnection(connection);
+        _notifier->notifyPendingDataAdded(connection);
     }
 }
 
@@ -24,8 +24,10 @@
 
 #pragma once
 
+#include "lwspp/server/Consts.hpp"
 #include "lwspp/server/IServerControl.hpp"
 
+#include "LwsAdapter/LwsTypes.hpp"
 #include "LwsAdapter/LwsTypesFwd.hpp"
 
 namespace lwspp
@@ -36,18 +38,75 @@ namespace srv
 class LwsServerControl : public IServerControl
 {
 public:
-    LwsServerControl(ILwsConnectionsPtr s, ILwsCallbackNotifierPtr n);
+    LwsServerControl(ILwsConnectionsPtr s, ILwsTopicsPtr t, ILwsCallbackNotifierPtr n);
 
-    void sendTextData(ConnectionId, const std::string&) override;
-    void sendBinaryData(ConnectionId, const std::vector<char>&) override;
+    auto sendTextData(ConnectionId, const std::string&) -> SendResult override;
+    auto sendBinaryData(ConnectionId, const std::vector<char>&) -> SendResult override;
 
     void sendTextData(const std::string&) override;
     void sendBinaryData(const std::vector<char>&) override;
 
+    auto sendTextData(ConnectionId, SendBuffer&&) -> SendResult override;
+    auto sendBinaryData(ConnectionId, SendBuffer&&) -> SendResult override;
+
+    void sendTextData(SendBuffer&&) override;
+    void sendBinaryData(SendBuffer&&) override;
+
+    auto sendTextData(ConnectionId, const std::string&, Priority) -> SendResult override;
+    auto sendBinaryData(ConnectionId, const std::vector<char>&, Priority) -> SendResult override;
+    auto sendTextData(ConnectionId, SendBuffer&&, Priority) -> SendResult override;
+    auto sendBinaryData(ConnectionId, SendBuffer&&, Priority) -> SendResult override;
+
+    auto sendBinaryStream(ConnectionId, contract::IStreamProducerPtr) -> SendResult override;
+
+    auto sendTextData(ConnectionId, const ConflationKey&, const std::string&)
+    -> SendResult override;
+    auto sendBinaryData(ConnectionId, const ConflationKey&, const std::vector<char>&)
+    -> SendResult override;
+    auto sendTextData(ConnectionId, const ConflationKey&, SendBuffer&&) -> SendResult override;
+    auto sendBinaryData(ConnectionId, const ConflationKey&, SendBuffer&&) -> SendResult override;
+
+    void sendTextData(const std::vector<ConnectionId>&, const std::string&) override;
+    void sendBinaryData(const std::vector<ConnectionId>&, const std::vector<char>&) override;
+    void sendTextData(const std::vector<ConnectionId>&, SendBuffer&&) override;
+    void sendBinaryData(const std::vector<ConnectionId>&, SendBuffer&&) override;
+
+    void sendTextDataExcept(ConnectionId, const std::string&) override;
+    void sendBinaryDataExcept(ConnectionId, const std::vector<char>&) override;
+    void sendTextDataExcept(ConnectionId, SendBuffer&&) override;
+    void sendBinaryDataExcept(ConnectionId, SendBuffer&&) override;
+
+    auto subscribe(ConnectionId, const Topic&) -> bool override;
+    void unsubscribe(ConnectionId, const Topic&) override;
+
+    void publishTextData(const Topic&, const std::string&) override;
+    void publishBinaryData(const Topic&, const std::vector<char>&) override;
+    void publishTextData(const Topic&, SendBuffer&&) override;
+    void publishBinaryData(const Topic&, SendBuffer&&) override;
+
+    auto resumeStream(ConnectionId) -> bool override;
+
+    auto pauseReceiving(ConnectionId) -> bool override;
+    auto resumeReceiving(ConnectionId) -> bool override;
+
     void closeConnection(ConnectionId) override;
+    auto getCompressionStats(ConnectionId) -> CompressionStats override;
+
+private:
+    auto sendMessage_(ConnectionId, Message) -> SendResult;
+    // Notifies the service thread and the server logic according to the result of queueing
+    void onMessageQueued_(const ILwsConnectionPtr&, EnqueueResult);
+    void broadcastMessage_(Message, ConnectionId excludedId = UNDEFINED_CONNECTION_ID);
+    void multicastMessage_(const std::vector<ConnectionId>&, Message);
+    void publishMessage_(const Topic&, Message);
+    // Queues the message to every connection but the excluded one, the payload is shared by
+    // the connections
+    void enqueueMessage_(const Message&, const std::vector<ILwsConnectionPtr>&,
+                         ConnectionId excludedId = UNDEFINED_CONNECTION_ID);
 
 private:
     ILwsConnectionsPtr _connections;
+    ILwsTopicsPtr _topics;
     ILwsCallbackNotifierPtr _notifier;
 };
 
@@ -0,0 +1,92 @@
+/*
+ * lwspp - C++ wrapper for the libwebsockets library
+ *
+ * Copyright (C) 2023 - 2023 Volodymyr Lotoshko <vlotoshko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+#include "LwsAdapter/LwsSocket.hpp"
+
+namespace lwspp
+{
+namespace srv
+{
+namespace
+{
+
+auto setOption(int socketFd, int level, int option, int value) -> bool
+{
+    return setsockopt(socketFd, level, option, &value, sizeof(value)) == 0;
+}
+
+// The zero size keeps the system default
+auto setBufferSizes(int socketFd, const SocketSettings& settings) -> bool
+{
+    bool result = true;
+    if (settings.sendBufferSize > 0)
+    {
+        result = setOption(socketFd, SOL_SOCKET, SO_SNDBUF, settings.sendBufferSize) && result;
+    }
+
+    if (settings.receiveBufferSize > 0)
+    {
+        result = setOption(socketFd, SOL_SOCKET, SO_RCVBUF, settings.receiveBufferSize) && result;
+    }
+    return result;
+}
+
+auto isListening(int socketFd) -> bool
+{
+    int value = 0;
+    socklen_t size = sizeof(value);
+    return getsockopt(socketFd, SOL_SOCKET, SO_ACCEPTCONN, &value, &size) == 0 && value != 0;
+}
+
+} // namespace
+
+auto setupConnectionSocket(int socketFd, const SocketSettings& settings) -> bool
+{
+    const bool result = setBufferSizes(socketFd, settings);
+    return setOption(socketFd, IPPROTO_TCP, TCP_NODELAY, settings.tcpNoDelay ? 1 : 0) && result;
+}
+
+auto setupListeningSocket(int socketFd, const SocketSettings& settings) -> bool
+{
+    if ((settings.sendBufferSize == 0 && settings.receiveBufferSize == 0 &&
+         settings.listenBacklog == 0) || !isListening(socketFd))
+    {
+        return true;
+    }
+
+    const bool result = setBufferSizes(socketFd, settings);
+    // NOTE: Calling listen on the listening socket updates its backlog
+    if (settings.listenBacklog > 0)
+    {
+        return listen(socketFd, settings.listenBacklog) == 0 && result;
+    }
+    return result;
+}
+
+} // namespace srv
+} // namespace lwspp
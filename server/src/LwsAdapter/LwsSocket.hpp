@@ -0,0 +1,44 @@
+/*
+ * lwspp - C++ wrapper for the libwebsockets library
+ *
+ * Copyright (C) 2023 - 2023 Volodymyr Lotoshko <vlotoshko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "LwsAdapter/LwsTypes.hpp"
+
+namespace lwspp
+{
+namespace srv
+{
+
+// Applies the settings to the accepted socket. Returns false if any option is rejected.
+auto setupConnectionSocket(int socketFd, const SocketSettings&) -> bool;
+
+// Applies the buffer sizes and the backlog if the socket is the listening one, the accepted
+// sockets inherit the buffer sizes from it. Returns false if any option is rejected.
+// NOTE: The listening socket is reached by the poll callbacks only, so the settings are not
+// applied to it by the libwebsockets built without LWS_WITH_EXTERNAL_POLL
+auto setupListeningSocket(int socketFd, const SocketSettings&) -> bool;
+
+} // namespace srv
+} // namespace lwspp
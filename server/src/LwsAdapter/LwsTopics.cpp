@@ -0,0 +1,141 @@
+/*
+ * lwspp - C++ wrapper for the libwebsockets library
+ *
+ * Copyright (C) 2023 - 2023 Volodymyr Lotoshko <vlotoshko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <vector>
+
+#include "LwsAdapter/ILwsConnections.hpp" // IWYU pragma: keep
+#include "LwsAdapter/LwsTopics.hpp"
+
+namespace lwspp
+{
+namespace srv
+{
+
+LwsTopics::LwsTopics(ILwsConnectionsPtr c)
+    : _connections(std::move(c))
+{}
+
+auto LwsTopics::subscribe(ConnectionId connectionId, const Topic& topic) -> bool
+{
+    const std::lock_guard<std::mutex> guard(_mutex);
+    // NOTE: The connection is looked up under the lock. The service thread removes the closed
+    // connection from the connections before its subscriptions, so either the connection is not
+    // found here or its subscriptions are removed after this one is added.
+    auto connection = _connections->get(connectionId);
+    if (connection == nullptr)
+    {
+        return false;
+    }
+
+    auto& entry = _topics[topic];
+    if (entry.subscribers.emplace(connectionId, std::move(connection)).second)
+    {
+        entry.snapshot.reset();
+        _connectionTopics[connectionId].insert(topic);
+    }
+    return true;
+}
+
+void LwsTopics::unsubscribe(ConnectionId connectionId, const Topic& topic)
+{
+    const std::lock_guard<std::mutex> guard(_mutex);
+    unsubscribe_(connectionId, topic);
+
+    auto found = _connectionTopics.find(connectionId);
+    if (found != _connectionTopics.end())
+    {
+        found->second.erase(topic);
+        if (found->second.empty())
+        {
+            _connectionTopics.erase(found);
+        }
+    }
+}
+
+void LwsTopics::removeConnection(ConnectionId connectionId)
+{
+    const std::lock_guard<std::mutex> guard(_mutex);
+    auto found = _connectionTopics.find(connectionId);
+    if (found == _connectionTopics.end())
+    {
+        return;
+    }
+
+    for (const auto& topic : found->second)
+    {
+        unsubscribe_(connectionId, topic);
+    }
+    _connectionTopics.erase(found);
+}
+
+auto LwsTopics::getSubscribers(const Topic& topic) -> ConnectionsSnapshotPtr
+{
+    const std::lock_guard<std::mutex> guard(_mutex);
+    auto found = _topics.find(topic);
+    if (found == _topics.end())
+    {
+        return ConnectionsSnapshotPtr{};
+    }
+
+    auto& entry = found->second;
+    if (entry.snapshot == nullptr)
+    {
+        auto snapshot = std::make_shared<std::vector<ILwsConnectionPtr>>();
+        snapshot->reserve(entry.subscribers.size());
+        for (auto& subscriber : entry.subscribers)
+        {
+            snapshot->push_back(subscriber.second);
+        }
+        entry.snapshot = std::move(snapshot);
+    }
+    return entry.snapshot;
+}
+
+// The topic without the subscribers is removed
+void LwsTopics::unsubscribe_(ConnectionId connectionId, const Topic& topic)
+{
+    auto found = _topics.find(topic);
+    if (found == _topics.end())
+    {
+        return;
+    }
+
+    auto& entry = found->second;
+    if (entry.subscribers.erase(connectionId) == 0)
+    {
+        return;
+    }
+
+    if (entry.subscribers.empty())
+    {
+        _topics.erase(found);
+    }
+    else
+    {
+        entry.snapshot.reset();
+    }
+}
+
+} // namespace srv
+} // namespace lwspp
@@ -0,0 +1,72 @@
+/*
+ * lwspp - C++ wrapper for the libwebsockets library
+ *
+ * Copyright (C) 2023 - 2023 Volodymyr Lotoshko <vlotoshko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+
+#include "LwsAdapter/ILwsTopics.hpp"
+
+namespace lwspp
+{
+namespace srv
+{
+
+/**
+ * @brief The LwsTopics class keeps the subscribers of every topic along with their snapshot,
+ * which is rebuilt on the first publish after the subscribers have changed. So the publish
+ * takes the lock only to copy the snapshot pointer, and looks up none of the subscribers.
+ */
+class LwsTopics : public ILwsTopics
+{
+public:
+    explicit LwsTopics(ILwsConnectionsPtr);
+
+    auto subscribe(ConnectionId, const Topic&) -> bool override;
+    void unsubscribe(ConnectionId, const Topic&) override;
+    void removeConnection(ConnectionId) override;
+    auto getSubscribers(const Topic&) -> ConnectionsSnapshotPtr override;
+
+private:
+    struct TopicEntry
+    {
+        std::map<ConnectionId, ILwsConnectionPtr> subscribers;
+        ConnectionsSnapshotPtr snapshot;
+    };
+
+    void unsubscribe_(ConnectionId, const Topic&);
+
+private:
+    ILwsConnectionsPtr _connections;
+    std::unordered_map<Topic, TopicEntry> _topics;
+    // The topics of every connection, to clean them up when the connection is closed
+    std::unordered_map<ConnectionId, std::set<Topic>> _connectionTopics;
+    std::mutex _mutex;
+};
+
+} // namespace srv
+} // namespace lwspp
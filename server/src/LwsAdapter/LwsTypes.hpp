@@ -25,20 +25,102 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 #include <string>
 
+#include "lwspp/server/Types.hpp"
+#include "lwspp/server/TypesFwd.hpp"
+
 namespace lwspp
 {
 namespace srv
 {
 
+// Limits the data written to the connection on a single writable event
+struct WriteBudget
+{
+    unsigned int maxMessages = 0;
+    size_t maxBytes = 0;
+    // The larger messages are written as fragments of this size, every fragment counts as
+    // the message. The zero value disables the fragmentation.
+    size_t maxFragmentSize = 0;
+};
+
+// Limits the data queued to the connection, the zero limit means no limit
+struct QueueLimits
+{
+    size_t maxMessages = 0;
+    size_t maxBytes = 0;
+    SlowConsumerPolicy policy = SlowConsumerPolicy::Reject;
+};
+
+struct EnqueueResult
+{
+    SendResult sendResult;
+    // The queue has reached its limits for the first time since it was drained
+    bool highWatermarkReached;
+};
+
+enum class CloseReason : uint8_t
+{
+    None,
+    GoingAway,
+    SlowConsumer
+};
+
+// The reading from the connection is paused while any of the reasons holds, so every party
+// resumes only its own pause
+enum class ReceivingPauseReason : uint8_t
+{
+    // The server logic asked for it, see IServerControl::pauseReceiving
+    User = 0x01,
+    // The events of the connection wait for the logic threads, see LwsLogicDispatcher
+    LogicDispatcher = 0x02
+};
+
+// The options of the sockets, the zero value keeps the system default
+struct SocketSettings
+{
+    int sendBufferSize = 0;
+    int receiveBufferSize = 0;
+    bool tcpNoDelay = true;
+    int listenBacklog = 0;
+};
+
 enum class DataType : uint8_t
 {
     Text,
     Binary
 };
 
-using Message = std::pair<DataType, std::string>;
+class Payload;
+using PayloadPtr = std::shared_ptr<Payload>;
+
+struct Message
+{
+    DataType dataType;
+    PayloadPtr payload;
+    // The message of the non-empty key takes the latest payload of the key when it is written,
+    // see ILwsConnection::frontPendingData
+    ConflationKey conflationKey{};
+    Priority priority{Priority::Bulk};
+    // The streamed message pulls the data from the producer, the payload is the chunk buffer
+    // reused for every chunk
+    contract::IStreamProducerPtr producer{};
+    bool isStreamStarted{false};
+    // The fragmented message keeps the size of the data written so far
+    size_t writtenSize{0};
+};
+
+class ILwsConnection;
+
+// The per session data allocated by the libwebsockets alongside the wsi. The connection is owned
+// by the connections registry until the session is closed.
+struct LwsSession
+{
+    ConnectionId connectionId;
+    ILwsConnection* connection;
+};
 
 } // namespace srv
 } // namespace lwspp
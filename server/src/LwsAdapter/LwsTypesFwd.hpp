@@ -44,6 +44,16 @@ using ILwsConnectionPtr = std::shared_ptr<ILwsConnection>;
 
 class ILwsConnections;
 using ILwsConnectionsPtr = std::shared_ptr<ILwsConnections>;
+using ConnectionsSnapshotPtr = std::shared_ptr<const std::vector<ILwsConnectionPtr>>;
+
+class ILwsTopics;
+using ILwsTopicsPtr = std::shared_ptr<ILwsTopics>;
+
+class ILwsPendingWrites;
+using ILwsPendingWritesPtr = std::shared_ptr<ILwsPendingWrites>;
+
+class LwsLogicDispatcher;
+using LwsLogicDispatcherPtr = std::shared_ptr<LwsLogicDispatcher>;
 
 using LwsInstanceRawPtr = lws*;
 
@@ -55,6 +65,7 @@ using LowLevelContextPtr = std::shared_ptr<lws_context>;
 using LowLevelContextWeak = std::weak_ptr<lws_context>;
 
 using LwsProtocols = std::vector<lws_protocols>;
+using LwsExtensions = std::vector<lws_extension>;
 using LwsCallback = lws_callback_function;
 
 } // namespace srv
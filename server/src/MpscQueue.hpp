@@ -0,0 +1,236 @@
+/*
+ * lwspp - C++ wrapper for the libwebsockets library
+ *
+ * Copyright (C) 2023 - 2023 Volodymyr Lotoshko <vlotoshko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace lwspp
+{
+namespace srv
+{
+
+/**
+ * @brief The MpscQueue class is an unbounded lock-free multi-producer single-consumer queue.
+ * Any thread can push the values, only one thread at a time can access the front and pop.
+ * @note It is the intrusive queue by Dmitry Vyukov: push is wait-free, the consumer can
+ * temporarily see the queue as empty while a concurrent push is not completed yet. The producer
+ * should notify the consumer after the push returns.
+ * The consumer returns the released nodes to the bounded pool, from which the producers take them
+ * back, so the push allocates only if the pool is empty and the pop frees only if it is full.
+ */
+template <typename T>
+class MpscQueue
+{
+public:
+    MpscQueue()
+        : _head(&_stub)
+        , _padding()
+        , _tail(&_stub)
+    {}
+
+    ~MpscQueue()
+    {
+        while (front() != nullptr)
+        {
+            pop();
+        }
+        if (_tail != &_stub)
+        {
+            delete _tail;
+        }
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    auto operator=(const MpscQueue&) -> MpscQueue& = delete;
+
+    MpscQueue(MpscQueue&&) = delete;
+    auto operator=(MpscQueue&&) -> MpscQueue& = delete;
+
+public:
+    // Can be called from any thread
+    void push(T value)
+    {
+        Node* node = _pool.take();
+        if (node == nullptr)
+        {
+            node = new Node{};
+        }
+        else
+        {
+            node->next.store(nullptr, std::memory_order_relaxed);
+        }
+        new (&node->storage) T(std::move(value));
+
+        Node* previous = _head.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+    }
+
+    // Consumer only. Returns nullptr if the queue is empty
+    auto front() -> T*
+    {
+        Node* next = _tail->next.load(std::memory_order_acquire);
+        return next != nullptr ? next->value() : nullptr;
+    }
+
+    // Consumer only. Removes the front value, the queue must not be empty
+    void pop()
+    {
+        Node* next = _tail->next.load(std::memory_order_acquire);
+        next->value()->~T();
+
+        // The popped node becomes the new stub, the previous one is released
+        if (_tail != &_stub && !_pool.put(_tail))
+        {
+            delete _tail;
+        }
+        _tail = next;
+    }
+
+    // Consumer only
+    auto empty() -> bool
+    {
+        return front() == nullptr;
+    }
+
+private:
+    struct Node
+    {
+        std::atomic<Node*> next{nullptr};
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+
+        auto value() -> T*
+        {
+            return reinterpret_cast<T*>(&storage);
+        }
+    };
+
+    // Keeps the producers side and the consumer side in the different cache lines
+    static const size_t CACHE_LINE_SIZE = 64;
+
+    /**
+     * @brief The NodePool class is the bounded lock-free queue of the released nodes by Dmitry
+     * Vyukov. The consumer of the MpscQueue is its only producer, the producers of the MpscQueue
+     * are its consumers. The sequence of every cell excludes the ABA problem of the free list.
+     */
+    class NodePool
+    {
+    public:
+        NodePool()
+            : _takePosition(0)
+            , _padding()
+            , _putPosition(0)
+        {
+            for (size_t i = 0; i < CAPACITY; ++i)
+            {
+                _cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        ~NodePool()
+        {
+            for (Node* node = take(); node != nullptr; node = take())
+            {
+                delete node;
+            }
+        }
+
+        NodePool(const NodePool&) = delete;
+        auto operator=(const NodePool&) -> NodePool& = delete;
+
+        NodePool(NodePool&&) = delete;
+        auto operator=(NodePool&&) -> NodePool& = delete;
+
+        // Can be called from any thread. Returns nullptr if the pool is empty
+        auto take() -> Node*
+        {
+            size_t position = _takePosition.load(std::memory_order_relaxed);
+            while (true)
+            {
+                Cell& cell = _cells[position & (CAPACITY - 1)];
+                const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+                if (sequence == position + 1)
+                {
+                    if (_takePosition.compare_exchange_weak(
+                            position, position + 1, std::memory_order_relaxed))
+                    {
+                        Node* node = cell.node;
+                        cell.sequence.store(position + CAPACITY, std::memory_order_release);
+                        return node;
+                    }
+                }
+                else if (sequence == position)
+                {
+                    return nullptr;
+                }
+                else
+                {
+                    position = _takePosition.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        // Consumer only. Returns false if the pool is full
+        auto put(Node* node) -> bool
+        {
+            Cell& cell = _cells[_putPosition & (CAPACITY - 1)];
+            if (cell.sequence.load(std::memory_order_acquire) != _putPosition)
+            {
+                return false;
+            }
+            cell.node = node;
+            cell.sequence.store(_putPosition + 1, std::memory_order_release);
+            ++_putPosition;
+            return true;
+        }
+
+    private:
+        struct Cell
+        {
+            std::atomic<size_t> sequence{0};
+            Node* node = nullptr;
+        };
+
+        // Must be a power of two
+        static const size_t CAPACITY = 64;
+
+        std::atomic<size_t> _takePosition;
+        char _padding[CACHE_LINE_SIZE - sizeof(std::atomic<size_t>)];
+        size_t _putPosition;
+        Cell _cells[CAPACITY];
+    };
+
+    std::atomic<Node*> _head;
+    char _padding[CACHE_LINE_SIZE - sizeof(std::atomic<Node*>)];
+    Node* _tail;
+    Node _stub;
+    NodePool _pool;
+};
+
+} // namespace srv
+} // namespace lwspp
@@ -24,6 +24,7 @@
 
 #include "LwsAdapter/LwsServer.hpp"
 #include "Server.hpp"
+#include "ServerContext.hpp"
 
 namespace lwspp
 {
@@ -33,6 +34,13 @@ namespace srv
 Server::Server(const ServerContext& context)
     : _lwsServer(std::make_shared<LwsServer>(context))
 {
+    // The external event loop services the server on its thread, there is nothing to wait for
+    if (context.eventLoop != nullptr)
+    {
+        _lwsServer->startListening();
+        return;
+    }
+
     const std::weak_ptr<LwsServer> weakLwsServer = _lwsServer;
 
     auto asyncStartListening = [weakLwsServer]
@@ -49,7 +57,20 @@ Server::Server(const ServerContext& context)
 Server::~Server()
 {
     _lwsServer->stopListening();
-    _serverStop.wait();
+    if (_serverStop.valid())
+    {
+        _serverStop.wait();
+    }
+}
+
+void Server::serviceFd(int fd, short revents)
+{
+    _lwsServer->serviceFd(fd, revents);
+}
+
+auto Server::service() -> int
+{
+    return _lwsServer->service();
 }
 
 } // namespace srv
@@ -38,7 +38,8 @@ namespace srv
  * @brief The Server class wraps the internal LwsServer implementation.
  *
  * The server starts listening upon construction and stops listening upon destruction.
- * It operates within a separate thread to handle incoming connections.
+ * It operates within a separate thread to handle incoming connections, unless it is serviced by
+ * the external event loop.
  */
 class Server : public IServer
 {
@@ -52,6 +53,9 @@ public:
     Server(const Server&) = delete;
     auto operator=(const Server&) -> Server& = delete;
 
+    void serviceFd(int fd, short revents) override;
+    auto service() -> int override;
+
 private:
     LwsServerPtr _lwsServer;
     std::future<void> _serverStop;
@@ -26,6 +26,7 @@
 
 #include "Server.hpp"
 #include "ServerContext.hpp"
+#include "CompressionSettings.hpp"
 #include "SslSettings.hpp" // IWYU pragma: keep
 #include "lwspp/server/ServerBuilder.hpp"
 
@@ -44,6 +45,14 @@ public:
     {}
 };
 
+class InvalidParameterException : public std::runtime_error
+{
+public:
+    explicit InvalidParameterException(const std::string& parameter)
+        : std::runtime_error("Invalid parameter value: " + parameter)
+    {}
+};
+
 void checkContext(const ServerContext& context)
 {
     if (context.callbackVersion == UNDEFINED_CALLBACK_VERSION)
@@ -85,6 +94,78 @@ void checkContext(const ServerContext& context)
             throw UndefinedRequiredParameterException{"keep alive probes interval"};
         }
     }
+
+    if (context.serviceThreads == 0)
+    {
+        throw InvalidParameterException{"service threads"};
+    }
+
+    // The external event loop services the only thread service index
+    if (context.eventLoop != nullptr && context.serviceThreads != 1)
+    {
+        throw InvalidParameterException{"service threads"};
+    }
+
+    if (context.maxQueuedLogicEvents == 0)
+    {
+        throw InvalidParameterException{"max queued logic events"};
+    }
+
+    if (context.maxMessagesPerWrite == 0)
+    {
+        throw InvalidParameterException{"max messages per write"};
+    }
+
+    if (context.maxBytesPerWrite == 0)
+    {
+        throw InvalidParameterException{"max bytes per write"};
+    }
+
+    if (context.streamChunkSize == 0)
+    {
+        throw InvalidParameterException{"stream chunk size"};
+    }
+
+    if (context.maxMessageSize == 0)
+    {
+        throw InvalidParameterException{"max message size"};
+    }
+
+    if (context.compression != nullptr)
+    {
+        if (context.compression->compressionLevel < MIN_COMPRESSION_LEVEL ||
+            context.compression->compressionLevel > MAX_COMPRESSION_LEVEL)
+        {
+            throw InvalidParameterException{"compression level"};
+        }
+
+        if (context.compression->windowBits < MIN_COMPRESSION_WINDOW_BITS ||
+            context.compression->windowBits > MAX_COMPRESSION_WINDOW_BITS)
+        {
+            throw InvalidParameterException{"compression window bits"};
+        }
+
+        if (context.compression->memoryLevel < MIN_COMPRESSION_MEMORY_LEVEL ||
+            context.compression->memoryLevel > MAX_COMPRESSION_MEMORY_LEVEL)
+        {
+            throw InvalidParameterException{"compression memory level"};
+        }
+    }
+
+    if (context.socketSendBufferSize < 0)
+    {
+        throw InvalidParameterException{"socket send buffer size"};
+    }
+
+    if (context.socketReceiveBufferSize < 0)
+    {
+        throw InvalidParameterException{"socket receive buffer size"};
+    }
+
+    if (context.listenBacklog < 0)
+    {
+        throw InvalidParameterException{"listen backlog"};
+    }
 }
 
 } // namespace
@@ -169,6 +250,120 @@ auto ServerBuilder::setLwsLogLevel(int logLevel) -> ServerBuilder&
     return *this;
 }
 
+auto ServerBuilder::setServiceThreads(unsigned int threads) -> ServerBuilder&
+{
+    _context->serviceThreads = threads;
+    return *this;
+}
+
+auto ServerBuilder::setEventLoop(contract::IEventLoopPtr eventLoop) -> ServerBuilder&
+{
+    _context->eventLoop = std::move(eventLoop);
+    return *this;
+}
+
+auto ServerBuilder::setLogicThreads(unsigned int threads) -> ServerBuilder&
+{
+    _context->logicThreads = threads;
+    return *this;
+}
+
+auto ServerBuilder::setMaxQueuedLogicEvents(size_t maxEvents) -> ServerBuilder&
+{
+    _context->maxQueuedLogicEvents = maxEvents;
+    return *this;
+}
+
+auto ServerBuilder::setMaxMessagesPerWrite(unsigned int maxMessages) -> ServerBuilder&
+{
+    _context->maxMessagesPerWrite = maxMessages;
+    return *this;
+}
+
+auto ServerBuilder::setMaxBytesPerWrite(size_t maxBytes) -> ServerBuilder&
+{
+    _context->maxBytesPerWrite = maxBytes;
+    return *this;
+}
+
+auto ServerBuilder::setMaxFragmentSize(size_t maxFragmentSize) -> ServerBuilder&
+{
+    _context->maxFragmentSize = maxFragmentSize;
+    return *this;
+}
+
+auto ServerBuilder::setMaxQueuedMessages(size_t maxMessages) -> ServerBuilder&
+{
+    _context->maxQueuedMessages = maxMessages;
+    return *this;
+}
+
+auto ServerBuilder::setMaxQueuedBytes(size_t maxBytes) -> ServerBuilder&
+{
+    _context->maxQueuedBytes = maxBytes;
+    return *this;
+}
+
+auto ServerBuilder::setSlowConsumerPolicy(SlowConsumerPolicy policy) -> ServerBuilder&
+{
+    _context->slowConsumerPolicy = policy;
+    return *this;
+}
+
+auto ServerBuilder::setStreamChunkSize(size_t chunkSize) -> ServerBuilder&
+{
+    _context->streamChunkSize = chunkSize;
+    return *this;
+}
+
+auto ServerBuilder::setMaxMessageSize(size_t maxSize) -> ServerBuilder&
+{
+    _context->maxMessageSize = maxSize;
+    return *this;
+}
+
+auto ServerBuilder::setCompression(CompressionSettingsPtr compression) -> ServerBuilder&
+{
+    _context->compression = std::move(compression);
+    return *this;
+}
+
+auto ServerBuilder::setRxBufferSize(size_t size) -> ServerBuilder&
+{
+    _context->rxBufferSize = size;
+    return *this;
+}
+
+auto ServerBuilder::setTxPacketSize(size_t size) -> ServerBuilder&
+{
+    _context->txPacketSize = size;
+    return *this;
+}
+
+auto ServerBuilder::setSocketSendBufferSize(int size) -> ServerBuilder&
+{
+    _context->socketSendBufferSize = size;
+    return *this;
+}
+
+auto ServerBuilder::setSocketReceiveBufferSize(int size) -> ServerBuilder&
+{
+    _context->socketReceiveBufferSize = size;
+    return *this;
+}
+
+auto ServerBuilder::setTcpNoDelay(bool noDelay) -> ServerBuilder&
+{
+    _context->tcpNoDelay = noDelay;
+    return *this;
+}
+
+auto ServerBuilder::setListenBacklog(int backlog) -> ServerBuilder&
+{
+    _context->listenBacklog = backlog;
+    return *this;
+}
+
 auto ServerBuilder::setKeepAliveTimeout(int timeout) -> ServerBuilder&
 {
     _context->keepAliveTimeout = timeout;
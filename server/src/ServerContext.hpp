@@ -54,7 +54,26 @@ public:
     std::string vhostName = UNDEFINED_NAME;
     std::string serverString = UNDEFINED_NAME;
     int lwsLogLevel = DEFAULT_LWS_LOG_LEVEL;
+    unsigned int serviceThreads = DEFAULT_SERVICE_THREADS;
+    contract::IEventLoopPtr eventLoop;
+    unsigned int logicThreads = DEFAULT_LOGIC_THREADS;
+    size_t maxQueuedLogicEvents = DEFAULT_MAX_QUEUED_LOGIC_EVENTS;
+    unsigned int maxMessagesPerWrite = DEFAULT_MAX_MESSAGES_PER_WRITE;
+    size_t maxBytesPerWrite = DEFAULT_MAX_BYTES_PER_WRITE;
+    size_t maxFragmentSize = DEFAULT_MAX_FRAGMENT_SIZE;
+    size_t maxQueuedMessages = UNDEFINED_UNSET;
+    size_t maxQueuedBytes = UNDEFINED_UNSET;
+    SlowConsumerPolicy slowConsumerPolicy = DEFAULT_SLOW_CONSUMER_POLICY;
+    size_t streamChunkSize = DEFAULT_STREAM_CHUNK_SIZE;
+    size_t maxMessageSize = DEFAULT_MAX_MESSAGE_SIZE;
+    size_t rxBufferSize = UNDEFINED_UNSET;
+    size_t txPacketSize = UNDEFINED_UNSET;
+    int socketSendBufferSize = UNDEFINED_UNSET;
+    int socketReceiveBufferSize = UNDEFINED_UNSET;
+    bool tcpNoDelay = DEFAULT_TCP_NO_DELAY;
+    int listenBacklog = UNDEFINED_UNSET;
     SslSettingsPtr ssl;
+    CompressionSettingsPtr compression;
 };
 
 } // namespace srv
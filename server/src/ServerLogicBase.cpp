@@ -50,6 +50,9 @@ void ServerLogicBase::onError(ConnectionId, const std::string& /*errorMessage*/)
 void ServerLogicBase::onWarning(ConnectionId, const std::string& /*warningMessage*/) noexcept
 {}
 
+void ServerLogicBase::onWatermark(ConnectionId, Watermark) noexcept
+{}
+
 void ServerLogicBase::acceptServerControl(IServerControlPtr c) noexcept
 {
     _serverControl = std::move(c);
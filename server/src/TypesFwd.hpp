@@ -39,5 +39,16 @@ using LwsServerPtr = std::shared_ptr<LwsServer>;
 class SslSettings;
 using SslSettingsPtr = std::shared_ptr<SslSettings>;
 
+class CompressionSettings;
+using CompressionSettingsPtr = std::shared_ptr<CompressionSettings>;
+
+namespace contract
+{
+
+class IServerLogic;
+using IServerLogicWeak = std::weak_ptr<IServerLogic>;
+
+} // namespace contract
+
 } // namespace srv
 } // namespace lwspp
@@ -26,10 +26,13 @@
 #include <catch2/matchers/catch_matchers_all.hpp>
 
 #include "ServerContext.hpp"
+#include "CompressionSettings.hpp"
 #include "SslSettings.hpp"
+#include "lwspp/server/CompressionSettingsBuilder.hpp"
 #include "lwspp/server/ServerBuilder.hpp"
 #include "lwspp/server/ServerLogicBase.hpp"
 #include "lwspp/server/SslSettingsBuilder.hpp"
+#include "lwspp/server/contract/IEventLoop.hpp"
 
 namespace lwspp
 {
@@ -82,6 +85,34 @@ const int KEEPALIVE_PROBES = 5;
 const int KEEPALIVE_PROBES_INTERVAL = 10;
 const int LWS_LOG_LEVEL = 9;
 const int LWS_LOG_LEVEL_DISABLE = 0;
+const unsigned int MAX_MESSAGES_PER_WRITE = 8;
+const size_t MAX_BYTES_PER_WRITE = 4096;
+const size_t MAX_FRAGMENT_SIZE = 1024;
+const size_t MAX_QUEUED_MESSAGES = 1000;
+const size_t MAX_QUEUED_BYTES = 1024 * 1024;
+const size_t STREAM_CHUNK_SIZE = 16 * 1024;
+const size_t MAX_MESSAGE_SIZE = 1024 * 1024;
+const int COMPRESSION_LEVEL = 6;
+const int COMPRESSION_WINDOW_BITS = 12;
+const int COMPRESSION_MEMORY_LEVEL = 4;
+const int COMPRESSION_INVALID_WINDOW_BITS = 8;
+const unsigned int SERVICE_THREADS = 4;
+const unsigned int LOGIC_THREADS = 8;
+const size_t MAX_QUEUED_LOGIC_EVENTS = 256;
+const size_t RX_BUFFER_SIZE = 8192;
+const size_t TX_PACKET_SIZE = 16384;
+const int SOCKET_SEND_BUFFER_SIZE = 262144;
+const int SOCKET_RECEIVE_BUFFER_SIZE = 131072;
+const int LISTEN_BACKLOG = 1024;
+const int INVALID_SOCKET_BUFFER_SIZE = -1;
+
+class EventLoop : public contract::IEventLoop
+{
+public:
+    void watchFd(int, short) noexcept override {}
+    void unwatchFd(int) noexcept override {}
+    void wakeUp() noexcept override {}
+};
 
 auto toString(CallbackVersion version) -> std::string
 {
@@ -89,6 +120,8 @@ auto toString(CallbackVersion version) -> std::string
     {
     case CallbackVersion::v1_Andromeda:
         return "v1_Andromeda";
+    case CallbackVersion::v2_BlackHole:
+        return "v2_BlackHole";
     default:
         return "Undefined";
     }
@@ -109,6 +142,34 @@ void compareServerContexts(const ServerContext& actual, const ServerContext& exp
     REQUIRE(actual.vhostName == expected.vhostName);
     REQUIRE(actual.serverString == expected.serverString);
     REQUIRE(actual.lwsLogLevel == expected.lwsLogLevel);
+    REQUIRE(actual.maxMessagesPerWrite == expected.maxMessagesPerWrite);
+    REQUIRE(actual.maxBytesPerWrite == expected.maxBytesPerWrite);
+    REQUIRE(actual.maxFragmentSize == expected.maxFragmentSize);
+    REQUIRE(actual.maxQueuedMessages == expected.maxQueuedMessages);
+    REQUIRE(actual.maxQueuedBytes == expected.maxQueuedBytes);
+    REQUIRE(actual.slowConsumerPolicy == expected.slowConsumerPolicy);
+    REQUIRE(actual.streamChunkSize == expected.streamChunkSize);
+    REQUIRE(actual.maxMessageSize == expected.maxMessageSize);
+    REQUIRE(((actual.compression != nullptr && expected.compression != nullptr) ||
+             (actual.compression == nullptr && expected.compression == nullptr)));
+
+    if (actual.compression != nullptr && expected.compression != nullptr)
+    {
+        REQUIRE(actual.compression->compressionLevel == expected.compression->compressionLevel);
+        REQUIRE(actual.compression->windowBits == expected.compression->windowBits);
+        REQUIRE(actual.compression->memoryLevel == expected.compression->memoryLevel);
+        REQUIRE(actual.compression->noContextTakeover == expected.compression->noContextTakeover);
+    }
+    REQUIRE(actual.serviceThreads == expected.serviceThreads);
+    REQUIRE(actual.eventLoop == expected.eventLoop);
+    REQUIRE(actual.logicThreads == expected.logicThreads);
+    REQUIRE(actual.maxQueuedLogicEvents == expected.maxQueuedLogicEvents);
+    REQUIRE(actual.rxBufferSize == expected.rxBufferSize);
+    REQUIRE(actual.txPacketSize == expected.txPacketSize);
+    REQUIRE(actual.socketSendBufferSize == expected.socketSendBufferSize);
+    REQUIRE(actual.socketReceiveBufferSize == expected.socketReceiveBufferSize);
+    REQUIRE(actual.tcpNoDelay == expected.tcpNoDelay);
+    REQUIRE(actual.listenBacklog == expected.listenBacklog);
     REQUIRE(((actual.ssl != nullptr && expected.ssl != nullptr) ||
              (actual.ssl == nullptr && expected.ssl == nullptr)));
 
@@ -135,6 +196,7 @@ SCENARIO( "ServerContext setup", "[server_builder]" )
         WHEN( "All parameters are set" )
         {
             auto handler = std::make_shared<ServerLogicBase>();
+            auto eventLoop = std::make_shared<EventLoop>();
             auto sslSettings = SslSettingsBuilder{}
                                    .setPrivateKeyFilepath(SERVER_KEY_PATH)
                                    .setCertFilepath(SERVER_CERT_PATH)
@@ -144,6 +206,12 @@ SCENARIO( "ServerContext setup", "[server_builder]" )
                                    .setCiphersListTls13(CIPHER_LIST_TLS_13)
                                    .requireValidClientCert()
                                    .build();
+            auto compressionSettings = CompressionSettingsBuilder{}
+                                           .setCompressionLevel(COMPRESSION_LEVEL)
+                                           .setWindowBits(COMPRESSION_WINDOW_BITS)
+                                           .setMemoryLevel(COMPRESSION_MEMORY_LEVEL)
+                                           .disableContextTakeover()
+                                           .build();
 
             serverBuilder
                 .setCallbackVersion(CallbackVersion::v1_Andromeda)
@@ -157,7 +225,26 @@ SCENARIO( "ServerContext setup", "[server_builder]" )
                 .setVhostName(VHOST_NAME)
                 .setServerString(SERVER_STRING)
                 .setLwsLogLevel(LWS_LOG_LEVEL)
-                .setSslSettings(sslSettings);
+                .setMaxMessagesPerWrite(MAX_MESSAGES_PER_WRITE)
+                .setMaxBytesPerWrite(MAX_BYTES_PER_WRITE)
+                .setMaxFragmentSize(MAX_FRAGMENT_SIZE)
+                .setMaxQueuedMessages(MAX_QUEUED_MESSAGES)
+                .setMaxQueuedBytes(MAX_QUEUED_BYTES)
+                .setSlowConsumerPolicy(SlowConsumerPolicy::DropOldest)
+                .setStreamChunkSize(STREAM_CHUNK_SIZE)
+                .setMaxMessageSize(MAX_MESSAGE_SIZE)
+                .setServiceThreads(SERVICE_THREADS)
+                .setEventLoop(eventLoop)
+                .setLogicThreads(LOGIC_THREADS)
+                .setMaxQueuedLogicEvents(MAX_QUEUED_LOGIC_EVENTS)
+                .setRxBufferSize(RX_BUFFER_SIZE)
+                .setTxPacketSize(TX_PACKET_SIZE)
+                .setSocketSendBufferSize(SOCKET_SEND_BUFFER_SIZE)
+                .setSocketReceiveBufferSize(SOCKET_RECEIVE_BUFFER_SIZE)
+                .setTcpNoDelay(false)
+                .setListenBacklog(LISTEN_BACKLOG)
+                .setSslSettings(sslSettings)
+                .setCompression(compressionSettings);
 
             const ServerContext& actual = TestServerBuilder{serverBuilder}.getServerContext();
 
@@ -182,6 +269,29 @@ SCENARIO( "ServerContext setup", "[server_builder]" )
                 expected.vhostName = VHOST_NAME;
                 expected.serverString = SERVER_STRING;
                 expected.lwsLogLevel = LWS_LOG_LEVEL;
+                expected.maxMessagesPerWrite = MAX_MESSAGES_PER_WRITE;
+                expected.maxBytesPerWrite = MAX_BYTES_PER_WRITE;
+                expected.maxFragmentSize = MAX_FRAGMENT_SIZE;
+                expected.maxQueuedMessages = MAX_QUEUED_MESSAGES;
+                expected.maxQueuedBytes = MAX_QUEUED_BYTES;
+                expected.slowConsumerPolicy = SlowConsumerPolicy::DropOldest;
+                expected.streamChunkSize = STREAM_CHUNK_SIZE;
+                expected.maxMessageSize = MAX_MESSAGE_SIZE;
+                expected.compression = std::make_shared<CompressionSettings>();
+                expected.compression->compressionLevel = COMPRESSION_LEVEL;
+                expected.compression->windowBits = COMPRESSION_WINDOW_BITS;
+                expected.compression->memoryLevel = COMPRESSION_MEMORY_LEVEL;
+                expected.compression->noContextTakeover = true;
+                expected.serviceThreads = SERVICE_THREADS;
+                expected.eventLoop = eventLoop;
+                expected.logicThreads = LOGIC_THREADS;
+                expected.maxQueuedLogicEvents = MAX_QUEUED_LOGIC_EVENTS;
+                expected.rxBufferSize = RX_BUFFER_SIZE;
+                expected.txPacketSize = TX_PACKET_SIZE;
+                expected.socketSendBufferSize = SOCKET_SEND_BUFFER_SIZE;
+                expected.socketReceiveBufferSize = SOCKET_RECEIVE_BUFFER_SIZE;
+                expected.tcpNoDelay = false;
+                expected.listenBacklog = LISTEN_BACKLOG;
 
                 compareServerContexts(actual, expected);
             }
@@ -310,6 +420,108 @@ SCENARIO( "Server construction", "[server_builder]" )
                                         "Required parameter is undefined: keep alive probes interval");
                 }
             }
+
+            AND_WHEN( "Service threads number is zero" )
+            {
+                serverBuilder.setServiceThreads(0);
+
+                THEN( "Exception is thrown on server build" )
+                {
+                    REQUIRE_THROWS_WITH(serverBuilder.build(),
+                                        "Invalid parameter value: service threads");
+                }
+            }
+
+            AND_WHEN( "Event loop is set with several service threads" )
+            {
+                serverBuilder.setEventLoop(std::make_shared<EventLoop>());
+                serverBuilder.setServiceThreads(SERVICE_THREADS);
+
+                THEN( "Exception is thrown on server build" )
+                {
+                    REQUIRE_THROWS_WITH(serverBuilder.build(),
+                                        "Invalid parameter value: service threads");
+                }
+            }
+
+            AND_WHEN( "Max messages per write is zero" )
+            {
+                serverBuilder.setMaxMessagesPerWrite(0);
+
+                THEN( "Exception is thrown on server build" )
+                {
+                    REQUIRE_THROWS_WITH(serverBuilder.build(),
+                                        "Invalid parameter value: max messages per write");
+                }
+            }
+
+            AND_WHEN( "Max bytes per write is zero" )
+            {
+                serverBuilder.setMaxBytesPerWrite(0);
+
+                THEN( "Exception is thrown on server build" )
+                {
+                    REQUIRE_THROWS_WITH(serverBuilder.build(),
+                                        "Invalid parameter value: max bytes per write");
+                }
+            }
+
+            AND_WHEN( "Max queued logic events is zero" )
+            {
+                serverBuilder.setMaxQueuedLogicEvents(0);
+
+                THEN( "Exception is thrown on server build" )
+                {
+                    REQUIRE_THROWS_WITH(serverBuilder.build(),
+                                        "Invalid parameter value: max queued logic events");
+                }
+            }
+
+            AND_WHEN( "Stream chunk size is zero" )
+            {
+                serverBuilder.setStreamChunkSize(0);
+
+                THEN( "Exception is thrown on server build" )
+                {
+                    REQUIRE_THROWS_WITH(serverBuilder.build(),
+                                        "Invalid parameter value: stream chunk size");
+                }
+            }
+
+            AND_WHEN( "Max message size is zero" )
+            {
+                serverBuilder.setMaxMessageSize(0);
+
+                THEN( "Exception is thrown on server build" )
+                {
+                    REQUIRE_THROWS_WITH(serverBuilder.build(),
+                                        "Invalid parameter value: max message size");
+                }
+            }
+
+            AND_WHEN( "Compression window bits is out of range" )
+            {
+                serverBuilder.setCompression(CompressionSettingsBuilder{}
+                                                 .setWindowBits(COMPRESSION_INVALID_WINDOW_BITS)
+                                                 .build());
+
+                THEN( "Exception is thrown on server build" )
+                {
+                    REQUIRE_THROWS_WITH(serverBuilder.build(),
+                                        "Invalid parameter value: compression window bits");
+                }
+            }
+
+            AND_WHEN( "Socket send buffer size is negative" )
+            {
+                serverBuilder.setSocketSendBufferSize(INVALID_SOCKET_BUFFER_SIZE);
+
+                THEN( "Exception is thrown on server build" )
+                {
+                    REQUIRE_THROWS_WITH(serverBuilder.build(),
+                                        "Invalid parameter value: socket send buffer size");
+                }
+            }
         }
     } // GIVEN
 } // SCENARIO
@@ -0,0 +1,229 @@
+/*
+ * lwspp - C++ wrapper for the libwebsockets library
+ *
+ * Copyright (C) 2023 - 2023 Volodymyr Lotoshko <vlotoshko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <future>
+#include <libwebsockets.h>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "MockedPtr.hpp"
+
+#include "lwspp/client/ClientBuilder.hpp"
+#include "lwspp/client/ClientRuntimeBuilder.hpp"
+#include "lwspp/client/IClientControl.hpp" // IWYU pragma: keep
+#include "lwspp/client/IClientRuntime.hpp" // IWYU pragma: keep
+#include "lwspp/client/contract/IClientControlAcceptor.hpp"
+#include "lwspp/client/contract/IClientLogic.hpp"
+
+#include "lwspp/server/IServerControl.hpp" // IWYU pragma: keep
+#include "lwspp/server/ServerBuilder.hpp"
+#include "lwspp/server/contract/IServerControlAcceptor.hpp"
+#include "lwspp/server/contract/IServerLogic.hpp"
+
+// NOLINTBEGIN (readability-function-cognitive-complexity)
+namespace lwspp
+{
+namespace tests
+{
+
+using namespace fakeit;
+
+namespace
+{
+
+const srv::Port PORT = 9000;
+const cli::Address ADDRESS = "localhost";
+const int DISABLE_LOG = 0;
+const std::chrono::milliseconds TIMEOUT{1000};
+const size_t CLIENTS_COUNT = 4;
+const unsigned int SERVICE_THREADS = 2;
+// The libwebsockets built with the smaller LWS_MAX_SMP creates less service threads
+const unsigned int EXPECTED_SERVICE_THREADS = std::min<unsigned int>(SERVICE_THREADS, LWS_MAX_SMP);
+
+const std::string HELLO_SERVER = "hello server!";
+const std::string HELLO_CLIENT = "hello client!";
+
+/**
+ * @brief The ClientsSession struct collects the results of all the clients sharing the runtime
+ */
+struct ClientsSession
+{
+    std::mutex mutex;
+    std::vector<std::string> incomeMessages;
+    std::set<std::thread::id> callbackThreads;
+    std::promise<void> allReceived;
+};
+
+void setupServerBehavior(Mock<srv::contract::IServerLogic>& serverLogic,
+                         Mock<srv::contract::IServerControlAcceptor>& serverControlAcceptor,
+                         srv::IServerControlPtr& serverControl)
+{
+    auto sendHelloToClient = [&](srv::ConnectionId connectionId, const srv::DataPacket&)
+    {
+        serverControl->sendTextData(connectionId, HELLO_CLIENT);
+    };
+
+    Fake(Method(serverLogic, onConnect), Method(serverLogic, onFirstDataPacket),
+         Method(serverLogic, onDisconnect));
+    When(Method(serverLogic, onTextDataReceive)).AlwaysDo(sendHelloToClient);
+
+    When(Method(serverControlAcceptor, acceptServerControl))
+        .Do([&serverControl](srv::IServerControlPtr c){ serverControl = c; });
+}
+
+void setupClientBehavior(Mock<cli::contract::IClientLogic>& clientLogic,
+                         Mock<cli::contract::IClientControlAcceptor>& clientControlAcceptor,
+                         cli::IClientControlPtr& clientControl,
+                         ClientsSession& session)
+{
+    auto sendHelloToServer = [&](cli::IConnectionInfoPtr)
+    {
+        clientControl->sendTextData(HELLO_SERVER);
+    };
+
+    auto onTextDataReceive = [&](const cli::DataPacket& dataPacket)
+    {
+        const std::lock_guard<std::mutex> guard(session.mutex);
+        session.callbackThreads.insert(std::this_thread::get_id());
+        session.incomeMessages.emplace_back(dataPacket.data, dataPacket.length);
+        if (session.incomeMessages.size() == CLIENTS_COUNT)
+        {
+            session.allReceived.set_value();
+        }
+    };
+
+    Fake(Method(clientLogic, onFirstDataPacket), Method(clientLogic, onDisconnect));
+    When(Method(clientLogic, onConnect)).Do(sendHelloToServer);
+    When(Method(clientLogic, onTextDataReceive)).Do(onTextDataReceive);
+
+    When(Method(clientControlAcceptor, acceptClientControl))
+        .Do([&clientControl](cli::IClientControlPtr c){ clientControl = c; });
+}
+
+srv::IServerPtr setupServer(srv::contract::IServerLogicPtr serverLogic,
+                            srv::contract::IServerControlAcceptorPtr serveControlAcceptor)
+{
+    auto serverBuilder = srv::ServerBuilder{};
+    serverBuilder
+        .setCallbackVersion(srv::CallbackVersion::v1_Andromeda)
+        .setPort(PORT)
+        .setServerLogic(serverLogic)
+        .setServerControlAcceptor(serveControlAcceptor)
+        .setLwsLogLevel(DISABLE_LOG);
+
+    return serverBuilder.build();
+}
+
+cli::IClientPtr setupClient(cli::contract::IClientLogicPtr clientLogic,
+                            cli::contract::IClientControlAcceptorPtr clientControlAcceptor,
+                            cli::IClientRuntimePtr runtime)
+{
+    auto clientBuilder = cli::ClientBuilder{};
+    clientBuilder
+        .setCallbackVersion(cli::CallbackVersion::v1_Amsterdam)
+        .setAddress(ADDRESS)
+        .setPort(PORT)
+        .setClientLogic(clientLogic)
+        .setClientControlAcceptor(clientControlAcceptor)
+        .setRuntime(runtime)
+        .setLwsLogLevel(DISABLE_LOG);
+
+    return clientBuilder.build();
+}
+
+} // namespace
+
+//clazy:excludeall=non-pod-global-static
+
+SCENARIO( "Clients share the runtime", "[client_runtime]" )
+{
+    ClientsSession session;
+    auto waitForMessages = session.allReceived.get_future();
+
+    auto srvLogic = MockedPtr<srv::contract::IServerLogic>{};
+    auto srvControlAcceptor = MockedPtr<srv::contract::IServerControlAcceptor>{};
+    srv::IServerControlPtr srvControl;
+    setupServerBehavior(srvLogic.mock(), srvControlAcceptor.mock(), srvControl);
+
+    std::vector<MockedPtr<cli::contract::IClientLogic>> cliLogics(CLIENTS_COUNT);
+    std::vector<MockedPtr<cli::contract::IClientControlAcceptor>> cliControlAcceptors(CLIENTS_COUNT);
+    std::vector<cli::IClientControlPtr> cliControls(CLIENTS_COUNT);
+    for (size_t i = 0; i < CLIENTS_COUNT; ++i)
+    {
+        setupClientBehavior(cliLogics[i].mock(), cliControlAcceptors[i].mock(), cliControls[i],
+                            session);
+    }
+
+    GIVEN( "Server and the clients serviced by the same runtime" )
+    {
+        auto server = setupServer(srvLogic.ptr(), srvControlAcceptor.ptr());
+        auto runtime = cli::ClientRuntimeBuilder{}
+                           .setServiceThreads(SERVICE_THREADS)
+                           .setLwsLogLevel(DISABLE_LOG)
+                           .build();
+
+        std::vector<cli::IClientPtr> clients;
+        for (size_t i = 0; i < CLIENTS_COUNT; ++i)
+        {
+            clients.push_back(setupClient(cliLogics[i].ptr(), cliControlAcceptors[i].ptr(), runtime));
+        }
+
+        WHEN( "Every client sends the message to the server, and the server replies" )
+        {
+            THEN( "Every client receives the reply on the service threads of the runtime" )
+            {
+                REQUIRE(waitForMessages.wait_for(TIMEOUT) == std::future_status::ready);
+
+                for (const auto& incomeMessage : session.incomeMessages)
+                {
+                    REQUIRE(incomeMessage == HELLO_CLIENT);
+                }
+                // The clients are spread over the service threads round-robin
+                REQUIRE(session.callbackThreads.size() == EXPECTED_SERVICE_THREADS);
+                REQUIRE(session.callbackThreads.count(std::this_thread::get_id()) == 0);
+
+                // The runtime outlives the clients, it is stopped by the last of them
+                runtime.reset();
+                clients.clear();
+                server.reset();
+
+                for (auto& cliLogic : cliLogics)
+                {
+                    Verify(Method(cliLogic.mock(), onConnect)).Once();
+                    Verify(Method(cliLogic.mock(), onTextDataReceive)).Once();
+                }
+                Verify(Method(srvLogic.mock(), onTextDataReceive)).Exactly(static_cast<int>(CLIENTS_COUNT));
+            }
+        }
+    } // GIVEN
+} // SCENARIO
+
+} // namespace tests
+} // namespace lwspp
+// NOLINTEND (readability-function-cognitive-complexity)
@@ -0,0 +1,229 @@
+/*
+ * lwspp - C++ wrapper for the libwebsockets library
+ *
+ * Copyright (C) 2023 - 2023 Volodymyr Lotoshko <vlotoshko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+#include <catch2/catch_test_macros.hpp>
+#include <future>
+#include <string>
+#include <vector>
+
+#include "MockedPtr.hpp"
+
+#include "lwspp/client/ClientBuilder.hpp"
+#include "lwspp/client/CompressionSettingsBuilder.hpp"
+#include "lwspp/client/IClientControl.hpp" // IWYU pragma: keep
+#include "lwspp/client/contract/IClientControlAcceptor.hpp"
+#include "lwspp/client/contract/IClientLogic.hpp"
+
+#include "lwspp/server/CompressionSettingsBuilder.hpp"
+#include "lwspp/server/IServerControl.hpp" // IWYU pragma: keep
+#include "lwspp/server/ServerBuilder.hpp"
+#include "lwspp/server/contract/IServerControlAcceptor.hpp"
+#include "lwspp/server/contract/IServerLogic.hpp"
+
+// NOLINTBEGIN (readability-function-cognitive-complexity)
+namespace lwspp
+{
+namespace tests
+{
+
+using namespace fakeit;
+
+namespace
+{
+
+const srv::Port PORT = 9000;
+const cli::Address ADDRESS = "localhost";
+const int DISABLE_LOG = 0;
+const std::chrono::milliseconds TIMEOUT{100};
+const std::chrono::milliseconds TRANSFER_TIMEOUT{2000};
+
+const std::string HELLO_SERVER = "hello server!";
+const size_t MESSAGES_COUNT = 20;
+// Exceeds the output buffer of the extension, so the compressed output is drained by several
+// writes
+const size_t LARGE_MESSAGE_SIZE = 256 * 1024;
+
+// The small and the large messages are interleaved, the large ones vary enough to stay large
+// after the compression
+auto makeMessages() -> std::vector<std::string>
+{
+    std::vector<std::string> messages;
+    for (size_t i = 0; i < MESSAGES_COUNT; ++i)
+    {
+        if (i % 2 == 0)
+        {
+            messages.push_back("{\"tick\":" + std::to_string(i) + "}");
+            continue;
+        }
+
+        std::string message;
+        for (size_t price = 0; message.size() < LARGE_MESSAGE_SIZE; ++price)
+        {
+            message += "{\"id\":" + std::to_string(i) + ",\"price\":" +
+                       std::to_string(price * price % 9973) + "},";
+        }
+        messages.push_back(std::move(message));
+    }
+    return messages;
+}
+
+void setupServerBehavior(Mock<srv::contract::IServerLogic>& serverLogic,
+                         Mock<srv::contract::IServerControlAcceptor>& serverControlAcceptor,
+                         srv::IServerControlPtr& serverControl,
+                         srv::ConnectionId& connectionId,
+                         const std::vector<std::string>& messages)
+{
+    auto sendMessages = [&](srv::ConnectionId id, const srv::DataPacket&)
+    {
+        connectionId = id;
+        for (const auto& message : messages)
+        {
+            serverControl->sendTextData(id, message);
+        }
+    };
+
+    Fake(Method(serverLogic, onConnect), Method(serverLogic, onFirstDataPacket),
+         Method(serverLogic, onDisconnect));
+    When(Method(serverLogic, onTextDataReceive)).Do(sendMessages);
+
+    When(Method(serverControlAcceptor, acceptServerControl))
+        .Do([&serverControl](srv::IServerControlPtr c){ serverControl = c; });
+}
+
+void setupClientBehavior(Mock<cli::contract::IClientLogic>& clientLogic,
+                         Mock<cli::contract::IClientControlAcceptor>& clientControlAcceptor,
+                         cli::IClientControlPtr& clientControl,
+                         std::vector<std::string>& incomeMessages,
+                         std::promise<void>& received)
+{
+    auto sendHelloToServer = [&](cli::IConnectionInfoPtr)
+    {
+        clientControl->sendTextData(HELLO_SERVER);
+    };
+
+    auto onTextDataReceive = [&](const cli::DataPacket& dataPacket)
+    {
+        incomeMessages.emplace_back(dataPacket.data, dataPacket.length);
+        if (incomeMessages.size() == MESSAGES_COUNT)
+        {
+            received.set_value();
+        }
+    };
+
+    Fake(Method(clientLogic, onFirstDataPacket), Method(clientLogic, onDisconnect));
+    When(Method(clientLogic, onConnect)).Do(sendHelloToServer);
+    When(Method(clientLogic, onTextDataReceive)).AlwaysDo(onTextDataReceive);
+
+    When(Method(clientControlAcceptor, acceptClientControl))
+        .Do([&clientControl](cli::IClientControlPtr c){ clientControl = c; });
+}
+
+srv::IServerPtr setupServer(srv::contract::IServerLogicPtr serverLogic,
+                            srv::contract::IServerControlAcceptorPtr serveControlAcceptor)
+{
+    auto serverBuilder = srv::ServerBuilder{};
+    serverBuilder
+        .setCallbackVersion(srv::CallbackVersion::v1_Andromeda)
+        .setPort(PORT)
+        .setServerLogic(serverLogic)
+        .setServerControlAcceptor(serveControlAcceptor)
+        .setCompression(srv::CompressionSettingsBuilder{}.build())
+        .setLwsLogLevel(DISABLE_LOG);
+
+    return serverBuilder.build();
+}
+
+cli::IClientPtr setupClient(cli::contract::IClientLogicPtr clientLogic,
+                            cli::contract::IClientControlAcceptorPtr clientControlAcceptor)
+{
+    auto clientBuilder = cli::ClientBuilder{};
+    clientBuilder
+        .setCallbackVersion(cli::CallbackVersion::v1_Amsterdam)
+        .setAddress(ADDRESS)
+        .setPort(PORT)
+        .setClientLogic(clientLogic)
+        .setClientControlAcceptor(clientControlAcceptor)
+        .setCompression(cli::CompressionSettingsBuilder{}.build())
+        .setLwsLogLevel(DISABLE_LOG);
+
+    return clientBuilder.build();
+}
+
+} // namespace
+
+//clazy:excludeall=non-pod-global-static
+
+SCENARIO( "Server sends compressed messages of different sizes", "[compression]" )
+{
+    auto srvLogic = MockedPtr<srv::contract::IServerLogic>{};
+    auto cliLogic = MockedPtr<cli::contract::IClientLogic>{};
+
+    auto srvControlAcceptor = MockedPtr<srv::contract::IServerControlAcceptor>{};
+    auto cliControlAcceptor = MockedPtr<cli::contract::IClientControlAcceptor>{};
+
+    srv::IServerControlPtr srvControl;
+    cli::IClientControlPtr cliControl;
+
+    const auto messages = makeMessages();
+    srv::ConnectionId connectionId{};
+    std::vector<std::string> incomeMessages;
+
+    std::promise<void> received;
+    auto waitForMessages = received.get_future();
+
+    setupServerBehavior(srvLogic.mock(), srvControlAcceptor.mock(), srvControl, connectionId,
+                        messages);
+    setupClientBehavior(cliLogic.mock(), cliControlAcceptor.mock(), cliControl, incomeMessages,
+                        received);
+
+    GIVEN( "Server and client negotiating the permessage-deflate" )
+    {
+        auto server = setupServer(srvLogic.ptr(), srvControlAcceptor.ptr());
+        auto client = setupClient(cliLogic.ptr(), cliControlAcceptor.ptr());
+
+        WHEN( "Server sends the small and the large messages interleaved" )
+        {
+            REQUIRE(waitForMessages.wait_for(TRANSFER_TIMEOUT) == std::future_status::ready);
+            const auto stats = srvControl->getCompressionStats(connectionId);
+
+            client.reset();
+            server.reset();
+
+            THEN( "Client receives every message intact and in order, the statistics show "
+                  "the compressed data" )
+            {
+                REQUIRE(incomeMessages.size() == messages.size());
+                for (size_t i = 0; i < messages.size(); ++i)
+                {
+                    CHECK(incomeMessages[i] == messages[i]);
+                }
+                CHECK(stats.compressedBytes > 0);
+                CHECK(stats.compressedBytes < stats.uncompressedBytes);
+            }
+        }
+    } // GIVEN
+} // SCENARIO
+
+} // namespace tests
+} // namespace lwspp
+// NOLINTEND (readability-function-cognitive-complexity)
@@ -0,0 +1,202 @@
+/*
+ * lwspp - C++ wrapper for the libwebsockets library
+ *
+ * Copyright (C) 2023 - 2023 Volodymyr Lotoshko <vlotoshko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <future>
+#include <utility>
+#include <vector>
+
+#include "MockedPtr.hpp"
+
+#include "lwspp/client/ClientBuilder.hpp"
+#include "lwspp/client/contract/IClientControlAcceptor.hpp"
+#include "lwspp/client/contract/IClientLogic.hpp"
+
+#include "lwspp/server/IConnectionInfo.hpp" // IWYU pragma: keep
+#include "lwspp/server/IServerControl.hpp"  // IWYU pragma: keep
+#include "lwspp/server/ServerBuilder.hpp"
+#include "lwspp/server/contract/IServerControlAcceptor.hpp"
+#include "lwspp/server/contract/IServerLogic.hpp"
+
+// NOLINTBEGIN (readability-function-cognitive-complexity)
+namespace lwspp
+{
+namespace tests
+{
+
+using namespace fakeit;
+
+namespace
+{
+
+const srv::Port PORT = 9000;
+const cli::Address ADDRESS = "localhost";
+const int DISABLE_LOG = 0;
+const std::chrono::milliseconds TIMEOUT{100};
+
+const srv::ConflationKey PRICE_KEY = "price";
+const srv::ConflationKey VOLUME_KEY = "volume";
+const std::string FIRST_PRICE = "100";
+const std::string FIRST_VOLUME = "10";
+const std::string PLAIN_MESSAGE = "plain message";
+const std::vector<char> LATEST_PRICE = {'1', '0', '1'};
+const std::string LATEST_VOLUME = "20";
+
+// The received message and whether it is binary
+using IncomeMessage = std::pair<bool, std::string>;
+using IncomeMessages = std::vector<IncomeMessage>;
+
+const IncomeMessages EXPECTED_MESSAGES = {
+    {true, std::string(LATEST_PRICE.begin(), LATEST_PRICE.end())},
+    {false, LATEST_VOLUME},
+    {false, PLAIN_MESSAGE}
+};
+
+void setupServerBehavior(Mock<srv::contract::IServerLogic>& serverLogic,
+                         Mock<srv::contract::IServerControlAcceptor>& serverControlAcceptor,
+                         srv::IServerControlPtr& serverControl)
+{
+    // NOTE: The data is queued on the service thread, so nothing is written until all the data
+    // is queued and the latest data of the keys replaces the queued one
+    auto sendConflatedData = [&](srv::IConnectionInfoPtr connectionInfo)
+    {
+        const auto connectionId = connectionInfo->getConnectionId();
+        serverControl->sendTextData(connectionId, PRICE_KEY, FIRST_PRICE);
+        serverControl->sendTextData(connectionId, VOLUME_KEY, FIRST_VOLUME);
+        serverControl->sendTextData(connectionId, PLAIN_MESSAGE);
+        serverControl->sendBinaryData(connectionId, PRICE_KEY, LATEST_PRICE);
+        serverControl->sendTextData(connectionId, VOLUME_KEY, LATEST_VOLUME);
+    };
+
+    Fake(Method(serverLogic, onDisconnect));
+    When(Method(serverLogic, onConnect)).Do(sendConflatedData);
+
+    When(Method(serverControlAcceptor, acceptServerControl))
+        .Do([&serverControl](srv::IServerControlPtr c){ serverControl = c; });
+}
+
+void setupClientBehavior(Mock<cli::contract::IClientLogic>& clientLogic,
+                         Mock<cli::contract::IClientControlAcceptor>& clientControlAcceptor,
+                         cli::IClientControlPtr& clientControl,
+                         IncomeMessages& incomeMessages,
+                         std::promise<void>& allMessagesReceived)
+{
+    auto onDataReceive = [&](bool isBinary, const cli::DataPacket& dataPacket)
+    {
+        incomeMessages.emplace_back(isBinary, std::string{dataPacket.data, dataPacket.length});
+        if (incomeMessages.size() == EXPECTED_MESSAGES.size())
+        {
+            allMessagesReceived.set_value();
+        }
+    };
+
+    Fake(Method(clientLogic, onConnect), Method(clientLogic, onFirstDataPacket),
+         Method(clientLogic, onDisconnect));
+    When(Method(clientLogic, onTextDataReceive))
+        .AlwaysDo([onDataReceive](const cli::DataPacket& d){ onDataReceive(false, d); });
+    When(Method(clientLogic, onBinaryDataReceive))
+        .AlwaysDo([onDataReceive](const cli::DataPacket& d){ onDataReceive(true, d); });
+
+    When(Method(clientControlAcceptor, acceptClientControl))
+        .Do([&clientControl](cli::IClientControlPtr c){ clientControl = c; });
+}
+
+srv::IServerPtr setupServer(srv::contract::IServerLogicPtr serverLogic,
+                            srv::contract::IServerControlAcceptorPtr serveControlAcceptor)
+{
+    auto serverBuilder = srv::ServerBuilder{};
+    serverBuilder
+        .setCallbackVersion(srv::CallbackVersion::v1_Andromeda)
+        .setPort(PORT)
+        .setServerLogic(serverLogic)
+        .setServerControlAcceptor(serveControlAcceptor)
+        .setLwsLogLevel(DISABLE_LOG);
+
+    return serverBuilder.build();
+}
+
+cli::IClientPtr setupClient(cli::contract::IClientLogicPtr clientLogic,
+                            cli::contract::IClientControlAcceptorPtr clientControlAcceptor)
+{
+    auto clientBuilder = cli::ClientBuilder{};
+    clientBuilder
+        .setCallbackVersion(cli::CallbackVersion::v1_Amsterdam)
+        .setAddress(ADDRESS)
+        .setPort(PORT)
+        .setClientLogic(clientLogic)
+        .setClientControlAcceptor(clientControlAcceptor)
+        .setLwsLogLevel(DISABLE_LOG);
+
+    return clientBuilder.build();
+}
+
+} // namespace
+
+//clazy:excludeall=non-pod-global-static
+
+SCENARIO( "Server conflates the queued data by the key", "[conflation]" )
+{
+    std::promise<void> allMessagesReceived;
+    auto waitForMessages = allMessagesReceived.get_future();
+    IncomeMessages incomeMessages;
+
+    auto srvLogic = MockedPtr<srv::contract::IServerLogic>{};
+    auto cliLogic = MockedPtr<cli::contract::IClientLogic>{};
+
+    auto srvControlAcceptor = MockedPtr<srv::contract::IServerControlAcceptor>{};
+    auto cliControlAcceptor = MockedPtr<cli::contract::IClientControlAcceptor>{};
+
+    srv::IServerControlPtr srvControl;
+    cli::IClientControlPtr cliControl;
+
+    setupServerBehavior(srvLogic.mock(), srvControlAcceptor.mock(), srvControl);
+    setupClientBehavior(cliLogic.mock(), cliControlAcceptor.mock(), cliControl, incomeMessages,
+                        allMessagesReceived);
+
+    GIVEN( "Server and client" )
+    {
+        auto server = setupServer(srvLogic.ptr(), srvControlAcceptor.ptr());
+        auto client = setupClient(cliLogic.ptr(), cliControlAcceptor.ptr());
+
+        WHEN( "Server replaces the queued data of the keys, the text data by the binary one" )
+        {
+            THEN( "Client receives the latest data of every key in place of the replaced one" )
+            {
+                REQUIRE(waitForMessages.wait_for(TIMEOUT) == std::future_status::ready);
+
+                server.reset();
+                client.reset();
+
+                Verify(Method(cliLogic.mock(), onBinaryDataReceive)).Once();
+                Verify(Method(cliLogic.mock(), onTextDataReceive)).Twice();
+
+                CHECK(incomeMessages == EXPECTED_MESSAGES);
+            }
+        }
+    } // GIVEN
+} // SCENARIO
+
+} // namespace tests
+} // namespace lwspp
+// NOLINTEND (readability-function-cognitive-complexity)
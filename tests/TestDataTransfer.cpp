@@ -22,7 +22,11 @@
  * IN THE SOFTWARE.
  */
 
+#include <algorithm>
+#include <atomic>
 #include <catch2/catch_test_macros.hpp>
+#include <cstring>
+#include <future>
 #include <thread>
 
 #include "MockedPtr.hpp"
@@ -36,6 +40,7 @@
 #include "lwspp/server/ServerBuilder.hpp"
 #include "lwspp/server/contract/IServerControlAcceptor.hpp"
 #include "lwspp/server/contract/IServerLogic.hpp"
+#include "lwspp/server/contract/IStreamProducer.hpp"
 
 // NOLINTBEGIN (readability-function-cognitive-complexity)
 namespace lwspp
@@ -58,6 +63,11 @@ int DEFAULT_LWS_BUFFER_SIZE = 4096;
 const std::vector<char> HELLO_SERVER_BINARY(DEFAULT_LWS_BUFFER_SIZE + 1024, BYTE);
 const std::vector<char> HELLO_CLIENT_BINARY(DEFAULT_LWS_BUFFER_SIZE*2 + 1024, BYTE);
 
+const size_t FRAGMENT_SIZE = 1024;
+const size_t LARGE_MESSAGE_SIZE = 8 * 1024 * 1024;
+const size_t LARGE_FRAGMENT_SIZE = 16 * 1024;
+const std::chrono::milliseconds TIMEOUT{100};
+
 
 void setupServerBehavior(Mock<srv::contract::IServerLogic>& serverLogic,
                          Mock<srv::contract::IServerControlAcceptor>& serverControlAcceptor,
@@ -119,6 +129,35 @@ void setupClientBehavior(Mock<cli::contract::IClientLogic>& clientLogic,
         .Do([&clientControl](cli::IClientControlPtr c){ clientControl = c; });
 }
 
+// Streams the data in one chunk once it is available
+class DelayedStreamProducer : public srv::contract::IStreamProducer
+{
+public:
+    explicit DelayedStreamProducer(std::vector<char> data) : _data(std::move(data)) {}
+
+    void makeAvailable() { _isAvailable = true; }
+
+    auto produceChunk(char* buffer, size_t capacity) noexcept -> srv::StreamChunk override
+    {
+        if (!_isAvailable)
+        {
+            ++notReadyCount;
+            return srv::StreamChunk{0, false, false};
+        }
+        const size_t size = std::min(capacity, _data.size() - _produced);
+        std::memcpy(buffer, _data.data() + _produced, size);
+        _produced += size;
+        return srv::StreamChunk{size, _produced == _data.size()};
+    }
+
+    std::atomic<size_t> notReadyCount{0};
+
+private:
+    std::vector<char> _data;
+    size_t _produced = 0;
+    std::atomic<bool> _isAvailable{false};
+};
+
 srv::IServerPtr setupServer(srv::contract::IServerLogicPtr serverLogic,
                             srv::contract::IServerControlAcceptorPtr serverControlAcceptor)
 {
@@ -214,6 +253,263 @@ SCENARIO( "Clients sends binary data to the server", "[data_transfer]" )
     } // GIVEN
 } // SCENARIO
 
+SCENARIO( "Client sends the fragmented message to the server", "[data_transfer]" )
+{
+    auto srvLogic = MockedPtr<srv::contract::IServerLogic>{};
+    auto cliLogic = MockedPtr<cli::contract::IClientLogic>{};
+
+    auto srvControlAcceptor = MockedPtr<srv::contract::IServerControlAcceptor>{};
+    auto cliControlAcceptor = MockedPtr<cli::contract::IClientControlAcceptor>{};
+
+    srv::IServerControlPtr srvControl;
+    cli::IClientControlPtr cliControl;
+
+    // Every fragment differs, so the misplaced one is detected
+    std::vector<char> message;
+    for (size_t i = 0; i < HELLO_SERVER_BINARY.size(); ++i)
+    {
+        message.push_back(static_cast<char>(i / FRAGMENT_SIZE));
+    }
+
+    std::promise<std::vector<char>> incomeMessage;
+    auto waitForMessage = incomeMessage.get_future();
+    std::promise<void> disconnected;
+    auto waitForDisconnect = disconnected.get_future();
+
+    Fake(Method(srvLogic.mock(), onConnect), Method(srvLogic.mock(), onDisconnect),
+         Method(srvLogic.mock(), onFirstDataPacket), Method(srvLogic.mock(), onError));
+    When(Method(srvLogic.mock(), onBinaryDataReceive))
+        .Do([&](srv::ConnectionId, const srv::DataPacket& dataPacket)
+            {
+                incomeMessage.set_value(std::vector<char>(dataPacket.data,
+                                                          dataPacket.data + dataPacket.length));
+            });
+    When(Method(srvControlAcceptor.mock(), acceptServerControl))
+        .Do([&srvControl](srv::IServerControlPtr c){ srvControl = c; });
+
+    Fake(Method(cliLogic.mock(), onError), Method(cliLogic.mock(), onWarning));
+    When(Method(cliLogic.mock(), onConnect))
+        .Do([&](cli::IConnectionInfoPtr){ cliControl->sendBinaryData(message); });
+    When(Method(cliLogic.mock(), onDisconnect)).Do([&](){ disconnected.set_value(); });
+    When(Method(cliControlAcceptor.mock(), acceptClientControl))
+        .Do([&cliControl](cli::IClientControlPtr c){ cliControl = c; });
+
+    GIVEN( "Server reassembling the messages and client sending the fragments" )
+    {
+        auto serverBuilder = srv::ServerBuilder{};
+        serverBuilder
+            .setCallbackVersion(srv::CallbackVersion::v2_BlackHole)
+            .setPort(PORT)
+            .setServerLogic(srvLogic.ptr())
+            .setServerControlAcceptor(srvControlAcceptor.ptr())
+            .setLwsLogLevel(DISABLE_LOG);
+
+        auto clientBuilder = cli::ClientBuilder{};
+        clientBuilder
+            .setCallbackVersion(cli::CallbackVersion::v1_Amsterdam)
+            .setAddress(ADDRESS)
+            .setPort(PORT)
+            .setMaxFragmentSize(FRAGMENT_SIZE)
+            .setClientLogic(cliLogic.ptr())
+            .setClientControlAcceptor(cliControlAcceptor.ptr())
+            .setLwsLogLevel(DISABLE_LOG);
+
+        WHEN( "The message fits the max message size of the server" )
+        {
+            auto server = serverBuilder.build();
+            auto client = clientBuilder.build();
+
+            THEN( "Server receives the whole message once" )
+            {
+                REQUIRE(waitForMessage.wait_for(TIMEOUT) == std::future_status::ready);
+                CHECK(waitForMessage.get() == message);
+
+                server.reset();
+                client.reset();
+
+                Verify(Method(srvLogic.mock(), onBinaryDataReceive)).Once();
+                Verify(Method(srvLogic.mock(), onError)).Never();
+            }
+        }
+
+        WHEN( "The message exceeds the max message size of the server" )
+        {
+            serverBuilder.setMaxMessageSize(message.size() - 1);
+            auto server = serverBuilder.build();
+            auto client = clientBuilder.build();
+
+            THEN( "Server closes the connection without delivering the message" )
+            {
+                REQUIRE(waitForDisconnect.wait_for(TIMEOUT) == std::future_status::ready);
+
+                server.reset();
+                client.reset();
+
+                Verify(Method(srvLogic.mock(), onError)).Once();
+                Verify(Method(srvLogic.mock(), onBinaryDataReceive)).Never();
+            }
+        }
+    } // GIVEN
+} // SCENARIO
+
+SCENARIO( "Server sends the large fragmented message and the small one", "[data_transfer]" )
+{
+    auto srvLogic = MockedPtr<srv::contract::IServerLogic>{};
+    auto firstCliLogic = MockedPtr<cli::contract::IClientLogic>{};
+    auto secondCliLogic = MockedPtr<cli::contract::IClientLogic>{};
+
+    auto srvControlAcceptor = MockedPtr<srv::contract::IServerControlAcceptor>{};
+    auto cliControlAcceptor = MockedPtr<cli::contract::IClientControlAcceptor>{};
+
+    srv::IServerControlPtr srvControl;
+
+    std::promise<srv::ConnectionId> firstConnected;
+    auto waitForFirstConnect = firstConnected.get_future();
+    std::promise<srv::ConnectionId> secondConnected;
+    auto waitForSecondConnect = secondConnected.get_future();
+    std::promise<void> largeReceived;
+    auto waitForLarge = largeReceived.get_future();
+    std::promise<bool> smallReceived;
+    auto waitForSmall = smallReceived.get_future();
+
+    // The connections are accepted one by one, the first client connects before the second one
+    Fake(Method(srvLogic.mock(), onDisconnect));
+    When(Method(srvLogic.mock(), onConnect))
+        .Do([&](srv::IConnectionInfoPtr c){ firstConnected.set_value(c->getConnectionId()); })
+        .Do([&](srv::IConnectionInfoPtr c){ secondConnected.set_value(c->getConnectionId()); });
+    When(Method(srvControlAcceptor.mock(), acceptServerControl))
+        .Do([&srvControl](srv::IServerControlPtr c){ srvControl = c; });
+    Fake(Method(cliControlAcceptor.mock(), acceptClientControl));
+
+    std::atomic<size_t> largeReceivedSize{0};
+    Fake(Method(firstCliLogic.mock(), onConnect), Method(firstCliLogic.mock(), onDisconnect),
+         Method(firstCliLogic.mock(), onFirstDataPacket));
+    When(Method(firstCliLogic.mock(), onBinaryDataReceive))
+        .AlwaysDo([&](const cli::DataPacket& dataPacket)
+            {
+                if ((largeReceivedSize += dataPacket.length) == LARGE_MESSAGE_SIZE)
+                {
+                    largeReceived.set_value();
+                }
+            });
+
+    Fake(Method(secondCliLogic.mock(), onConnect), Method(secondCliLogic.mock(), onDisconnect),
+         Method(secondCliLogic.mock(), onFirstDataPacket));
+    When(Method(secondCliLogic.mock(), onBinaryDataReceive))
+        .Do([&](const cli::DataPacket&)
+            {
+                smallReceived.set_value(largeReceivedSize == LARGE_MESSAGE_SIZE);
+            });
+
+    GIVEN( "Server fragmenting the messages and two clients" )
+    {
+        auto serverBuilder = srv::ServerBuilder{};
+        serverBuilder
+            .setCallbackVersion(srv::CallbackVersion::v1_Andromeda)
+            .setPort(PORT)
+            .setMaxFragmentSize(LARGE_FRAGMENT_SIZE)
+            .setServerLogic(srvLogic.ptr())
+            .setServerControlAcceptor(srvControlAcceptor.ptr())
+            .setLwsLogLevel(DISABLE_LOG);
+        auto server = serverBuilder.build();
+
+        auto firstClient = setupClient(firstCliLogic.ptr(), cliControlAcceptor.ptr());
+        REQUIRE(waitForFirstConnect.wait_for(TIMEOUT) == std::future_status::ready);
+        auto secondClient = setupClient(secondCliLogic.ptr(), cliControlAcceptor.ptr());
+        REQUIRE(waitForSecondConnect.wait_for(TIMEOUT) == std::future_status::ready);
+
+        WHEN( "Server sends the large message to the first client and then the small one to the "
+              "second client" )
+        {
+            srvControl->sendBinaryData(waitForFirstConnect.get(),
+                                       std::vector<char>(LARGE_MESSAGE_SIZE, BYTE));
+            srvControl->sendBinaryData(waitForSecondConnect.get(), HELLO_SERVER_BINARY);
+
+            THEN( "The second client receives the small message before the large one is written" )
+            {
+                REQUIRE(waitForSmall.wait_for(TIMEOUT) == std::future_status::ready);
+                CHECK_FALSE(waitForSmall.get());
+                CHECK(waitForLarge.wait_for(TIMEOUT * 10) == std::future_status::ready);
+            }
+        }
+    } // GIVEN
+} // SCENARIO
+
+SCENARIO( "Server streams the data which is not ready yet", "[data_transfer]" )
+{
+    auto srvLogic = MockedPtr<srv::contract::IServerLogic>{};
+    auto cliLogic = MockedPtr<cli::contract::IClientLogic>{};
+
+    auto srvControlAcceptor = MockedPtr<srv::contract::IServerControlAcceptor>{};
+    auto cliControlAcceptor = MockedPtr<cli::contract::IClientControlAcceptor>{};
+
+    srv::IServerControlPtr srvControl;
+
+    auto producer = std::make_shared<DelayedStreamProducer>(HELLO_CLIENT_BINARY);
+
+    std::promise<srv::ConnectionId> connected;
+    auto waitForConnect = connected.get_future();
+    std::promise<std::vector<char>> incomeMessage;
+    auto waitForMessage = incomeMessage.get_future();
+
+    Fake(Method(srvLogic.mock(), onDisconnect));
+    When(Method(srvLogic.mock(), onConnect))
+        .Do([&](srv::IConnectionInfoPtr info)
+            {
+                srvControl->sendBinaryStream(info->getConnectionId(), producer);
+                connected.set_value(info->getConnectionId());
+            });
+    When(Method(srvControlAcceptor.mock(), acceptServerControl))
+        .Do([&srvControl](srv::IServerControlPtr c){ srvControl = c; });
+
+    Fake(Method(cliLogic.mock(), onConnect), Method(cliLogic.mock(), onDisconnect),
+         Method(cliLogic.mock(), onFirstDataPacket),
+         Method(cliControlAcceptor.mock(), acceptClientControl));
+    When(Method(cliLogic.mock(), onBinaryDataReceive))
+        .Do([&](const cli::DataPacket& dataPacket)
+            {
+                incomeMessage.set_value(std::vector<char>(dataPacket.data,
+                                                          dataPacket.data + dataPacket.length));
+            });
+
+    GIVEN( "Server streaming from the producer without data and client reassembling messages" )
+    {
+        auto server = setupServer(srvLogic.ptr(), srvControlAcceptor.ptr());
+
+        auto clientBuilder = cli::ClientBuilder{};
+        clientBuilder
+            .setCallbackVersion(cli::CallbackVersion::v2_Barcelona)
+            .setAddress(ADDRESS)
+            .setPort(PORT)
+            .setClientLogic(cliLogic.ptr())
+            .setClientControlAcceptor(cliControlAcceptor.ptr())
+            .setLwsLogLevel(DISABLE_LOG);
+        auto client = clientBuilder.build();
+
+        REQUIRE(waitForConnect.wait_for(TIMEOUT) == std::future_status::ready);
+        const auto connectionId = waitForConnect.get();
+
+        WHEN( "The producer gets the data later and resumes the stream" )
+        {
+            const bool isReceivedEarly =
+                waitForMessage.wait_for(TIMEOUT) == std::future_status::ready;
+            const size_t notReadyCount = producer->notReadyCount;
+
+            producer->makeAvailable();
+            const bool isResumed = srvControl->resumeStream(connectionId);
+
+            THEN( "The stream is parked instead of polling the producer until it is resumed" )
+            {
+                CHECK_FALSE(isReceivedEarly);
+                CHECK(notReadyCount == 1);
+                REQUIRE(isResumed);
+                REQUIRE(waitForMessage.wait_for(TIMEOUT) == std::future_status::ready);
+                CHECK(waitForMessage.get() == HELLO_CLIENT_BINARY);
+            }
+        }
+    } // GIVEN
+} // SCENARIO
+
 } // namespace tests
 } // namespace lwspp
 // NOLINTEND (readability-function-cognitive-complexity)
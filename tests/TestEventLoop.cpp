@@ -0,0 +1,263 @@
+/*
+ * lwspp - C++ wrapper for the libwebsockets library
+ *
+ * Copyright (C) 2023 - 2023 Volodymyr Lotoshko <vlotoshko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <map>
+#include <poll.h>
+#include <thread>
+#include <vector>
+
+#include "MockedPtr.hpp"
+
+#include "lwspp/client/ClientBuilder.hpp"
+#include "lwspp/client/IClient.hpp"
+#include "lwspp/client/IClientControl.hpp" // IWYU pragma: keep
+#include "lwspp/client/contract/IClientControlAcceptor.hpp"
+#include "lwspp/client/contract/IClientLogic.hpp"
+#include "lwspp/client/contract/IEventLoop.hpp"
+
+#include "lwspp/server/IServer.hpp"
+#include "lwspp/server/IServerControl.hpp" // IWYU pragma: keep
+#include "lwspp/server/ServerBuilder.hpp"
+#include "lwspp/server/contract/IEventLoop.hpp"
+#include "lwspp/server/contract/IServerControlAcceptor.hpp"
+#include "lwspp/server/contract/IServerLogic.hpp"
+
+// NOLINTBEGIN (readability-function-cognitive-complexity)
+namespace lwspp
+{
+namespace tests
+{
+
+using namespace fakeit;
+
+namespace
+{
+
+const srv::Port PORT = 9000;
+const cli::Address ADDRESS = "localhost";
+const int DISABLE_LOG = 0;
+const std::chrono::milliseconds TIMEOUT{1000};
+const int POLL_TIMEOUT_MS = 10;
+
+const std::string HELLO_SERVER = "Hello server";
+const std::string HELLO_CLIENT = "Hello client";
+
+/**
+ * @brief The PollEventLoop class is the minimal poll based event loop, which services the server
+ * or the client on the thread of the test
+ */
+template <typename EventLoop>
+class PollEventLoop : public EventLoop
+{
+public:
+    void watchFd(int fd, short events) noexcept override
+    {
+        _fds[fd] = events;
+    }
+
+    void unwatchFd(int fd) noexcept override
+    {
+        _fds.erase(fd);
+    }
+
+    void wakeUp() noexcept override
+    {
+        _isWokenUp = true;
+    }
+
+    // Polls the watched sockets once and services the occurred events
+    template <typename Serviced>
+    void runOnce(Serviced& serviced)
+    {
+        std::vector<pollfd> pollFds;
+        for (const auto& fd : _fds)
+        {
+            pollFds.push_back(pollfd{fd.first, fd.second, 0});
+        }
+
+        const int timeout = _isWokenUp.exchange(false) ? 0 : POLL_TIMEOUT_MS;
+        ::poll(pollFds.data(), pollFds.size(), timeout);
+
+        for (const auto& pollFd : pollFds)
+        {
+            if (pollFd.revents != 0)
+            {
+                serviced.serviceFd(pollFd.fd, pollFd.revents);
+            }
+        }
+        serviced.service();
+    }
+
+private:
+    std::map<int, short> _fds;
+    std::atomic<bool> _isWokenUp{false};
+};
+
+using ServerEventLoop = PollEventLoop<srv::contract::IEventLoop>;
+using ClientEventLoop = PollEventLoop<cli::contract::IEventLoop>;
+
+void setupServerBehavior(Mock<srv::contract::IServerLogic>& serverLogic,
+                         Mock<srv::contract::IServerControlAcceptor>& serverControlAcceptor,
+                         srv::IServerControlPtr& serverControl,
+                         std::vector<std::thread::id>& callbackThreads)
+{
+    auto sendHelloToClient = [&](srv::ConnectionId connectionId, const srv::DataPacket&)
+    {
+        callbackThreads.push_back(std::this_thread::get_id());
+        serverControl->sendTextData(connectionId, HELLO_CLIENT);
+    };
+
+    Fake(Method(serverLogic, onConnect), Method(serverLogic, onFirstDataPacket),
+         Method(serverLogic, onDisconnect));
+    When(Method(serverLogic, onTextDataReceive)).AlwaysDo(sendHelloToClient);
+
+    When(Method(serverControlAcceptor, acceptServerControl))
+        .Do([&serverControl](srv::IServerControlPtr c){ serverControl = c; });
+}
+
+void setupClientBehavior(Mock<cli::contract::IClientLogic>& clientLogic,
+                         Mock<cli::contract::IClientControlAcceptor>& clientControlAcceptor,
+                         cli::IClientControlPtr& clientControl,
+                         std::string& incomeMessage,
+                         std::vector<std::thread::id>& callbackThreads)
+{
+    auto sendHelloToServer = [&](cli::IConnectionInfoPtr)
+    {
+        callbackThreads.push_back(std::this_thread::get_id());
+        clientControl->sendTextData(HELLO_SERVER);
+    };
+
+    auto onTextDataReceive = [&](const cli::DataPacket& dataPacket)
+    {
+        callbackThreads.push_back(std::this_thread::get_id());
+        incomeMessage.assign(dataPacket.data, dataPacket.length);
+    };
+
+    Fake(Method(clientLogic, onFirstDataPacket), Method(clientLogic, onDisconnect));
+    When(Method(clientLogic, onConnect)).Do(sendHelloToServer);
+    When(Method(clientLogic, onTextDataReceive)).AlwaysDo(onTextDataReceive);
+
+    When(Method(clientControlAcceptor, acceptClientControl))
+        .Do([&clientControl](cli::IClientControlPtr c){ clientControl = c; });
+}
+
+srv::IServerPtr setupServer(srv::contract::IServerLogicPtr serverLogic,
+                            srv::contract::IServerControlAcceptorPtr serveControlAcceptor,
+                            srv::contract::IEventLoopPtr eventLoop)
+{
+    auto serverBuilder = srv::ServerBuilder{};
+    serverBuilder
+        .setCallbackVersion(srv::CallbackVersion::v1_Andromeda)
+        .setPort(PORT)
+        .setServerLogic(serverLogic)
+        .setServerControlAcceptor(serveControlAcceptor)
+        .setEventLoop(eventLoop)
+        .setLwsLogLevel(DISABLE_LOG);
+
+    return serverBuilder.build();
+}
+
+cli::IClientPtr setupClient(cli::contract::IClientLogicPtr clientLogic,
+                            cli::contract::IClientControlAcceptorPtr clientControlAcceptor,
+                            cli::contract::IEventLoopPtr eventLoop)
+{
+    auto clientBuilder = cli::ClientBuilder{};
+    clientBuilder
+        .setCallbackVersion(cli::CallbackVersion::v1_Amsterdam)
+        .setAddress(ADDRESS)
+        .setPort(PORT)
+        .setClientLogic(clientLogic)
+        .setClientControlAcceptor(clientControlAcceptor)
+        .setEventLoop(eventLoop)
+        .setLwsLogLevel(DISABLE_LOG);
+
+    return clientBuilder.build();
+}
+
+} // namespace
+
+//clazy:excludeall=non-pod-global-static
+
+SCENARIO( "Server and client are serviced by the external event loop", "[event_loop]" )
+{
+    std::string incomeMessage;
+    std::vector<std::thread::id> callbackThreads;
+
+    auto srvLogic = MockedPtr<srv::contract::IServerLogic>{};
+    auto cliLogic = MockedPtr<cli::contract::IClientLogic>{};
+
+    auto srvControlAcceptor = MockedPtr<srv::contract::IServerControlAcceptor>{};
+    auto cliControlAcceptor = MockedPtr<cli::contract::IClientControlAcceptor>{};
+
+    srv::IServerControlPtr srvControl;
+    cli::IClientControlPtr cliControl;
+
+    setupServerBehavior(srvLogic.mock(), srvControlAcceptor.mock(), srvControl, callbackThreads);
+    setupClientBehavior(cliLogic.mock(), cliControlAcceptor.mock(), cliControl, incomeMessage,
+                        callbackThreads);
+
+    GIVEN( "Server and client serviced by the event loops of the current thread" )
+    {
+        auto serverEventLoop = std::make_shared<ServerEventLoop>();
+        auto clientEventLoop = std::make_shared<ClientEventLoop>();
+
+        auto server = setupServer(srvLogic.ptr(), srvControlAcceptor.ptr(), serverEventLoop);
+        auto client = setupClient(cliLogic.ptr(), cliControlAcceptor.ptr(), clientEventLoop);
+
+        WHEN( "Client sends the message to the server, and the server replies" )
+        {
+            const auto deadline = std::chrono::steady_clock::now() + TIMEOUT;
+            while (incomeMessage.empty() && std::chrono::steady_clock::now() < deadline)
+            {
+                serverEventLoop->runOnce(*server);
+                clientEventLoop->runOnce(*client);
+            }
+
+            THEN( "Both messages are delivered by the callbacks run on the current thread" )
+            {
+                REQUIRE(incomeMessage == HELLO_CLIENT);
+
+                client.reset();
+                server.reset();
+
+                Verify(Method(cliLogic.mock(), onConnect)).Once();
+                Verify(Method(srvLogic.mock(), onTextDataReceive)).Once();
+                Verify(Method(cliLogic.mock(), onTextDataReceive)).Once();
+
+                const auto threadId = std::this_thread::get_id();
+                for (const auto& callbackThread : callbackThreads)
+                {
+                    CHECK(callbackThread == threadId);
+                }
+            }
+        }
+    } // GIVEN
+} // SCENARIO
+
+} // namespace tests
+} // namespace lwspp
+// NOLINTEND (readability-function-cognitive-complexity)
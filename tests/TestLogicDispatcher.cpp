@@ -0,0 +1,333 @@
+/*
+ * lwspp - C++ wrapper for the libwebsockets library
+ *
+ * Copyright (C) 2023 - 2023 Volodymyr Lotoshko <vlotoshko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "MockedPtr.hpp"
+
+#include "lwspp/client/ClientBuilder.hpp"
+#include "lwspp/client/IClientControl.hpp" // IWYU pragma: keep
+#include "lwspp/client/contract/IClientControlAcceptor.hpp"
+#include "lwspp/client/contract/IClientLogic.hpp"
+
+#include "lwspp/server/ServerBuilder.hpp"
+#include "lwspp/server/contract/IServerControlAcceptor.hpp"
+#include "lwspp/server/contract/IServerLogic.hpp"
+
+// NOLINTBEGIN (readability-function-cognitive-complexity)
+namespace lwspp
+{
+namespace tests
+{
+
+using namespace fakeit;
+
+namespace
+{
+
+const srv::Port PORT = 9000;
+const cli::Address ADDRESS = "localhost";
+const int DISABLE_LOG = 0;
+const std::chrono::milliseconds TIMEOUT{1000};
+
+const unsigned int LOGIC_THREADS = 4;
+// The small limit makes the server pause the reading from the client
+const size_t MAX_QUEUED_LOGIC_EVENTS = 4;
+// Every received message pauses the reading, and the workers drain the queue at once
+const size_t MIN_QUEUED_LOGIC_EVENTS = 1;
+const size_t MESSAGES_COUNT = 100;
+const std::string FAILING_MESSAGE = "fail";
+const std::string ECHO_MESSAGE = "echo";
+
+auto makeMessages() -> std::vector<std::string>
+{
+    std::vector<std::string> messages;
+    for (size_t i = 0; i < MESSAGES_COUNT; ++i)
+    {
+        messages.push_back(std::to_string(i));
+    }
+    return messages;
+}
+
+void setupServerBehavior(Mock<srv::contract::IServerLogic>& serverLogic,
+                         std::vector<std::string>& incomeMessages,
+                         std::promise<void>& allMessagesReceived)
+{
+    // NOTE: The callbacks of the connection are never run concurrently, so no lock is needed
+    auto onTextDataReceive = [&](srv::ConnectionId, const srv::DataPacket& dataPacket)
+    {
+        incomeMessages.emplace_back(dataPacket.data, dataPacket.length);
+        if (incomeMessages.size() == MESSAGES_COUNT)
+        {
+            allMessagesReceived.set_value();
+        }
+    };
+
+    Fake(Method(serverLogic, onConnect), Method(serverLogic, onFirstDataPacket),
+         Method(serverLogic, onDisconnect));
+    When(Method(serverLogic, onTextDataReceive)).AlwaysDo(onTextDataReceive);
+}
+
+void setupClientBehavior(Mock<cli::contract::IClientLogic>& clientLogic,
+                         Mock<cli::contract::IClientControlAcceptor>& clientControlAcceptor,
+                         cli::IClientControlPtr& clientControl)
+{
+    auto sendMessagesToServer = [&clientControl](cli::IConnectionInfoPtr)
+    {
+        for (const auto& message : makeMessages())
+        {
+            clientControl->sendTextData(message);
+        }
+    };
+
+    Fake(Method(clientLogic, onDisconnect));
+    When(Method(clientLogic, onConnect)).Do(sendMessagesToServer);
+
+    When(Method(clientControlAcceptor, acceptClientControl))
+        .Do([&clientControl](cli::IClientControlPtr c){ clientControl = c; });
+}
+
+srv::IServerPtr setupServer(srv::contract::IServerLogicPtr serverLogic,
+                            srv::contract::IServerControlAcceptorPtr serveControlAcceptor,
+                            size_t maxQueuedLogicEvents)
+{
+    auto serverBuilder = srv::ServerBuilder{};
+    serverBuilder
+        .setCallbackVersion(srv::CallbackVersion::v2_BlackHole)
+        .setPort(PORT)
+        .setServerLogic(serverLogic)
+        .setServerControlAcceptor(serveControlAcceptor)
+        .setLogicThreads(LOGIC_THREADS)
+        .setMaxQueuedLogicEvents(maxQueuedLogicEvents)
+        .setLwsLogLevel(DISABLE_LOG);
+
+    return serverBuilder.build();
+}
+
+// The logic fails on the failing message and echoes the other ones back
+void setupFailingServerBehavior(Mock<srv::contract::IServerLogic>& serverLogic,
+                                srv::IServerControlPtr& serverControl)
+{
+    auto onTextDataReceive = [&serverControl](srv::ConnectionId id,
+                                              const srv::DataPacket& dataPacket)
+    {
+        const std::string message(dataPacket.data, dataPacket.length);
+        if (message == FAILING_MESSAGE)
+        {
+            throw std::runtime_error("the server logic failed");
+        }
+        serverControl->sendTextData(id, message);
+    };
+
+    Fake(Method(serverLogic, onConnect), Method(serverLogic, onFirstDataPacket),
+         Method(serverLogic, onDisconnect));
+    When(Method(serverLogic, onTextDataReceive)).AlwaysDo(onTextDataReceive);
+}
+
+// The client sends the message on connect and reports its disconnect and the echoed message
+void setupSendingClientBehavior(Mock<cli::contract::IClientLogic>& clientLogic,
+                                Mock<cli::contract::IClientControlAcceptor>& clientControlAcceptor,
+                                cli::IClientControlPtr& clientControl,
+                                const std::string& message,
+                                std::promise<void>& disconnected,
+                                std::promise<std::string>& echoReceived)
+{
+    Fake(Method(clientLogic, onFirstDataPacket), Method(clientLogic, onWarning),
+         Method(clientLogic, onError));
+    When(Method(clientLogic, onConnect))
+        .Do([&clientControl, message](cli::IConnectionInfoPtr)
+            { clientControl->sendTextData(message); });
+    When(Method(clientLogic, onDisconnect))
+        .Do([&disconnected](){ disconnected.set_value(); });
+    When(Method(clientLogic, onTextDataReceive))
+        .Do([&echoReceived](const cli::DataPacket& dataPacket)
+            { echoReceived.set_value(std::string(dataPacket.data, dataPacket.length)); });
+
+    When(Method(clientControlAcceptor, acceptClientControl))
+        .Do([&clientControl](cli::IClientControlPtr c){ clientControl = c; });
+}
+
+cli::IClientPtr setupClient(cli::contract::IClientLogicPtr clientLogic,
+                            cli::contract::IClientControlAcceptorPtr clientControlAcceptor)
+{
+    auto clientBuilder = cli::ClientBuilder{};
+    clientBuilder
+        .setCallbackVersion(cli::CallbackVersion::v1_Amsterdam)
+        .setAddress(ADDRESS)
+        .setPort(PORT)
+        .setClientLogic(clientLogic)
+        .setClientControlAcceptor(clientControlAcceptor)
+        .setLwsLogLevel(DISABLE_LOG);
+
+    return clientBuilder.build();
+}
+
+} // namespace
+
+//clazy:excludeall=non-pod-global-static
+
+SCENARIO( "Server runs its logic on the worker threads", "[logic_dispatcher]" )
+{
+    std::promise<void> allMessagesReceived;
+    auto waitForMessages = allMessagesReceived.get_future();
+    std::vector<std::string> incomeMessages;
+
+    auto srvLogic = MockedPtr<srv::contract::IServerLogic>{};
+    auto cliLogic = MockedPtr<cli::contract::IClientLogic>{};
+
+    auto srvControlAcceptor = MockedPtr<srv::contract::IServerControlAcceptor>{};
+    auto cliControlAcceptor = MockedPtr<cli::contract::IClientControlAcceptor>{};
+
+    cli::IClientControlPtr cliControl;
+
+    setupServerBehavior(srvLogic.mock(), incomeMessages, allMessagesReceived);
+    setupClientBehavior(cliLogic.mock(), cliControlAcceptor.mock(), cliControl);
+    Fake(Method(srvControlAcceptor.mock(), acceptServerControl));
+
+    GIVEN( "Server with the logic threads and client" )
+    {
+        auto server = setupServer(srvLogic.ptr(), srvControlAcceptor.ptr(),
+                                  MAX_QUEUED_LOGIC_EVENTS);
+        auto client = setupClient(cliLogic.ptr(), cliControlAcceptor.ptr());
+
+        WHEN( "Client sends more messages than the server queues for its logic" )
+        {
+            THEN( "Server logic receives all the messages in order" )
+            {
+                REQUIRE(waitForMessages.wait_for(TIMEOUT) == std::future_status::ready);
+
+                server.reset();
+                client.reset();
+
+                Verify(Method(srvLogic.mock(), onConnect)).Once();
+                Verify(Method(srvLogic.mock(), onTextDataReceive)).Exactly(MESSAGES_COUNT);
+                Verify(Method(srvLogic.mock(), onDisconnect)).Once();
+
+                CHECK(incomeMessages == makeMessages());
+            }
+        }
+    } // GIVEN
+} // SCENARIO
+
+SCENARIO( "Server resumes the reading drained during its pause", "[logic_dispatcher]" )
+{
+    std::promise<void> allMessagesReceived;
+    auto waitForMessages = allMessagesReceived.get_future();
+    std::vector<std::string> incomeMessages;
+
+    auto srvLogic = MockedPtr<srv::contract::IServerLogic>{};
+    auto cliLogic = MockedPtr<cli::contract::IClientLogic>{};
+
+    auto srvControlAcceptor = MockedPtr<srv::contract::IServerControlAcceptor>{};
+    auto cliControlAcceptor = MockedPtr<cli::contract::IClientControlAcceptor>{};
+
+    cli::IClientControlPtr cliControl;
+
+    setupServerBehavior(srvLogic.mock(), incomeMessages, allMessagesReceived);
+    setupClientBehavior(cliLogic.mock(), cliControlAcceptor.mock(), cliControl);
+    Fake(Method(srvControlAcceptor.mock(), acceptServerControl));
+
+    GIVEN( "Server pausing the reading on every received message and client" )
+    {
+        auto server = setupServer(srvLogic.ptr(), srvControlAcceptor.ptr(),
+                                  MIN_QUEUED_LOGIC_EVENTS);
+        auto client = setupClient(cliLogic.ptr(), cliControlAcceptor.ptr());
+
+        WHEN( "The workers drain the queue while the reading is being paused" )
+        {
+            THEN( "Server keeps reading and receives all the messages in order" )
+            {
+                REQUIRE(waitForMessages.wait_for(TIMEOUT) == std::future_status::ready);
+
+                server.reset();
+                client.reset();
+
+                Verify(Method(srvLogic.mock(), onTextDataReceive)).Exactly(MESSAGES_COUNT);
+                CHECK(incomeMessages == makeMessages());
+            }
+        }
+    } // GIVEN
+} // SCENARIO
+
+SCENARIO( "Server survives the exception of its logic on the worker thread", "[logic_dispatcher]" )
+{
+    srv::IServerControlPtr srvControl;
+
+    auto srvLogic = MockedPtr<srv::contract::IServerLogic>{};
+    auto srvControlAcceptor = MockedPtr<srv::contract::IServerControlAcceptor>{};
+    setupFailingServerBehavior(srvLogic.mock(), srvControl);
+    When(Method(srvControlAcceptor.mock(), acceptServerControl))
+        .Do([&srvControl](srv::IServerControlPtr c){ srvControl = c; });
+
+    std::promise<void> failingDisconnected;
+    std::promise<std::string> failingEchoReceived;
+    cli::IClientControlPtr failingControl;
+    auto failingLogic = MockedPtr<cli::contract::IClientLogic>{};
+    auto failingControlAcceptor = MockedPtr<cli::contract::IClientControlAcceptor>{};
+    setupSendingClientBehavior(failingLogic.mock(), failingControlAcceptor.mock(), failingControl,
+                               FAILING_MESSAGE, failingDisconnected, failingEchoReceived);
+
+    std::promise<void> echoDisconnected;
+    std::promise<std::string> echoReceived;
+    auto waitForEcho = echoReceived.get_future();
+    cli::IClientControlPtr echoControl;
+    auto echoLogic = MockedPtr<cli::contract::IClientLogic>{};
+    auto echoControlAcceptor = MockedPtr<cli::contract::IClientControlAcceptor>{};
+    setupSendingClientBehavior(echoLogic.mock(), echoControlAcceptor.mock(), echoControl,
+                               ECHO_MESSAGE, echoDisconnected, echoReceived);
+
+    GIVEN( "Server with the logic threads failing on the message of the client" )
+    {
+        auto server = setupServer(srvLogic.ptr(), srvControlAcceptor.ptr(),
+                                  MAX_QUEUED_LOGIC_EVENTS);
+        auto failingClient = setupClient(failingLogic.ptr(), failingControlAcceptor.ptr());
+
+        WHEN( "Server logic throws on the message of the client" )
+        {
+            THEN( "Server closes that connection and keeps serving the other clients" )
+            {
+                REQUIRE(failingDisconnected.get_future().wait_for(TIMEOUT) ==
+                        std::future_status::ready);
+
+                auto echoClient = setupClient(echoLogic.ptr(), echoControlAcceptor.ptr());
+                REQUIRE(waitForEcho.wait_for(TIMEOUT) == std::future_status::ready);
+                CHECK(waitForEcho.get() == ECHO_MESSAGE);
+
+                echoClient.reset();
+                failingClient.reset();
+                server.reset();
+
+                Verify(Method(srvLogic.mock(), onTextDataReceive)).Twice();
+            }
+        }
+    } // GIVEN
+} // SCENARIO
+
+} // namespace tests
+} // namespace lwspp
+// NOLINTEND (readability-function-cognitive-complexity)
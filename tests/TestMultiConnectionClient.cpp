@@ -0,0 +1,207 @@
+/*
+ * lwspp - C++ wrapper for the libwebsockets library
+ *
+ * Copyright (C) 2023 - 2023 Volodymyr Lotoshko <vlotoshko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <future>
+#include <map>
+#include <mutex>
+
+#include "MockedPtr.hpp"
+
+#include "lwspp/client/ClientBuilder.hpp"
+#include "lwspp/client/IClientControl.hpp" // IWYU pragma: keep
+#include "lwspp/client/contract/IClientControlAcceptor.hpp"
+#include "lwspp/client/contract/IMultiClientLogic.hpp"
+
+#include "lwspp/server/IServerControl.hpp" // IWYU pragma: keep
+#include "lwspp/server/ServerBuilder.hpp"
+#include "lwspp/server/contract/IServerControlAcceptor.hpp"
+#include "lwspp/server/contract/IServerLogic.hpp"
+
+// NOLINTBEGIN (readability-function-cognitive-complexity)
+namespace lwspp
+{
+namespace tests
+{
+
+using namespace fakeit;
+
+namespace
+{
+
+const srv::Port PORT = 9000;
+const cli::Address ADDRESS = "localhost";
+const cli::Path PATH = "/";
+const int DISABLE_LOG = 0;
+const std::chrono::milliseconds TIMEOUT{1000};
+// The connection set by the address and the port, and the added ones
+const size_t CONNECTIONS_COUNT = 3;
+
+const std::string HELLO_SERVER = "hello server!";
+const std::string HELLO_CLIENT = "hello client!";
+
+/**
+ * @brief The ConnectionsSession struct collects the messages received by every connection
+ */
+struct ConnectionsSession
+{
+    std::mutex mutex;
+    std::map<cli::ConnectionId, std::string> incomeMessages;
+    std::promise<void> allReceived;
+};
+
+void setupServerBehavior(Mock<srv::contract::IServerLogic>& serverLogic,
+                         Mock<srv::contract::IServerControlAcceptor>& serverControlAcceptor,
+                         srv::IServerControlPtr& serverControl)
+{
+    auto sendHelloToClient = [&](srv::ConnectionId connectionId, const srv::DataPacket&)
+    {
+        serverControl->sendTextData(connectionId, HELLO_CLIENT);
+    };
+
+    Fake(Method(serverLogic, onConnect), Method(serverLogic, onFirstDataPacket),
+         Method(serverLogic, onDisconnect));
+    When(Method(serverLogic, onTextDataReceive)).AlwaysDo(sendHelloToClient);
+
+    When(Method(serverControlAcceptor, acceptServerControl))
+        .Do([&serverControl](srv::IServerControlPtr c){ serverControl = c; });
+}
+
+void setupClientBehavior(Mock<cli::contract::IMultiClientLogic>& clientLogic,
+                         Mock<cli::contract::IClientControlAcceptor>& clientControlAcceptor,
+                         cli::IClientControlPtr& clientControl,
+                         ConnectionsSession& session)
+{
+    auto sendHelloToServer = [&](cli::ConnectionId connectionId, cli::IConnectionInfoPtr)
+    {
+        clientControl->sendTextData(connectionId, HELLO_SERVER);
+    };
+
+    auto onTextDataReceive = [&](cli::ConnectionId connectionId, const cli::DataPacket& dataPacket)
+    {
+        const std::lock_guard<std::mutex> guard(session.mutex);
+        session.incomeMessages[connectionId].assign(dataPacket.data, dataPacket.length);
+        if (session.incomeMessages.size() == CONNECTIONS_COUNT)
+        {
+            session.allReceived.set_value();
+        }
+    };
+
+    Fake(Method(clientLogic, onFirstDataPacket), Method(clientLogic, onDisconnect));
+    When(Method(clientLogic, onConnect)).AlwaysDo(sendHelloToServer);
+    When(Method(clientLogic, onTextDataReceive)).AlwaysDo(onTextDataReceive);
+
+    When(Method(clientControlAcceptor, acceptClientControl))
+        .Do([&clientControl](cli::IClientControlPtr c){ clientControl = c; });
+}
+
+srv::IServerPtr setupServer(srv::contract::IServerLogicPtr serverLogic,
+                            srv::contract::IServerControlAcceptorPtr serveControlAcceptor)
+{
+    auto serverBuilder = srv::ServerBuilder{};
+    serverBuilder
+        .setCallbackVersion(srv::CallbackVersion::v1_Andromeda)
+        .setPort(PORT)
+        .setServerLogic(serverLogic)
+        .setServerControlAcceptor(serveControlAcceptor)
+        .setLwsLogLevel(DISABLE_LOG);
+
+    return serverBuilder.build();
+}
+
+cli::IClientPtr setupClient(cli::contract::IMultiClientLogicPtr clientLogic,
+                            cli::contract::IClientControlAcceptorPtr clientControlAcceptor)
+{
+    auto clientBuilder = cli::ClientBuilder{};
+    clientBuilder
+        .setCallbackVersion(cli::CallbackVersion::v1_Amsterdam)
+        .setAddress(ADDRESS)
+        .setPort(PORT)
+        .setMultiClientLogic(clientLogic)
+        .setClientControlAcceptor(clientControlAcceptor)
+        .setLwsLogLevel(DISABLE_LOG);
+
+    for (size_t i = 1; i < CONNECTIONS_COUNT; ++i)
+    {
+        clientBuilder.addConnection(cli::Endpoint{ADDRESS, PORT, PATH});
+    }
+    return clientBuilder.build();
+}
+
+} // namespace
+
+//clazy:excludeall=non-pod-global-static
+
+SCENARIO( "Client has several connections", "[multi_connection_client]" )
+{
+    ConnectionsSession session;
+    auto waitForMessages = session.allReceived.get_future();
+
+    auto srvLogic = MockedPtr<srv::contract::IServerLogic>{};
+    auto cliLogic = MockedPtr<cli::contract::IMultiClientLogic>{};
+
+    auto srvControlAcceptor = MockedPtr<srv::contract::IServerControlAcceptor>{};
+    auto cliControlAcceptor = MockedPtr<cli::contract::IClientControlAcceptor>{};
+
+    srv::IServerControlPtr srvControl;
+    cli::IClientControlPtr cliControl;
+
+    setupServerBehavior(srvLogic.mock(), srvControlAcceptor.mock(), srvControl);
+    setupClientBehavior(cliLogic.mock(), cliControlAcceptor.mock(), cliControl, session);
+
+    GIVEN( "Server and the client connected to it several times" )
+    {
+        auto server = setupServer(srvLogic.ptr(), srvControlAcceptor.ptr());
+        auto client = setupClient(cliLogic.ptr(), cliControlAcceptor.ptr());
+
+        WHEN( "Every connection sends the message to the server, and the server replies" )
+        {
+            THEN( "Every connection receives the reply addressed by its id" )
+            {
+                REQUIRE(waitForMessages.wait_for(TIMEOUT) == std::future_status::ready);
+
+                for (cli::ConnectionId connectionId = 0; connectionId < CONNECTIONS_COUNT;
+                     ++connectionId)
+                {
+                    REQUIRE(session.incomeMessages.at(connectionId) == HELLO_CLIENT);
+                }
+
+                // The unknown connection is not connected
+                REQUIRE(cliControl->sendTextData(CONNECTIONS_COUNT, HELLO_SERVER) ==
+                        cli::SendResult::NotConnected);
+
+                client.reset();
+                server.reset();
+
+                const auto connectionsCount = static_cast<int>(CONNECTIONS_COUNT);
+                Verify(Method(cliLogic.mock(), onConnect)).Exactly(connectionsCount);
+                Verify(Method(srvLogic.mock(), onTextDataReceive)).Exactly(connectionsCount);
+            }
+        }
+    } // GIVEN
+} // SCENARIO
+
+} // namespace tests
+} // namespace lwspp
+// NOLINTEND (readability-function-cognitive-complexity)
@@ -0,0 +1,207 @@
+/*
+ * lwspp - C++ wrapper for the libwebsockets library
+ *
+ * Copyright (C) 2023 - 2023 Volodymyr Lotoshko <vlotoshko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "MockedPtr.hpp"
+
+#include "lwspp/client/ClientBuilder.hpp"
+#include "lwspp/client/IClientControl.hpp" // IWYU pragma: keep
+#include "lwspp/client/contract/IClientControlAcceptor.hpp"
+#include "lwspp/client/contract/IClientLogic.hpp"
+
+#include "lwspp/server/IServerControl.hpp" // IWYU pragma: keep
+#include "lwspp/server/ServerBuilder.hpp"
+#include "lwspp/server/contract/IServerControlAcceptor.hpp"
+#include "lwspp/server/contract/IServerLogic.hpp"
+
+// NOLINTBEGIN (readability-function-cognitive-complexity)
+namespace lwspp
+{
+namespace tests
+{
+
+using namespace fakeit;
+
+namespace
+{
+
+const srv::Port PORT = 9000;
+const cli::Address ADDRESS = "localhost";
+const int DISABLE_LOG = 0;
+const std::chrono::milliseconds TIMEOUT{100};
+
+const std::string HELLO_SERVER = "hello server!";
+const std::string MULTICAST_MESSAGE = "multicast message";
+const std::string BROADCAST_MESSAGE = "broadcast message";
+
+void setupServerBehavior(Mock<srv::contract::IServerLogic>& serverLogic,
+                         Mock<srv::contract::IServerControlAcceptor>& serverControlAcceptor,
+                         srv::IServerControlPtr& serverControl,
+                         std::vector<srv::ConnectionId>& connectionIds)
+{
+    // Once both clients greet the server, the first one gets the multicast only. Its repeated id
+    // must not deliver the message twice.
+    auto sendToClients = [&](srv::ConnectionId connectionId, const srv::DataPacket&)
+    {
+        connectionIds.push_back(connectionId);
+        if (connectionIds.size() == 2)
+        {
+            const auto firstId = connectionIds.front();
+            serverControl->sendTextData({firstId, firstId, connectionIds.back()},
+                                        MULTICAST_MESSAGE);
+            serverControl->sendTextDataExcept(firstId, BROADCAST_MESSAGE);
+        }
+    };
+
+    Fake(Method(serverLogic, onConnect), Method(serverLogic, onFirstDataPacket),
+         Method(serverLogic, onDisconnect));
+    When(Method(serverLogic, onTextDataReceive)).AlwaysDo(sendToClients);
+
+    When(Method(serverControlAcceptor, acceptServerControl))
+        .Do([&serverControl](srv::IServerControlPtr c){ serverControl = c; });
+}
+
+void setupClientBehavior(Mock<cli::contract::IClientLogic>& clientLogic,
+                         Mock<cli::contract::IClientControlAcceptor>& clientControlAcceptor,
+                         cli::IClientControlPtr& clientControl,
+                         std::vector<std::string>& incomeMessages,
+                         std::promise<void>& connected)
+{
+    auto sendHelloToServer = [&](cli::IConnectionInfoPtr)
+    {
+        clientControl->sendTextData(HELLO_SERVER);
+        connected.set_value();
+    };
+
+    auto onTextDataReceive = [&](const cli::DataPacket& dataPacket)
+    {
+        incomeMessages.emplace_back(dataPacket.data, dataPacket.length);
+    };
+
+    Fake(Method(clientLogic, onFirstDataPacket), Method(clientLogic, onDisconnect));
+    When(Method(clientLogic, onConnect)).Do(sendHelloToServer);
+    When(Method(clientLogic, onTextDataReceive)).AlwaysDo(onTextDataReceive);
+
+    When(Method(clientControlAcceptor, acceptClientControl))
+        .Do([&clientControl](cli::IClientControlPtr c){ clientControl = c; });
+}
+
+srv::IServerPtr setupServer(srv::contract::IServerLogicPtr serverLogic,
+                            srv::contract::IServerControlAcceptorPtr serveControlAcceptor)
+{
+    auto serverBuilder = srv::ServerBuilder{};
+    serverBuilder
+        .setCallbackVersion(srv::CallbackVersion::v1_Andromeda)
+        .setPort(PORT)
+        .setServerLogic(serverLogic)
+        .setServerControlAcceptor(serveControlAcceptor)
+        .setLwsLogLevel(DISABLE_LOG);
+
+    return serverBuilder.build();
+}
+
+cli::IClientPtr setupClient(cli::contract::IClientLogicPtr clientLogic,
+                            cli::contract::IClientControlAcceptorPtr clientControlAcceptor)
+{
+    auto clientBuilder = cli::ClientBuilder{};
+    clientBuilder
+        .setCallbackVersion(cli::CallbackVersion::v1_Amsterdam)
+        .setAddress(ADDRESS)
+        .setPort(PORT)
+        .setClientLogic(clientLogic)
+        .setClientControlAcceptor(clientControlAcceptor)
+        .setLwsLogLevel(DISABLE_LOG);
+
+    return clientBuilder.build();
+}
+
+} // namespace
+
+//clazy:excludeall=non-pod-global-static
+
+SCENARIO( "Server multicasts data and broadcasts data except one client", "[multicast]" )
+{
+    auto srvLogic = MockedPtr<srv::contract::IServerLogic>{};
+    auto firstCliLogic = MockedPtr<cli::contract::IClientLogic>{};
+    auto secondCliLogic = MockedPtr<cli::contract::IClientLogic>{};
+
+    auto srvControlAcceptor = MockedPtr<srv::contract::IServerControlAcceptor>{};
+    auto firstCliControlAcceptor = MockedPtr<cli::contract::IClientControlAcceptor>{};
+    auto secondCliControlAcceptor = MockedPtr<cli::contract::IClientControlAcceptor>{};
+
+    srv::IServerControlPtr srvControl;
+    cli::IClientControlPtr firstCliControl;
+    cli::IClientControlPtr secondCliControl;
+
+    std::vector<srv::ConnectionId> connectionIds;
+    std::vector<std::string> firstIncomeMessages;
+    std::vector<std::string> secondIncomeMessages;
+
+    std::promise<void> firstConnected;
+    auto waitForFirstConnect = firstConnected.get_future();
+    std::promise<void> secondConnected;
+    auto waitForSecondConnect = secondConnected.get_future();
+
+    setupServerBehavior(srvLogic.mock(), srvControlAcceptor.mock(), srvControl, connectionIds);
+    setupClientBehavior(firstCliLogic.mock(), firstCliControlAcceptor.mock(), firstCliControl,
+                        firstIncomeMessages, firstConnected);
+    setupClientBehavior(secondCliLogic.mock(), secondCliControlAcceptor.mock(), secondCliControl,
+                        secondIncomeMessages, secondConnected);
+
+    GIVEN( "Server and two clients" )
+    {
+        auto server = setupServer(srvLogic.ptr(), srvControlAcceptor.ptr());
+        // The second client connects after the first one, so the first id is known
+        auto firstClient = setupClient(firstCliLogic.ptr(), firstCliControlAcceptor.ptr());
+        REQUIRE(waitForFirstConnect.wait_for(TIMEOUT) == std::future_status::ready);
+        auto secondClient = setupClient(secondCliLogic.ptr(), secondCliControlAcceptor.ptr());
+        REQUIRE(waitForSecondConnect.wait_for(TIMEOUT) == std::future_status::ready);
+
+        WHEN( "Server multicasts data to the repeated ids and broadcasts data except the first "
+              "client" )
+        {
+            std::this_thread::sleep_for(TIMEOUT);
+            firstClient.reset();
+            secondClient.reset();
+            server.reset();
+
+            THEN( "Each client receives the multicast once and the excluded one misses "
+                  "the broadcast" )
+            {
+                CHECK(firstIncomeMessages == std::vector<std::string>{MULTICAST_MESSAGE});
+                CHECK(secondIncomeMessages ==
+                      std::vector<std::string>{MULTICAST_MESSAGE, BROADCAST_MESSAGE});
+            }
+        }
+    } // GIVEN
+} // SCENARIO
+
+} // namespace tests
+} // namespace lwspp
+// NOLINTEND (readability-function-cognitive-complexity)
@@ -0,0 +1,194 @@
+/*
+ * lwspp - C++ wrapper for the libwebsockets library
+ *
+ * Copyright (C) 2023 - 2023 Volodymyr Lotoshko <vlotoshko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <future>
+
+#include "MockedPtr.hpp"
+
+#include "lwspp/client/ClientBuilder.hpp"
+#include "lwspp/client/IClientControl.hpp" // IWYU pragma: keep
+#include "lwspp/client/contract/IClientControlAcceptor.hpp"
+#include "lwspp/client/contract/IClientLogic.hpp"
+
+#include "lwspp/server/IServerControl.hpp" // IWYU pragma: keep
+#include "lwspp/server/ServerBuilder.hpp"
+#include "lwspp/server/contract/IServerControlAcceptor.hpp"
+#include "lwspp/server/contract/IServerLogic.hpp"
+
+// NOLINTBEGIN (readability-function-cognitive-complexity)
+namespace lwspp
+{
+namespace tests
+{
+
+using namespace fakeit;
+
+namespace
+{
+
+const srv::Port PORT = 9000;
+const cli::Address ADDRESS = "localhost";
+const int DISABLE_LOG = 0;
+const std::chrono::milliseconds TIMEOUT{100};
+
+const std::string HELLO_SERVER = "hello server!";
+const srv::Topic TOPIC = "news";
+const srv::Topic OTHER_TOPIC = "weather";
+const std::string TOPIC_MESSAGE = "news message";
+const std::string OTHER_TOPIC_MESSAGE = "weather message";
+
+void setupServerBehavior(Mock<srv::contract::IServerLogic>& serverLogic,
+                         Mock<srv::contract::IServerControlAcceptor>& serverControlAcceptor,
+                         srv::IServerControlPtr& serverControl,
+                         bool& isSubscribed)
+{
+    // The client is subscribed to the one topic only, the data of the other is not delivered
+    auto subscribeAndPublish = [&](srv::ConnectionId connectionId, const srv::DataPacket&)
+    {
+        isSubscribed = serverControl->subscribe(connectionId, TOPIC);
+        serverControl->publishTextData(OTHER_TOPIC, OTHER_TOPIC_MESSAGE);
+        serverControl->publishTextData(TOPIC, TOPIC_MESSAGE);
+    };
+
+    Fake(Method(serverLogic, onConnect), Method(serverLogic, onFirstDataPacket),
+         Method(serverLogic, onDisconnect));
+    When(Method(serverLogic, onTextDataReceive)).Do(subscribeAndPublish);
+
+    When(Method(serverControlAcceptor, acceptServerControl))
+        .Do([&serverControl](srv::IServerControlPtr c){ serverControl = c; });
+}
+
+void setupClientBehavior(Mock<cli::contract::IClientLogic>& clientLogic,
+                         Mock<cli::contract::IClientControlAcceptor>& clientControlAcceptor,
+                         cli::IClientControlPtr& clientControl,
+                         std::promise<std::string>& incomeMessage)
+{
+    auto sendHelloToServer = [&clientControl](cli::IConnectionInfoPtr)
+    {
+        clientControl->sendTextData(HELLO_SERVER);
+    };
+
+    auto onTextDataReceive = [&](const cli::DataPacket& dataPacket)
+    {
+        incomeMessage.set_value(std::string{dataPacket.data, dataPacket.length});
+    };
+
+    Fake(Method(clientLogic, onFirstDataPacket), Method(clientLogic, onDisconnect));
+    When(Method(clientLogic, onConnect)).Do(sendHelloToServer);
+    When(Method(clientLogic, onTextDataReceive)).Do(onTextDataReceive);
+
+    When(Method(clientControlAcceptor, acceptClientControl))
+        .Do([&clientControl](cli::IClientControlPtr c){ clientControl = c; });
+}
+
+srv::IServerPtr setupServer(srv::contract::IServerLogicPtr serverLogic,
+                            srv::contract::IServerControlAcceptorPtr serveControlAcceptor)
+{
+    auto serverBuilder = srv::ServerBuilder{};
+    serverBuilder
+        .setCallbackVersion(srv::CallbackVersion::v1_Andromeda)
+        .setPort(PORT)
+        .setServerLogic(serverLogic)
+        .setServerControlAcceptor(serveControlAcceptor)
+        .setLwsLogLevel(DISABLE_LOG);
+
+    return serverBuilder.build();
+}
+
+cli::IClientPtr setupClient(cli::contract::IClientLogicPtr clientLogic,
+                            cli::contract::IClientControlAcceptorPtr clientControlAcceptor)
+{
+    auto clientBuilder = cli::ClientBuilder{};
+    clientBuilder
+        .setCallbackVersion(cli::CallbackVersion::v1_Amsterdam)
+        .setAddress(ADDRESS)
+        .setPort(PORT)
+        .setClientLogic(clientLogic)
+        .setClientControlAcceptor(clientControlAcceptor)
+        .setLwsLogLevel(DISABLE_LOG);
+
+    return clientBuilder.build();
+}
+
+} // namespace
+
+//clazy:excludeall=non-pod-global-static
+
+SCENARIO( "Server publishes data to the topic subscribers", "[topics]" )
+{
+    std::promise<std::string> incomeMessage;
+    auto waitForMessage = incomeMessage.get_future();
+
+    auto srvLogic = MockedPtr<srv::contract::IServerLogic>{};
+    auto cliLogic = MockedPtr<cli::contract::IClientLogic>{};
+
+    auto srvControlAcceptor = MockedPtr<srv::contract::IServerControlAcceptor>{};
+    auto cliControlAcceptor = MockedPtr<cli::contract::IClientControlAcceptor>{};
+
+    srv::IServerControlPtr srvControl;
+    cli::IClientControlPtr cliControl;
+
+    bool isSubscribed = false;
+
+    setupServerBehavior(srvLogic.mock(), srvControlAcceptor.mock(), srvControl, isSubscribed);
+    setupClientBehavior(cliLogic.mock(), cliControlAcceptor.mock(), cliControl, incomeMessage);
+
+    GIVEN( "Server and client" )
+    {
+        auto server = setupServer(srvLogic.ptr(), srvControlAcceptor.ptr());
+        auto client = setupClient(cliLogic.ptr(), cliControlAcceptor.ptr());
+
+        WHEN( "Server subscribes client to the topic and publishes data to the topics" )
+        {
+            THEN( "Client receives the data of its topic only" )
+            {
+                REQUIRE(waitForMessage.wait_for(TIMEOUT) == std::future_status::ready);
+                const auto actualClientIncomeMessage = waitForMessage.get();
+
+                server.reset();
+                client.reset();
+
+                Verify(Method(srvLogic.mock(), onConnect),
+                       Method(srvLogic.mock(), onFirstDataPacket),
+                       Method(srvLogic.mock(), onTextDataReceive),
+                       Method(srvLogic.mock(), onDisconnect)).Once();
+                Verify(Method(cliLogic.mock(), onConnect),
+                       Method(cliLogic.mock(), onFirstDataPacket),
+                       Method(cliLogic.mock(), onTextDataReceive),
+                       Method(cliLogic.mock(), onDisconnect)).Once();
+                VerifyNoOtherInvocations(srvLogic.mock());
+                VerifyNoOtherInvocations(cliLogic.mock());
+
+                CHECK(isSubscribed);
+                CHECK(actualClientIncomeMessage == TOPIC_MESSAGE);
+                CHECK_FALSE(srvControl->subscribe(srv::ConnectionId{0}, TOPIC));
+            }
+        }
+    } // GIVEN
+} // SCENARIO
+
+} // namespace tests
+} // namespace lwspp
+// NOLINTEND (readability-function-cognitive-complexity)